@@ -104,6 +104,24 @@ namespace ngbla
 				   FlatMatrix<double> s,
 				   const BitArray & used,
 				   LocalHeap & lh);
+
+  /**
+     Inverts a batch of real n x n matrices in place.
+     mats[i] points to the row-major matrix i. SIMD<double>::Size() matrices
+     are eliminated together, one per SIMD lane, by Gauss-Jordan with
+     diagonal pivots. Matrices needing pivoting are inverted by CalcInverse.
+  */
+  extern NGS_DLL_HEADER void CalcInverseBatch (size_t n, FlatArray<double*> mats);
+
+  /**
+     Solves mats[i] * x = rhs[i] for a batch of real n x n matrices with
+     m right hand sides each. rhs[i] points to the row-major n x m matrix i,
+     which is overwritten by the solution. The matrices are not changed.
+     SIMD<double>::Size() systems are factored together by LU without
+     pivoting, systems needing pivoting are solved via CalcInverse.
+  */
+  extern NGS_DLL_HEADER void SolveBatch (size_t n, size_t m, FlatArray<double*> mats,
+                                         FlatArray<double*> rhs);
 }
 
 #include "ng_lapack.hpp"
@@ -219,6 +219,165 @@ namespace ngbla
   template void CalcInverse (FlatMatrix<Mat<1,1,double> > inv, INVERSE_LIB il);
   template void CalcInverse (FlatMatrix<Mat<1,1,Complex> > inv, INVERSE_LIB il);
 #endif
+
+
+  void CalcInverseBatch (size_t n, FlatArray<double*> mats)
+  {
+    static Timer t("CalcInverseBatch"); RegionTimer reg(t);
+    t.AddFlops (double(n)*n*n*mats.Size());
+
+    constexpr int SW = SIMD<double>::Size();
+    // lanes stay in cache for small blocks only
+    if (n == 0 || n > 64 || mats.Size() < SW)
+      {
+        for (double * m : mats)
+          CalcInverse (FlatMatrix<double> (n, n, m));
+        return;
+      }
+
+    // no pivoting as long as the diagonal entry is not much smaller
+    // than the column below it
+    constexpr double tau = 1e-4;
+    
+    Array<SIMD<double>> mem(n*n);
+    auto a = [&mem,n] (size_t i, size_t j) -> SIMD<double> & { return mem[i*n+j]; };
+
+    for (size_t first = 0; first < mats.Size(); first += SW)
+      {
+        size_t next = min2(first+SW, mats.Size());
+        // unused lanes get the identity
+        for (size_t i = 0; i < n; i++)
+          for (size_t j = 0; j < n; j++)
+            a(i,j) = SIMD<double> ([&] (int l) -> double
+                                   {
+                                     if (first+l < next) return mats[first+l][i*n+j];
+                                     return (i == j) ? 1.0 : 0.0;
+                                   });
+
+        SIMD<double> bad(0.0);
+        for (size_t j = 0; j < n; j++)
+          {
+            SIMD<double> colmax(0.0);
+            for (size_t i = j+1; i < n; i++)
+              colmax = IfPos (fabs(a(i,j))-colmax, fabs(a(i,j)), colmax);
+            SIMD<double> piv = a(j,j);
+            bad += IfPos (fabs(piv)-tau*colmax, SIMD<double>(0.0), SIMD<double>(1.0));
+            
+            SIMD<double> d = 1.0 / IfPos (fabs(piv), piv, SIMD<double>(1.0));
+            a(j,j) = 1.0;
+            for (size_t k = 0; k < n; k++)
+              a(j,k) *= d;
+            for (size_t i = 0; i < n; i++)
+              if (i != j)
+                {
+                  SIMD<double> f = a(i,j);
+                  a(i,j) = 0.0;
+                  for (size_t k = 0; k < n; k++)
+                    a(i,k) -= f * a(j,k);
+                }
+          }
+        
+        for (size_t l = 0; l < next-first; l++)
+          {
+            double * m = mats[first+l];
+            if (bad[l] != 0.0)
+              CalcInverse (FlatMatrix<double> (n, n, m));
+            else
+              for (size_t i = 0; i < n*n; i++)
+                m[i] = mem[i][l];
+          }
+      }
+  }
+
+  void SolveBatch (size_t n, size_t m, FlatArray<double*> mats, FlatArray<double*> rhs)
+  {
+    static Timer t("SolveBatch"); RegionTimer reg(t);
+    t.AddFlops (double(n)*n*(n/3.0+m)*mats.Size());
+
+    // fallback for systems which need pivoting
+    auto solve_single = [n,m] (double * a, double * x)
+      {
+        Matrix<> inv = FlatMatrix<double> (n, n, a);
+        CalcInverse (inv);
+        FlatMatrix<double> fx(n, m, x);
+        Matrix<> hx = inv * fx;
+        fx = hx;
+      };
+    
+    constexpr int SW = SIMD<double>::Size();
+    if (n == 0 || n > 64 || mats.Size() < SW)
+      {
+        for (size_t i = 0; i < mats.Size(); i++)
+          solve_single (mats[i], rhs[i]);
+        return;
+      }
+
+    constexpr double tau = 1e-4;
+    
+    Array<SIMD<double>> mem(n*n), memx(n*m);
+    auto a = [&mem,n] (size_t i, size_t j) -> SIMD<double> & { return mem[i*n+j]; };
+    auto x = [&memx,m] (size_t i, size_t j) -> SIMD<double> & { return memx[i*m+j]; };
+
+    for (size_t first = 0; first < mats.Size(); first += SW)
+      {
+        size_t next = min2(first+SW, mats.Size());
+        // unused lanes get the identity and zero right hand sides
+        for (size_t i = 0; i < n; i++)
+          for (size_t j = 0; j < n; j++)
+            a(i,j) = SIMD<double> ([&] (int l) -> double
+                                   {
+                                     if (first+l < next) return mats[first+l][i*n+j];
+                                     return (i == j) ? 1.0 : 0.0;
+                                   });
+        for (size_t i = 0; i < n; i++)
+          for (size_t j = 0; j < m; j++)
+            x(i,j) = SIMD<double> ([&] (int l) -> double
+                                   { return (first+l < next) ? rhs[first+l][i*m+j] : 0.0; });
+
+        // forward elimination, L is applied to x on the fly
+        SIMD<double> bad(0.0);
+        for (size_t j = 0; j < n; j++)
+          {
+            SIMD<double> colmax(0.0);
+            for (size_t i = j+1; i < n; i++)
+              colmax = IfPos (fabs(a(i,j))-colmax, fabs(a(i,j)), colmax);
+            SIMD<double> piv = a(j,j);
+            bad += IfPos (fabs(piv)-tau*colmax, SIMD<double>(0.0), SIMD<double>(1.0));
+
+            SIMD<double> d = 1.0 / IfPos (fabs(piv), piv, SIMD<double>(1.0));
+            a(j,j) = d;
+            for (size_t i = j+1; i < n; i++)
+              {
+                SIMD<double> f = a(i,j) * d;
+                for (size_t k = j+1; k < n; k++)
+                  a(i,k) -= f * a(j,k);
+                for (size_t k = 0; k < m; k++)
+                  x(i,k) -= f * x(j,k);
+              }
+          }
+
+        // back substitution, the diagonal holds the inverse pivots
+        for (size_t j = n; j-- > 0; )
+          for (size_t k = 0; k < m; k++)
+            {
+              SIMD<double> sum = x(j,k);
+              for (size_t i = j+1; i < n; i++)
+                sum -= a(j,i) * x(i,k);
+              x(j,k) = sum * a(j,j);
+            }
+        
+        for (size_t l = 0; l < next-first; l++)
+          {
+            double * hx = rhs[first+l];
+            if (bad[l] != 0.0)
+              solve_single (mats[first+l], hx);
+            else
+              for (size_t i = 0; i < n*m; i++)
+                hx[i] = memx[i][l];
+          }
+      }
+  }
+
 #if MAX_SYS_DIM >= 2
   template void CalcInverse (FlatMatrix<Mat<2,2,double> > inv, INVERSE_LIB il);
   template void CalcInverse (FlatMatrix<Mat<2,2,Complex> > inv, INVERSE_LIB il);
@@ -63,6 +63,8 @@
     }
 
     
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     virtual void MultAdd (double val, const BaseVector & x, BaseVector & y) const override
     {
       // cout << "applymassl2const::MultAdd" << endl;
@@ -177,6 +179,8 @@
       return make_shared<ApplyMassVectorL2Const> (fes, rho, true, definedon, lh, std::move(inv_diag_mass), std::move(inv_elscale));
     }
     
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     virtual void MultAdd (double val, const BaseVector & x, BaseVector & y) const override
     {
       // cout << "applymassl2const::MultAdd" << endl;
@@ -105,6 +105,8 @@ namespace ngcomp
     checksum = flags.GetDefineFlag ("checksum");
     spd = flags.GetDefineFlag ("spd");
     geom_free = flags.GetDefineFlag("geom_free");    
+    batch_assembly = flags.GetDefineFlag ("batch_assembly");
+    atomic_assembly = flags.GetDefineFlag ("atomic_assembly") || batch_assembly;
     if (spd) symmetric = true;
     SetCheckUnused (!flags.GetDefineFlagX("check_unused").IsFalse());
   }
@@ -159,6 +161,8 @@ namespace ngcomp
     
     precompute = flags.GetDefineFlag ("precompute");
     checksum = flags.GetDefineFlag ("checksum");
+    batch_assembly = flags.GetDefineFlag ("batch_assembly");
+    atomic_assembly = flags.GetDefineFlag ("atomic_assembly") || batch_assembly;
     SetCheckUnused (!flags.GetDefineFlagX("check_unused").IsFalse());    
   }
 
@@ -549,6 +553,64 @@ namespace ngcomp
 
 
 
+
+  /*
+    Graph cache: stiffness, mass, damping ... forms on the same spaces
+    share one immutable graph, the matrices allocate only their values.
+    Entries hold weak pointers, a graph lives as long as some matrix uses it.
+  */
+  namespace
+  {
+    struct GraphCacheEntry
+    {
+      weak_ptr<FESpace> fes, fes2;
+      // GetGraph is virtual, and the graph of a mixed form is built differently
+      const type_info * type;
+      bool mixed, symmetric, eliminate_internal, eliminate_hidden;
+      size_t ts, ts2, mesh_ts, ndof, ndof2;
+      weak_ptr<MatrixGraph> graph;
+    };
+    
+    mutex graph_cache_mutex;
+    Array<GraphCacheEntry> graph_cache;
+  }
+  
+  shared_ptr<MatrixGraph> BilinearForm :: GetSharedGraph (int level, bool symmetric)
+  {
+    auto fes2 = GetTestSpace();
+    GraphCacheEntry key { fespace, fes2, &typeid(*this), MixedSpaces(),
+        symmetric, eliminate_internal, eliminate_hidden,
+        fespace->GetTimeStamp(), fes2->GetTimeStamp(), ma->GetTimeStamp(),
+        fespace->GetNDof(), fes2->GetNDof(), weak_ptr<MatrixGraph>() };
+
+    {
+      lock_guard<mutex> guard(graph_cache_mutex);
+      for (int i = graph_cache.Size()-1; i >= 0; i--)
+        {
+          auto & e = graph_cache[i];
+          if (e.graph.expired() || e.fes.expired() || e.fes2.expired())
+            {
+              graph_cache.DeleteElement(i);
+              continue;
+            }
+          if (e.fes.lock() == fespace && e.fes2.lock() == fes2 &&
+              *e.type == *key.type && e.mixed == key.mixed && e.symmetric == symmetric &&
+              e.eliminate_internal == eliminate_internal && e.eliminate_hidden == eliminate_hidden &&
+              e.ts == key.ts && e.ts2 == key.ts2 && e.mesh_ts == key.mesh_ts &&
+              e.ndof == key.ndof && e.ndof2 == key.ndof2)
+            if (auto graph = e.graph.lock())
+              return graph;
+        }
+    }
+
+    shared_ptr<MatrixGraph> graph(GetGraph (level, symmetric));
+    key.graph = graph;
+    lock_guard<mutex> guard(graph_cache_mutex);
+    graph_cache.Append (key);
+    return graph;
+  }
+
+
   void BilinearForm :: Assemble (LocalHeap & lh)
   {
     if (mats.Size() == ma->GetNLevels())
@@ -926,6 +988,303 @@ namespace ngcomp
 
 
 
+  template <class SCAL>
+  bool S_BilinearForm<SCAL> :: UseElementBatches (VorB vb) const
+  {
+    if (!batch_assembly || !is_same<SCAL,double>::value) return false;
+    // condensation of the linear form and storing the inner matrices stay per element
+    if (vb != VOL || eliminate_hidden || fespace->VarOrder() ||
+        (eliminate_internal && (store_inner || (linearform && !keep_internal))) ||
+        preconditioners.Size() || printelmat || elmat_ev)
+      return false;
+    for (auto & bfi : VB_parts[vb])
+      if (!bfi->SupportsElementBatch() || bfi->GetDeformation() || bfi->GetDefinedOnElements())
+        return false;
+    return true;
+  }
+
+  
+  template <class SCAL>
+  void S_BilinearForm<SCAL> :: AssembleElementBatches (VorB vb, Array<bool> & useddof,
+                                                       LocalHeap & clh)
+  {
+    static Timer t("Assemble element batches");
+    static Timer tclass("Assemble element batches - classify");
+    RegionTimer reg(t);
+
+    if constexpr (!is_same<SCAL,double>::value)
+      throw Exception ("element batches only for real matrices");
+    else
+      {
+        // simplices with the same vertex ordering and element index share
+        // their finite element, the batch needs only different geometry
+        size_t ne = ma->GetNE(vb);
+        Array<int> classnr(ne);
+        tclass.Start();
+        ParallelFor (ne, [&] (size_t i)
+          {
+            ElementId ei(vb, i);
+            Ngs_Element ngel = ma->GetElement(ei);
+            if (!fespace->DefinedOn(ei))
+              classnr[i] = -2;
+            else if (ngel.GetType() == ET_SEGM || ngel.GetType() == ET_TRIG || ngel.GetType() == ET_TET)
+              {
+                int cl = SwitchET<ET_SEGM,ET_TRIG,ET_TET>
+                  (ngel.GetType(),
+                   [&ngel] (auto et) { return ET_trait<et.ElementType()>::GetClassNr(ngel.Vertices()); });
+                classnr[i] = (ngel.GetIndex() * 3 + Dim(ngel.GetType())-1) * 32 + cl;
+              }
+            else
+              classnr[i] = -1;
+          });
+
+        TableCreator<size_t> creator;
+        for ( ; !creator.Done(); creator++)
+          for (auto i : Range(classnr))
+            if (classnr[i] >= 0)
+              creator.Add (classnr[i], i);
+        Table<size_t> table = creator.MoveTable();
+
+        Array<size_t> singles;
+        for (auto i : Range(classnr))
+          if (classnr[i] == -1)
+            singles.Append (i);
+
+        constexpr size_t batchsize = 4*SIMD<double>::Size();
+        Array<FlatArray<size_t>> batches;
+        for (auto row : table)
+          for (size_t first = 0; first < row.Size(); first += batchsize)
+            batches.Append (row.Range(first, min2(first+batchsize, row.Size())));
+        for (size_t i : Range(singles))
+          batches.Append (singles.Range(i, i+1));
+        tclass.Stop();
+
+        ProgressOutput progress(ma, string("assemble ") + ToString(vb) + string(" element"), ne);
+
+        // static condensation of a batch: the inner blocks of elements with
+        // the same local inner and outer dofs are factored together
+        auto condense_batch = [&] (FlatArray<size_t> els, FlatArray<FlatArray<DofId>> eldnums,
+                                   FlatArray<FlatMatrix<double>> elmats, LocalHeap & lh)
+          {
+            int dim = fespace->GetDimension();
+            size_t nd = eldnums[0].Size();
+
+            // per local dof: 0 inner, 1 outer, 2 unused
+            FlatArray<int> pattern(els.Size()*nd, lh);
+            for (size_t k : Range(els))
+              for (size_t i : Range(nd))
+                {
+                  auto ct = fespace->GetDofCouplingType(eldnums[k][i]);
+                  pattern[k*nd+i] = (ct & CONDENSABLE_DOF) ? 0 : ((ct != UNUSED_DOF) ? 1 : 2);
+                }
+            auto same_pattern = [&] (size_t k1, size_t k2)
+              {
+                for (size_t i : Range(nd))
+                  if (pattern[k1*nd+i] != pattern[k2*nd+i]) return false;
+                return true;
+              };
+
+            FlatArray<bool> done(els.Size(), lh);
+            done = false;
+            for (size_t k0 : Range(els))
+              {
+                if (done[k0]) continue;
+                HeapReset hr(lh);
+
+                Array<size_t> group(els.Size(), lh);
+                group.SetSize0();
+                for (size_t k = k0; k < els.Size(); k++)
+                  if (!done[k] && same_pattern(k, k0))
+                    {
+                      group.AppendHaveMem(k);
+                      done[k] = true;
+                    }
+
+                Array<int> idofs(dim*nd, lh), odofs(dim*nd, lh);
+                idofs.SetSize0();
+                odofs.SetSize0();
+                for (size_t i : Range(nd))
+                  for (size_t jj : Range(dim))
+                    if (pattern[k0*nd+i] == 0)
+                      idofs.AppendHaveMem(dim*i+jj);
+                    else if (pattern[k0*nd+i] == 1)
+                      odofs.AppendHaveMem(dim*i+jj);
+                size_t sizei = idofs.Size(), sizeo = odofs.Size();
+                if (sizei == 0) continue;
+
+                // d and c^T of the group, as separate matrices for the batch kernels
+                FlatArray<double*> dmats(group.Size(), lh), ctmats(group.Size(), lh);
+                for (size_t g : Range(group))
+                  {
+                    auto & elmat = elmats[group[g]];
+                    dmats[g] = lh.Alloc<double> (sizei*sizei);
+                    ctmats[g] = lh.Alloc<double> (sizei*sizeo);
+                    FlatMatrix<double> (sizei, sizei, dmats[g]) = elmat.Rows(idofs).Cols(idofs);
+                    FlatMatrix<double> (sizei, sizeo, ctmats[g]) = elmat.Rows(idofs).Cols(odofs);
+                  }
+
+                if (keep_internal)
+                  CalcInverseBatch (sizei, dmats);                // d <--- d^-1
+                else
+                  SolveBatch (sizei, sizeo, dmats, ctmats);       // c^T <--- d^-1 c^T
+
+                for (size_t g : Range(group))
+                  {
+                    HeapReset hr(lh);
+                    size_t k = group[g];
+                    ElementId ei(vb, els[k]);
+                    auto & elmat = elmats[k];
+                    FlatMatrix<double> d(sizei, sizei, dmats[g]), ct(sizei, sizeo, ctmats[g]);
+                    FlatMatrix<double>
+                      a = elmat.Rows(odofs).Cols(odofs) | lh,
+                      b = elmat.Rows(odofs).Cols(idofs) | lh;
+
+                    if (keep_internal)
+                      {
+                        Array<int> idnums(sizei, lh), ednums(sizeo, lh);
+                        idnums.SetSize0();
+                        ednums.SetSize0();
+                        for (size_t i : Range(nd))
+                          {
+                            DofId dof = eldnums[k][i];
+                            if (pattern[k*nd+i] == 0)
+                              {
+                                if (fespace->GetDofCouplingType(dof) == HIDDEN_DOF)
+                                  for (size_t jj = 0; jj < dim; jj++)
+                                    idnums.AppendHaveMem(NO_DOF_NR_CONDENSE);
+                                else
+                                  idnums += dim*IntRange(dof, dof+1);
+                              }
+                            else if (pattern[k*nd+i] == 1)
+                              ednums += dim*IntRange(dof, dof+1);
+                          }
+
+                        FlatMatrix<double> he (sizei, sizeo, lh);
+                        he = -d * ct;
+                        harmonicext ->AddElementMatrix(ei.Nr(),idnums,ednums,he);
+                        if (!symmetric)
+                          {
+                            FlatMatrix<double> het (sizeo, sizei, lh);
+                            het = -b * d;
+                            static_cast<ElementByElementMatrix<double>*>(harmonicexttrans.get())
+                              ->AddElementMatrix(ei.Nr(),ednums,idnums,het);
+                          }
+                        innersolve ->AddElementMatrix(ei.Nr(),idnums,idnums,d);
+                        a += b * he;
+
+                        if (spd)
+                          {
+                            FlatMatrix<double> schur(sizeo, lh);
+                            CalcSchur (elmat, schur, odofs, idofs);
+                            a = schur;
+                          }
+                      }
+                    else
+                      a -= b * ct;
+
+                    elmat.Rows(odofs).Cols(odofs) = a;
+                    for (size_t i : Range(nd))
+                      if (pattern[k*nd+i] == 0)
+                        eldnums[k][i] = NO_DOF_NR;
+                  }
+              }
+          };
+
+        auto assemble_batch = [&] (FlatArray<size_t> els, Array<DofId> & dnums, LocalHeap & lh)
+          {
+            HeapReset hr(lh);
+            ElementId ei0(vb, els[0]);
+            const FiniteElement & fel = fespace->GetFE (ei0, lh);
+            size_t elmat_size = fel.GetNDof()*fespace->GetDimension();
+
+            FlatArray<const ElementTransformation*> trafos(els.Size(), lh);
+            FlatArray<FlatMatrix<double>> elmats(els.Size(), lh);
+            for (size_t k : Range(els))
+              {
+                trafos[k] = &ma->GetTrafo (ElementId(vb, els[k]), lh);
+                elmats[k].AssignMemory (elmat_size, elmat_size, lh);
+                elmats[k] = 0.0;
+              }
+
+            bool elem_has_integrator = false;
+            for (auto & bfi : VB_parts[vb])
+              if (bfi->DefinedOn (ma->GetElIndex (ei0)))
+                {
+                  elem_has_integrator = true;
+                  // a single element would use only one SIMD lane of the batch kernel
+                  if (els.Size() == 1)
+                    bfi->CalcElementMatrixAdd (fel, *trafos[0], elmats[0], lh);
+                  else
+                    bfi->CalcElementMatrixBatchAdd (fel, trafos, elmats, lh);
+                }
+            
+            for (size_t k : Range(els))
+              progress.Update();
+            if (!elem_has_integrator) return;
+
+            FlatArray<FlatArray<DofId>> eldnums(els.Size(), lh);
+            for (size_t k : Range(els))
+              {
+                ElementId ei(vb, els[k]);
+                fespace->GetDofNrs (ei, dnums);
+                eldnums[k].Assign (dnums.Size(), lh);
+                eldnums[k] = dnums;
+                fespace->TransformMat (ei, elmats[k], TRANSFORM_MAT_LEFT_RIGHT);
+              }
+
+            if (eliminate_internal)
+              condense_batch (els, eldnums, elmats, lh);
+            
+            for (size_t k : Range(els))
+              {
+                ElementId ei(vb, els[k]);
+                AddElementMatrix (eldnums[k], eldnums[k], elmats[k], ei, lh);
+                
+                // batches run concurrently: relaxed atomic store, no ordering needed
+                if (check_unused)
+                  for (auto d : eldnums[k])
+                    if (IsRegularDof(d)) AsAtomic(useddof[d]).store(true, memory_order_relaxed);
+              }
+          };
+        
+        SharedLoop2 sl(batches.Size());
+        ParallelJob
+          ( [&] (const TaskInfo & ti)
+            {
+              LocalHeap lh = clh.Split(ti.thread_nr, ti.nthreads);
+              Array<DofId> dnums;
+              
+              for (size_t b : sl)
+                {
+                  HeapReset hr(lh);
+                  FlatArray<size_t> batch = batches[b];
+
+                  // all elements of a batch need the same number of dofs,
+                  // others are computed separately
+                  size_t ndof0 = fespace->GetFE (ElementId(vb, batch[0]), lh).GetNDof();
+                  Array<size_t> same(batch.Size(), lh), other(batch.Size(), lh);
+                  same.SetSize0();
+                  other.SetSize0();
+                  for (size_t i : batch)
+                    {
+                      fespace->GetDofNrs (ElementId(vb, i), dnums);
+                      if (dnums.Size() == ndof0)
+                        same.AppendHaveMem (i);
+                      else
+                        other.AppendHaveMem (i);
+                    }
+                  
+                  assemble_batch (same, dnums, lh);
+                  for (size_t i : Range(other))
+                    assemble_batch (other.Range(i, i+1), dnums, lh);
+                }
+              ProgressOutput::SumUpLocal();
+            });
+        progress.Done();
+      }
+  }
+
+  
   template <class SCAL>
   void S_BilinearForm<SCAL> :: DoAssemble (LocalHeap & clh)
   {
@@ -1099,6 +1458,8 @@ namespace ngcomp
                       }
                     cout << IM(3) << "\rassemble element " << ne << "/" << ne << endl;
                   }
+                else if (UseElementBatches (vb))
+                  AssembleElementBatches (vb, useddof, clh);
                 else // not diagonal
                   {
                     ProgressOutput progress(ma,string("assemble ") + ToString(vb) + string(" element"), ma->GetNE(vb));
@@ -1115,6 +1476,9 @@ namespace ngcomp
                           innermatrix = make_shared<ElementByElementMatrix<SCAL>>(ndof, ne);
                       }
                     */
+                    // atomic adds replace coloring only if nothing else is shared between elements
+                    bool colored = !atomic_assembly || preconditioners.Size() ||
+                      (linearform && !keep_internal) || printelmat || elmat_ev;
                     IterateElements
                       (*fespace, vb, clh,  [&] (FESpace::Element el, LocalHeap & lh)
                        {
@@ -1570,11 +1934,12 @@ namespace ngcomp
                            {
                              if (printelmat)
                                *testout << "set these as useddof: " << dnums << endl;
+                             // without coloring, concurrent elements share dofs
                              for (auto d : dnums)
-                               if (IsRegularDof(d)) useddof[d] = true;
+                               if (IsRegularDof(d)) AsAtomic(useddof[d]).store(true, memory_order_relaxed);
                            }
                          // timer3_VB[vb].Stop();
-                       });
+                       }, colored);
                     progress.Done();
                     
                     /*
@@ -4308,14 +4673,21 @@ namespace ngcomp
     if (transpose) Swap (fesx, fesy);
     auto ma = GetMeshAccess();
     
+    // quads and hexes get separate class numbers, since they may
+    // be mixed with trigs and tets
     Array<short> classnr(ma->GetNE());
     ma->IterateElements
       (VOL, lh, [&] (auto el, LocalHeap & llh)
        {
          classnr[el.Nr()] = 
-           SwitchET<ET_TRIG,ET_TET>
+           SwitchET<ET_TRIG,ET_QUAD,ET_TET,ET_HEX>
            (el.GetType(),
-            [el] (auto et) { return ET_trait<et.ElementType()>::GetClassNr(el.Vertices()); });
+            [el] (auto et)
+            {
+              constexpr ELEMENT_TYPE ET = et.ElementType();
+              int offset = (ET == ET_QUAD || ET == ET_HEX) ? 32 : 0;
+              return offset + ET_trait<ET>::GetClassNr(el.Vertices());
+            });
        });
     
     TableCreator<size_t> creator;
@@ -4340,6 +4712,12 @@ namespace ngcomp
         Matrix<> mely(elclass_inds.Size(), fely.GetNDof()*fesy->GetDimension());
         mely = 0.0;
 
+        // quads and hexes are evaluated element by element, which uses
+        // sum-factorization for tensor-product elements (e.g. H1 with 'tp').
+        // Hexes are not classified by vertex ordering, so their shape
+        // matrices are not shared anyhow.
+        bool elementwise = felx.ElementType() == ET_QUAD || felx.ElementType() == ET_HEX;
+
         {
           RegionTimer reg(tgetx);
           ParallelForRange
@@ -4397,6 +4775,23 @@ namespace ngcomp
                   for (auto proxynr : Range(trial_proxies))
                     {
                       auto proxy = trial_proxies[proxynr];
+                      Matrix<SIMD<double>> hmelxi(elclass_inds.Size(), proxy->Dimension()*simd_ir.Size());
+                      if (elementwise)
+                        {
+                          ParallelForRange (elclass_inds.Size(), [&] (IntRange myrange) {
+                              LocalHeap llh = lh.Split();
+                              for (auto i : myrange)
+                                {
+                                  HeapReset hr(llh);
+                                  auto & feli = fesx->GetFE (ElementId(VOL, elclass_inds[i]), llh);
+                                  FlatMatrix<SIMD<double>> valsi(proxy->Dimension(), simd_ir.Size(), &hmelxi(i,0));
+                                  proxy->Evaluator()->Apply(feli, simd_mir, melx.Row(i), valsi);
+                                }
+                            });
+                          melxi.Append (std::move(hmelxi));
+                          continue;
+                        }
+                      
                       FlatMatrix<SIMD<double>> bmatx(melx.Width()*proxy->Dimension(),
                                                      simd_ir.Size(), lh);
                       FlatMatrix<double> hbmatx(melx.Width(),
@@ -4405,7 +4800,6 @@ namespace ngcomp
 
                       bmatx = SIMD<double> (0.0);
                       proxy->Evaluator()->CalcMatrix(felx, simd_mir, bmatx);
-                      Matrix<SIMD<double>> hmelxi(elclass_inds.Size(), proxy->Dimension()*simd_ir.Size());
                       FlatMatrix<> hhmelxi(hmelxi.Height(), hmelxi.Width()*SIMD<double>::Size(), &hmelxi(0)[0]);
                       ParallelForRange (elclass_inds.Size(), [&] (IntRange myrange) {
                           hhmelxi.Rows(myrange) = melx.Rows(myrange) * hbmatx;
@@ -4429,6 +4823,30 @@ namespace ngcomp
                       auto fes = gfcf->GetGridFunction().GetFESpace();
                       auto & felgf = fes->GetFE(ei, lh);
                       auto diffop = gfcf->GetDifferentialOperator(trafo.VB());
+                      auto & vec = gfcf->GetGridFunction().GetVector();
+
+                      if (elementwise)
+                        {
+                          Matrix<SIMD<double>> hmgfxi(elclass_inds.Size(), diffop->Dim()*simd_ir.Size());
+                          ParallelForRange
+                            (elclass_inds.Size(), [&] (IntRange myrange) {
+                              LocalHeap llh = lh.Split();
+                              Array<DofId> dofnr;
+                              for (auto i : myrange)
+                                {
+                                  HeapReset hr(llh);
+                                  ElementId eli(VOL, elclass_inds[i]);
+                                  auto & feli = fes->GetFE(eli, llh);
+                                  fes->GetDofNrs(eli, dofnr);
+                                  FlatVector<> elvec(dofnr.Size()*fes->GetDimension(), llh);
+                                  vec.GetIndirect(dofnr, elvec);
+                                  FlatMatrix<SIMD<double>> valsi(diffop->Dim(), simd_ir.Size(), &hmgfxi(i,0));
+                                  diffop->Apply(feli, simd_mir, elvec, valsi);
+                                }
+                            });
+                          mgfxi.Append (move(hmgfxi));
+                          continue;
+                        }
                       
                       FlatMatrix<SIMD<double>> bmat(felgf.GetNDof()*fes->GetDimension()*
                                                     diffop->Dim(), // ??? right Dim
@@ -4443,7 +4861,6 @@ namespace ngcomp
                       Matrix<> mgf(elclass_inds.Size(), felgf.GetNDof()*fes->GetDimension());
                       Matrix<SIMD<double>> hmgfxi(elclass_inds.Size(), diffop->Dim()*simd_ir.Size());
                       FlatMatrix<> hhmgfxi(hmgfxi.Height(), hmgfxi.Width()*SIMD<double>::Size(), &hmgfxi(0)[0]);                      
-                      auto & vec = gfcf->GetGridFunction().GetVector();
                       
                       ParallelForRange
                         (elclass_inds.Size(), [&] (IntRange myrange) {
@@ -4531,6 +4948,24 @@ namespace ngcomp
                   for (auto proxynr : Range(test_proxies))
                     {
                       auto proxy = test_proxies[proxynr];
+                      if (elementwise)
+                        {
+                          ParallelForRange (elclass_inds.Size(), [&] (IntRange myrange) {
+                              LocalHeap llh = lh.Split();
+                              for (auto i : myrange)
+                                {
+                                  HeapReset hr(llh);
+                                  auto & feli = fesy->GetFE (ElementId(VOL, elclass_inds[i]), llh);
+                                  FlatMatrix<SIMD<double>> valsi(proxy->Dimension(), simd_ir.Size(), &melyi[proxynr](i,0));
+                                  for (size_t k = 0; k < valsi.Height(); k++)
+                                    for (size_t j = 0; j < valsi.Width(); j++)
+                                      valsi(k,j) *= simd_mir[j].GetWeight();
+                                  proxy->Evaluator()->AddTrans(feli, simd_mir, valsi, mely.Row(i));
+                                }
+                            });
+                          continue;
+                        }
+                      
                       FlatMatrix<SIMD<double>> bmaty(mely.Width()*proxy->Dimension(),
                                                      simd_ir.Size(), lh);
                       FlatMatrix<double> hbmaty(mely.Width(),
@@ -4940,9 +5375,9 @@ namespace ngcomp
     if (this->mats.Size() == this->ma->GetNLevels())
       return;
 
-    MatrixGraph * graph = this->GetGraph (this->ma->GetNLevels()-1, false);
+    auto graph = this->GetSharedGraph (this->ma->GetNLevels()-1, false);
 
-    auto spmat = make_shared<SparseMatrix<TM,TV,TV>> (*graph, 1);
+    auto spmat = make_shared<SparseMatrix<TM,TV,TV>> (graph);
     mymatrix = spmat.get();
     
     if (this->spd) spmat->SetSPD();
@@ -4954,8 +5389,6 @@ namespace ngcomp
     
     this->mats.Append (mat);
 
-    delete graph;
-
     if (!this->multilevel || this->low_order_bilinear_form)
       for (int i = 0; i < this->mats.Size()-1; i++)
         this->mats[i].reset();
@@ -5041,7 +5474,7 @@ namespace ngcomp
                     ElementId id,
                     LocalHeap & lh) 
   {
-    mymatrix -> TMATRIX::AddElementMatrix (dnums1, dnums2, elmat, this->fespace->HasAtomicDofs());
+    mymatrix -> TMATRIX::AddElementMatrix (dnums1, dnums2, elmat, this->fespace->HasAtomicDofs() || this->atomic_assembly);
   }
 
 
@@ -5087,9 +5520,9 @@ namespace ngcomp
     if (this->mats.Size() == this->ma->GetNLevels())
       return;
 
-    MatrixGraph * graph = this->GetGraph (this->ma->GetNLevels()-1, true);
+    auto graph = this->GetSharedGraph (this->ma->GetNLevels()-1, true);
 
-    auto spmat = make_shared<SparseMatrixSymmetric<TM,TV>> (*graph, 1);
+    auto spmat = make_shared<SparseMatrixSymmetric<TM,TV>> (graph);
     mymatrix = spmat.get();
     
     if (this->spd) spmat->SetSPD();
@@ -5101,8 +5534,6 @@ namespace ngcomp
     
     this->mats.Append (mat);
 
-    delete graph;
-
     if (!this->multilevel || this->low_order_bilinear_form)
       for (int i = 0; i < this->mats.Size()-1; i++)
         this->mats[i].reset();
@@ -5165,7 +5596,7 @@ namespace ngcomp
                     ElementId id, 
                     LocalHeap & lh) 
   {
-    mymatrix -> TMATRIX::AddElementMatrixSymmetric (dnums1, elmat, this->fespace->HasAtomicDofs());
+    mymatrix -> TMATRIX::AddElementMatrixSymmetric (dnums1, elmat, this->fespace->HasAtomicDofs() || this->atomic_assembly);
   }
 
 
@@ -5289,6 +5720,7 @@ namespace ngcomp
                     LocalHeap & lh) 
   {
     TMATRIX & mat = dynamic_cast<TMATRIX&> (*this->mats.Last());
+    bool use_atomic = this->fespace->HasAtomicDofs() || this->atomic_assembly;
 
     for (int i = 0; i < dnums1.Size(); i++)
       if (IsRegularDof(dnums1[i]))
@@ -5299,7 +5731,10 @@ namespace ngcomp
           
           for (int k = 0; k < hi; k++)
             for (int l = 0; l < wi; l++)
-              mij(k,l) += elmat(i*hi+k, i*wi+l);
+              if (use_atomic)
+                MyAtomicAdd (mij(k,l), elmat(i*hi+k, i*wi+l));
+              else
+                mij(k,l) += elmat(i*hi+k, i*wi+l);
         }
   }
 
@@ -5314,10 +5749,16 @@ namespace ngcomp
                     LocalHeap & lh) 
   {
     TMATRIX & mat = dynamic_cast<TMATRIX&> (GetMatrix());
+    bool use_atomic = this->fespace->HasAtomicDofs() || this->atomic_assembly;
 
     for (int i = 0; i < dnums1.Size(); i++)
       if (IsRegularDof(dnums1[i]))
-        mat(dnums1[i], dnums1[i]) += elmat(i, i);
+        {
+          if (use_atomic)
+            MyAtomicAdd (mat(dnums1[i], dnums1[i]), elmat(i, i));
+          else
+            mat(dnums1[i], dnums1[i]) += elmat(i, i);
+        }
   }
 
 
@@ -5332,10 +5773,16 @@ namespace ngcomp
                     LocalHeap & lh) 
   {
     TMATRIX & mat = dynamic_cast<TMATRIX&> (GetMatrix()); 
+    bool use_atomic = this->fespace->HasAtomicDofs() || this->atomic_assembly;
 
     for (int i = 0; i < dnums1.Size(); i++)
       if (IsRegularDof(dnums1[i]))
-        mat(dnums1[i], dnums1[i]) += elmat(i, i);
+        {
+          if (use_atomic)
+            MyAtomicAdd (mat(dnums1[i], dnums1[i]), elmat(i, i));
+          else
+            mat(dnums1[i], dnums1[i]) += elmat(i, i);
+        }
   }
 
 
@@ -50,6 +50,10 @@ namespace ngcomp
     double unuseddiag;
     /// check if all dofs declared used are used in assemble
     bool check_unused = true;
+    /// add element matrices by atomic operations instead of element coloring
+    bool atomic_assembly = false;
+    /// compute element matrices for batches of elements (implies atomic_assembly)
+    bool batch_assembly = false;
     /// low order bilinear-form, 0 if not used
     shared_ptr<BilinearForm> low_order_bilinear_form;
 
@@ -190,6 +194,9 @@ namespace ngcomp
     /// generates matrix graph
     virtual MatrixGraph * GetGraph (int level, bool symmetric);
 
+    /// matrix graph from a cache shared by all bilinear-forms on the same spaces
+    shared_ptr<MatrixGraph> GetSharedGraph (int level, bool symmetric);
+
     /// assembles the matrix
     void Assemble (LocalHeap & lh);
 
@@ -541,6 +548,10 @@ namespace ngcomp
 
     ///
     virtual void DoAssemble (LocalHeap & lh);
+    /// can element matrices be computed in batches of elements ?
+    bool UseElementBatches (VorB vb) const;
+    /// assemble element matrices computed in batches of elements
+    void AssembleElementBatches (VorB vb, Array<bool> & useddof, LocalHeap & clh);
     ///
     // virtual void DoAssembleIndependent (BitArray & useddof, LocalHeap & lh);
     ///
@@ -919,6 +930,8 @@ namespace ngcomp
       return bf->GetFESpace()->IsComplex();
     }
     
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     ///
     virtual void Mult (const BaseVector & v, BaseVector & prod) const override;
     ///
@@ -961,6 +974,8 @@ namespace ngcomp
 				       const BaseVector * aveclin,
                                        LocalHeap & alh);
 
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     ///
     virtual void Mult (const BaseVector & v, BaseVector & prod) const override;
     ///
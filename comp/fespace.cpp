@@ -1533,9 +1533,41 @@ lot of new non-zero entries in the matrix!\n" << endl;
   void IterateElements (const FESpace & fes, 
 			VorB vb, 
 			LocalHeap & clh, 
-			const function<void(FESpace::Element,LocalHeap&)> & func)
+			const function<void(FESpace::Element,LocalHeap&)> & func,
+                        bool colored)
   {
     static mutex copyex_mutex;
+
+    if (task_manager && !colored)
+      {
+        static Timer t("IterateElements - uncolored");
+        RegionTimer reg(t);
+
+        // one job for all elements, no coloring needed
+        auto ma = fes.GetMeshAccess();
+        SharedLoop2 sl(Range(ma->GetNE(vb)));
+
+        task_manager -> CreateJob
+          ( [&] (const TaskInfo & ti) 
+            {
+              LocalHeap lh = clh.Split(ti.thread_nr, ti.nthreads);
+              ArrayMem<int,100> temp_dnums;
+              
+              for (size_t mynr : sl)
+                {
+                  ElementId ei(vb, mynr);
+                  if (!fes.DefinedOn (ei)) continue;
+
+                  HeapReset hr(lh);
+                  FESpace::Element el(fes, ei, temp_dnums, lh);
+                  func (move(el), lh);
+                }
+              
+              ProgressOutput::SumUpLocal();
+            } );
+        return;
+      }
+
     const Table<int> & element_coloring = fes.ElementColoring(vb);
     
     if (task_manager)
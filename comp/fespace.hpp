@@ -853,10 +853,18 @@ ANY                  1 1 1 1 | 15
 
 
 
+  /**
+     Calls func for all elements of the space in parallel.
+     Elements of the same color share no dofs, colors are processed
+     one after the other. If colored is false, all elements are processed
+     in one parallel loop without barriers, func has to add its
+     contributions to shared data by atomic operations.
+   */
   extern NGS_DLL_HEADER void IterateElements (const FESpace & fes,
 			       VorB vb, 
 			       LocalHeap & clh, 
-			       const function<void(FESpace::Element,LocalHeap&)> & func);
+			       const function<void(FESpace::Element,LocalHeap&)> & func,
+                               bool colored = true);
   /*
   template <typename TFUNC>
   inline void IterateElements (const FESpace & fes, 
@@ -1234,6 +1242,8 @@ ANY                  1 1 1 1 | 15
       return fes->IsComplex();
     }
     
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     virtual void Mult (const BaseVector & v, BaseVector & prod) const override;
     virtual void MultAdd (double val, const BaseVector & v, BaseVector & prod) const override;
     virtual void MultAdd (Complex val, const BaseVector & v, BaseVector & prod) const override;
@@ -1274,6 +1284,8 @@ ANY                  1 1 1 1 | 15
     virtual int VWidth() const override { return fes->GetNDof(); }
     virtual bool IsComplex() const override { return fes->IsComplex(); }
     
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     virtual void Mult (const BaseVector & v, BaseVector & prod) const override;
     virtual void MultAdd (double val, const BaseVector & v, BaseVector & prod) const override;
     virtual void MultAdd (Complex val, const BaseVector & v, BaseVector & prod) const override;
@@ -3,136 +3,17 @@ using namespace ngcomp;
 
 
 
-#include "../linalg/concurrentqueue.h"
-typedef moodycamel::ConcurrentQueue<size_t> TQueue; 
-typedef moodycamel::ProducerToken TPToken; 
-typedef moodycamel::ConsumerToken TCToken; 
-
-
-
 namespace ngcomp
 {
 
-  static TQueue queue;
-
-  template <typename TFUNC>
-  void RunParallelDependency (FlatTable<int> dag,
-                              TFUNC func)
-  {
-    Array<atomic<int>> cnt_dep(dag.Size());
-
-    for (auto & d : cnt_dep) 
-      d.store (0, memory_order_relaxed);
-
-    static Timer t_cntdep("count dep");
-    t_cntdep.Start();
-    ParallelFor (Range(dag),
-                 [&] (int i)
-                 {
-                   for (int j : dag[i])
-                     cnt_dep[j]++;
-                 });
-    t_cntdep.Stop();    
-
-    atomic<size_t> num_ready(0), num_final(0);
-    ParallelForRange (cnt_dep.Size(), [&] (IntRange r)
-                      {
-                        size_t my_ready = 0, my_final = 0;
-                        for (size_t i : r)
-                          {
-                            if (cnt_dep[i] == 0) my_ready++;
-                            if (dag[i].Size() == 0) my_final++;
-                          }
-                        num_ready += my_ready;
-                        num_final += my_final;
-                      });
-
-    Array<int> ready(num_ready);
-    ready.SetSize0();
-    for (int j : Range(cnt_dep))
-      if (cnt_dep[j] == 0) ready.Append(j);
-
-    
-    if (!task_manager)
-      // if (true)
-      {
-        while (ready.Size())
-          {
-            int size = ready.Size();
-            int nr = ready[size-1];
-            ready.SetSize(size-1);
-            
-            func(nr);
-            
-            for (int j : dag[nr])
-              {
-                cnt_dep[j]--;
-                if (cnt_dep[j] == 0)
-                  ready.Append(j);
-              }
-          }
-        return;
-      }
-
-    atomic<int> cnt_final(0);
-    SharedLoop2 sl(Range(ready));
-
-    task_manager -> CreateJob 
-      ([&] (const TaskInfo & ti)
-       {
-         size_t my_final = 0;
-         TPToken ptoken(queue); 
-         TCToken ctoken(queue); 
-        
-         for (int i : sl)
-           queue.enqueue (ptoken, ready[i]);
-
-         while (1)
-           {
-             if (cnt_final >= num_final) break;
-
-             int nr;
-             if(!queue.try_dequeue_from_producer(ptoken, nr)) 
-               if(!queue.try_dequeue(ctoken, nr))
-                 {
-                   if (my_final)
-                     {
-                       cnt_final += my_final;
-                       my_final = 0;
-                     }
-                   continue;
-                 }
-
-             if (dag[nr].Size() == 0)
-               my_final++;
-             // cnt_final++;
-
-             func(nr);
-
-             for (int j : dag[nr])
-               {
-                 if (--cnt_dep[j] == 0)
-                   queue.enqueue (ptoken, j);
-               }
-           }
-       });
-  }
-
-
-
-
-
-
-
-
-  
-
   template <class SCAL>
   class H1AMG_Matrix : public BaseMatrix
   {
     size_t size;
     shared_ptr<SparseMatrixTM<SCAL>> mat;
     shared_ptr<BaseBlockJacobiPrecond> smoother;
+    /// used instead of the block Gauss-Seidel smoother if set
+    shared_ptr<ChebyshevJacobi> cheb_smoother;
     shared_ptr<SparseMatrixTM<double>> prolongation, restriction;
     shared_ptr<BaseMatrix> coarse_precond;
     int smoothing_steps = 1;
@@ -143,7 +24,7 @@ namespace ngcomp
                   FlatArray<INT<2>> e2v,
                   FlatArray<double> edge_weights,
                   FlatArray<double> vertex_weights,
-                  size_t level)
+                  size_t level, bool chebyshev = false)
       : mat(amat)
     {
       static Timer t("H1AMG"); RegionTimer reg(t);
@@ -235,18 +116,18 @@ namespace ngcomp
                      }, TasksPerThread(5));
       Table<int> edge_dag = edge_dag_creator.MoveTable();
     
-      RunParallelDependency (edge_dag,
-                             [&] (int edgenr)
-                             {
-                               auto v0 = e2v[edgenr][0];
-                               auto v1 = e2v[edgenr][1];
-                               if (edge_collapse_weights[edgenr] >= 0.01 && !vertex_collapse[v0] && !vertex_collapse[v1] && (*freedofs)[v0] && (*freedofs)[v1])
-                                 {
-                                   edge_collapse[edgenr] = true;
-                                   vertex_collapse[v0] = true;
-                                   vertex_collapse[v1] = true;
-                                 }
-                             });
+      TaskDAG (edge_dag).Run
+        ([&] (int edgenr)
+         {
+           auto v0 = e2v[edgenr][0];
+           auto v1 = e2v[edgenr][1];
+           if (edge_collapse_weights[edgenr] >= 0.01 && !vertex_collapse[v0] && !vertex_collapse[v1] && (*freedofs)[v0] && (*freedofs)[v1])
+             {
+               edge_collapse[edgenr] = true;
+               vertex_collapse[v0] = true;
+               vertex_collapse[v1] = true;
+             }
+         });
       edge_dag = Table<int>();
       
       // collapse the larger vertex
@@ -372,16 +253,21 @@ namespace ngcomp
       
 
       // build smoother
-      TableCreator<int> smoothing_blocks_creator(num_coarse_vertices);
-      for ( ; !smoothing_blocks_creator.Done(); smoothing_blocks_creator++)
-        ParallelFor (v2cv.Size(), [&] (size_t v)
-                     {
-                       if (v2cv[v] != -1 && (*freedofs)[v])
-                         smoothing_blocks_creator.Add (v2cv[v], v);
-                     });
-
-      auto blocks = make_shared<Table<int>> (smoothing_blocks_creator.MoveTable());
-      smoother = mat->CreateBlockJacobiPrecond(blocks);
+      if (chebyshev)
+        cheb_smoother = make_shared<ChebyshevJacobi> (mat, freedofs);
+      else
+        {
+          TableCreator<int> smoothing_blocks_creator(num_coarse_vertices);
+          for ( ; !smoothing_blocks_creator.Done(); smoothing_blocks_creator++)
+            ParallelFor (v2cv.Size(), [&] (size_t v)
+                         {
+                           if (v2cv[v] != -1 && (*freedofs)[v])
+                             smoothing_blocks_creator.Add (v2cv[v], v);
+                         });
+          
+          auto blocks = make_shared<Table<int>> (smoothing_blocks_creator.MoveTable());
+          smoother = mat->CreateBlockJacobiPrecond(blocks);
+        }
 
       // build prolongation
       Array<int> nne(num_vertices);
@@ -443,7 +329,8 @@ namespace ngcomp
 	}
       else
         coarse_precond = make_shared<H1AMG_Matrix> (dynamic_pointer_cast<SparseMatrixTM<SCAL>> (coarsemat), coarse_freedofs,
-                                                    coarse_e2v, coarse_edge_weights, coarse_vertex_weights, level+1);
+                                                    coarse_e2v, coarse_edge_weights, coarse_vertex_weights, level+1,
+                                                    chebyshev);
 
 
       restriction = TransposeMatrix (*prolongation);
@@ -462,7 +349,10 @@ namespace ngcomp
       static Timer t("H1AMG::Mult"); RegionTimer reg(t);      
       x = 0;
 
-      smoother->GSSmooth(x, b, smoothing_steps);
+      if (cheb_smoother)
+        cheb_smoother->Smooth (x, b, smoothing_steps);
+      else
+        smoother->GSSmooth(x, b, smoothing_steps);
       auto residuum = b.CreateVector();
       residuum = b - (*mat) * x;
 
@@ -473,7 +363,10 @@ namespace ngcomp
       coarse_precond->Mult(coarse_residuum, coarse_x);
     
       x += *prolongation * coarse_x;
-      smoother->GSSmoothBack (x, b, smoothing_steps);
+      if (cheb_smoother)
+        cheb_smoother->SmoothBack (x, b, smoothing_steps);
+      else
+        smoother->GSSmoothBack (x, b, smoothing_steps);
     }
   };
 
@@ -533,7 +426,10 @@ namespace ngcomp
          });
       vertex_weights_ht = ParallelHashTable<INT<1>,double>();
       
-      mat = make_shared<H1AMG_Matrix<double>> (smat, freedofs, e2v, edge_weights, vertex_weights, 0);
+      // "block" (Gauss-Seidel on collapsed vertices) or "chebyshev"
+      bool chebyshev = flags.GetStringFlag ("smoother", "block") == "chebyshev";
+      mat = make_shared<H1AMG_Matrix<double>> (smat, freedofs, e2v, edge_weights, vertex_weights, 0,
+                                               chebyshev);
     }
 
 
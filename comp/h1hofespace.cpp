@@ -12,6 +12,7 @@
 #include <multigrid.hpp> 
 #include "../fem/h1hofe.hpp"
 #include "../fem/h1hofefo.hpp"
+#include "../fem/h1hofetp.hpp"
 #include <../fem/hdivhofe.hpp>
 #include <../fem/facethofe.hpp>  
 
@@ -150,6 +151,7 @@ namespace ngcomp
     //  DefineNumListFlag("dom_order_max_z");
     DefineNumFlag("smoothing");
     DefineDefineFlag("wb_withedges");
+    DefineDefineFlag("tp");
     if (parseflags) CheckFlags(flags);
 
     wb_loedge = ma->GetDimension() == 3;
@@ -195,6 +197,8 @@ namespace ngcomp
     highest_order_dc = flags.GetDefineFlag ("highest_order_dc");
     if (highest_order_dc && order < 2)
       throw Exception ("highest_order_dc needs order >= 2");
+
+    tensorproduct = flags.GetDefineFlag ("tp");
     
     Flags loflags;
     loflags.SetFlag ("order", 1);
@@ -305,6 +309,8 @@ into the wirebasket.
       "  use lowest-order edge dofs for BDDC wirebasket";
     docu.Arg("wb_fulledges") = "bool = false\n"
       "  use all edge dofs for BDDC wirebasket";
+    docu.Arg("tp") = "bool = false\n"
+      "  use sum-factorization on quads and hexes for tensor-product integration rules";
     return docu;
   }
 
@@ -823,7 +829,16 @@ into the wirebasket.
                  constexpr ELEMENT_TYPE ET = et.ElementType();
                  
                  Ngs_Element ngel = ma->GetElement<ET_trait<ET>::DIM,VOL> (elnr);
-                 H1HighOrderFE<ET> * hofe =  new (alloc) H1HighOrderFE<ET> ();
+                 H1HighOrderFE<ET> * hofe;
+                 if constexpr (ET == ET_QUAD || ET == ET_HEX)
+                   {
+                     if (tensorproduct)
+                       hofe = new (alloc) H1HighOrderFETP<ET> ();
+                     else
+                       hofe = new (alloc) H1HighOrderFE<ET> ();
+                   }
+                 else
+                   hofe = new (alloc) H1HighOrderFE<ET> ();
                  
                  hofe -> SetVertexNumbers (ngel.Vertices());
                  
@@ -49,6 +49,8 @@ namespace ngcomp
     bool level_adapted_order; 
     bool nodalp2;
     bool highest_order_dc;
+    /// sum-factorization for quads and hexes
+    bool tensorproduct = false;
   public:
 
     H1HighOrderFESpace (shared_ptr<MeshAccess> ama, const Flags & flags, bool checkflags=false);
@@ -46,6 +46,7 @@ public:
 	
   virtual void FinalizeLevel (const ngla::BaseMatrix * mat = NULL);
   virtual void Update();
+  using BaseMatrix::Mult;
   virtual void Mult (const BaseVector & f, BaseVector & u) const;
   virtual int VHeight() const { return pardofs->GetNDofLocal();}
   virtual int VWidth() const { return pardofs->GetNDofLocal();}
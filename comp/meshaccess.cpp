@@ -205,6 +205,47 @@ namespace ngcomp
       SIMD_MappedIntegrationRule<DIMS,DIMR> & mir = 
 	static_cast<SIMD_MappedIntegrationRule<DIMS,DIMR> &> (bmir);
       
+      // point, Jacobian, det, and normal+tangential vectors on lower dim elements
+      constexpr int ncomp = DIMR + DIMR*DIMS + 1 + (DIMS < DIMR ? 2*DIMR : 0);
+      GeometryCache::Entry cache;
+      if (auto gc = mesh->GetGeometryCache())
+        {
+          cache = gc->Get (GetElementId(), ir, ncomp);
+          if (cache.Ready())
+            {
+              size_t nip = ir.Size();
+              for (size_t i = 0; i < nip; i++)
+                {
+                  auto & mip = mir[i];
+                  int c = 0;
+                  for (int j = 0; j < DIMR; j++)
+                    mip.Point()(j) = cache(c++, nip, i);
+                  for (int j = 0; j < DIMR; j++)
+                    for (int k = 0; k < DIMS; k++)
+                      mip.Jacobian()(j,k) = cache(c++, nip, i);
+                  SIMD<double> det = cache(c++, nip, i);
+                  mip.SetJacobiDet (det);
+                  mip.SetMeasure (fabs(det));
+                  if (DIMS < DIMR)
+                    {
+                      Vec<DIMR,SIMD<double>> nv, tv;
+                      for (int j = 0; j < DIMR; j++)
+                        nv(j) = cache(c++, nip, i);
+                      for (int j = 0; j < DIMR; j++)
+                        tv(j) = cache(c++, nip, i);
+                      mip.SetNV (nv);
+                      mip.SetTV (tv);
+                    }
+                  else
+                    {
+                      mip.SetNV (SIMD<double>(0.0));
+                      mip.SetTV (SIMD<double>(0.0));
+                    }
+                }
+              return;
+            }
+        }
+
       mesh->mesh.MultiElementTransformation <DIMS,DIMR>
         (elnr, ir.Size(),
          &ir[0](0).Data(), ir.Size()>1 ? &ir[1](0)-&ir[0](0) : 0,
@@ -213,6 +254,30 @@ namespace ngcomp
       
       for (int i = 0; i < ir.Size(); i++)
         mir[i].Compute();
+
+      if (cache.Valid())
+        {
+          size_t nip = ir.Size();
+          for (size_t i = 0; i < nip; i++)
+            {
+              auto & mip = mir[i];
+              int c = 0;
+              for (int j = 0; j < DIMR; j++)
+                cache(c++, nip, i) = mip.GetPoint()(j);
+              for (int j = 0; j < DIMR; j++)
+                for (int k = 0; k < DIMS; k++)
+                  cache(c++, nip, i) = mip.GetJacobian()(j,k);
+              cache(c++, nip, i) = mip.GetJacobiDet();
+              if (DIMS < DIMR)
+                {
+                  for (int j = 0; j < DIMR; j++)
+                    cache(c++, nip, i) = mip.GetNV()(j);
+                  for (int j = 0; j < DIMR; j++)
+                    cache(c++, nip, i) = mip.GetTV()(j);
+                }
+            }
+          cache.Publish();
+        }
     }
 
     virtual const ElementTransformation & VAddDeformation (const GridFunction * gf, LocalHeap & lh) const override
@@ -908,6 +973,9 @@ namespace ngcomp
     nnodes[NT_ELEMENT] = nnodes[StdNodeType (NT_ELEMENT, dim)];
     nnodes[NT_FACET] = nnodes[StdNodeType (NT_FACET, dim)];
 
+    if (geometry_cache)
+      geometry_cache = make_shared<GeometryCache> (*this);
+
     int & ndomains = nregions[0];    
     ndomains = -1;
     // int ne = GetNE();
@@ -1404,6 +1472,131 @@ namespace ngcomp
             throw Exception ("Mesh::SetDeformation needs a GridFunction with dim="+ToString(dim));
         }
       deformation = def;
+      if (geometry_cache)
+        geometry_cache = make_shared<GeometryCache> (*this);
+    }
+
+    void MeshAccess :: EnableGeometryCache (bool enable)
+    {
+      if (enable)
+        geometry_cache = make_shared<GeometryCache> (*this);
+      else
+        geometry_cache = nullptr;
+    }
+
+
+    GeometryCache :: GeometryCache (const MeshAccess & ma)
+    {
+      for (VorB vb : { VOL, BND, BBND, BBBND })
+        ne[vb] = ma.GetNE(vb);
+    }
+
+    // FNV-1a over points and weights, rules on the LocalHeap are
+    // recreated for every element, so the address is no key
+    static uint64_t HashRule (const SIMD_IntegrationRule & ir)
+    {
+      uint64_t hash = 14695981039346656037ull;
+      auto add = [&hash] (SIMD<double> val)
+        {
+          for (size_t k = 0; k < SIMD<double>::Size(); k++)
+            {
+              uint64_t bits;
+              double v = val[k];
+              memcpy (&bits, &v, sizeof(bits));
+              hash = (hash ^ bits) * 1099511628211ull;
+            }
+        };
+      for (size_t i = 0; i < ir.Size(); i++)
+        {
+          for (int j = 0; j < 3; j++)
+            add (ir[i](j));
+          add (ir[i].Weight());
+        }
+      return hash;
+    }
+
+    auto GeometryCache :: FindRule (ElementId ei, const SIMD_IntegrationRule & ir, int ncomp)
+      -> RuleData *
+    {
+      uint64_t hash = HashRule (ir);
+      auto same_rule = [&] (const RuleData & rd)
+        {
+          if (rd.hash != hash || rd.vb != ei.VB() || rd.ncomp != ncomp
+              || rd.points.Size() != ir.Size())
+            return false;
+          // exclude hash collisions
+          for (size_t i = 0; i < ir.Size(); i++)
+            {
+              if (memcmp (&rd.points[i](0), &ir[i](0), 3*sizeof(SIMD<double>)) != 0)
+                return false;
+              SIMD<double> w1 = rd.points[i].Weight(), w2 = ir[i].Weight();
+              if (memcmp (&w1, &w2, sizeof(SIMD<double>)) != 0)
+                return false;
+            }
+          return true;
+        };
+
+      int n = nrules.load(memory_order_acquire);
+      for (int i = 0; i < n; i++)
+        if (same_rule(*rules[i])) return rules[i].get();
+
+      lock_guard<mutex> guard(newrule_mutex);
+      n = nrules.load(memory_order_relaxed);
+      for (int i = 0; i < n; i++)
+        if (same_rule(*rules[i])) return rules[i].get();
+      if (n == maxrules) return nullptr;
+
+      auto rd = make_unique<RuleData>();
+      rd->hash = hash;
+      rd->points.SetSize(ir.Size());
+      for (size_t i = 0; i < ir.Size(); i++)
+        rd->points[i] = ir[i];
+      rd->vb = ei.VB();
+      rd->ncomp = ncomp;
+      rd->data.SetSize(ne[ei.VB()] * ncomp * ir.Size());
+      rd->state = make_unique<atomic<char>[]> (ne[ei.VB()]);
+      for (size_t i = 0; i < ne[ei.VB()]; i++)
+        rd->state[i].store(0, memory_order_relaxed);
+      rules[n] = move(rd);
+      nrules.store(n+1, memory_order_release);
+      return rules[n].get();
+    }
+
+    GeometryCache::Entry GeometryCache :: Get (ElementId ei, const SIMD_IntegrationRule & ir, int ncomp)
+    {
+      Entry entry;
+      if (ir.Size() == 0 || ei.Nr() >= ne[ei.VB()]) return entry;
+      RuleData * rd = FindRule (ei, ir, ncomp);
+      if (!rd) return entry;
+
+      atomic<char> & state = rd->state[ei.Nr()];
+      char st = state.load(memory_order_acquire);
+      if (st == 1) return entry;
+      if (st == 0)
+        {
+          if (!state.compare_exchange_strong (st, 1, memory_order_acquire))
+            {
+              if (st != 2) return entry;
+              entry.ready = true;
+            }
+        }
+      else
+        entry.ready = true;
+
+      entry.data = &rd->data[size_t(ei.Nr()) * ncomp * ir.Size()];
+      entry.state = &state;
+      return entry;
+    }
+
+    size_t GeometryCache :: MemoryUsage () const
+    {
+      size_t mem = 0;
+      int n = nrules.load(memory_order_acquire);
+      for (int i = 0; i < n; i++)
+        mem += rules[i]->data.Size() * sizeof(SIMD<double>)
+          + rules[i]->points.Size() * sizeof(SIMD<IntegrationPoint>)
+          + ne[rules[i]->vb] * sizeof(atomic<char>);
+      return mem;
     }
   
     void MeshAccess :: SetPML (const shared_ptr<PML_Transformation> & pml_trafo, int _domnr)
@@ -1413,6 +1606,8 @@ namespace ngcomp
       if (pml_trafo->GetDimension()!=dim)
         throw Exception("MeshAccess::SetPML: dimension of PML = "+ToString(pml_trafo->GetDimension())+" does not fit mesh dimension!");
       pml_trafos[_domnr] = pml_trafo; 
+      if (geometry_cache)
+        geometry_cache = make_shared<GeometryCache> (*this);
     }
     
     void MeshAccess :: UnSetPML (int _domnr)
@@ -1420,6 +1615,8 @@ namespace ngcomp
       if (_domnr>=nregions[VOL])
         throw Exception("MeshAccess::UnSetPML: was not able to unset PML, domain index too high!");
       pml_trafos[_domnr] = nullptr; 
+      if (geometry_cache)
+        geometry_cache = make_shared<GeometryCache> (*this);
     }
     Array<shared_ptr<PML_Transformation>> & MeshAccess :: GetPMLTrafos()
     { return pml_trafos; }
@@ -1906,6 +2103,8 @@ namespace ngcomp
   void MeshAccess :: Curve (int order)
   {
     mesh.Curve(order);
+    if (geometry_cache)
+      geometry_cache = make_shared<GeometryCache> (*this);
   } 
   
   int MeshAccess :: GetNPairsPeriodicVertices () const 
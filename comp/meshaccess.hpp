@@ -177,6 +177,66 @@ namespace ngcomp
   };
   */
 
+  /**
+     Cache of the geometry of curved elements.
+
+     For every element and SIMD integration rule the mapped points,
+     Jacobians, determinants and normal/tangential vectors are stored
+     in one block, component after component (SoA), such that repeated
+     operator applications just read them instead of calling back into
+     Netgen. Blocks are filled lazily by the first thread visiting the
+     element. The cache is owned by MeshAccess, and replaced by an empty
+     one when the geometry changes (refinement, curving, deformation).
+   */
+  class NGS_DLL_HEADER GeometryCache
+  {
+    struct RuleData
+    {
+      uint64_t hash;                         // of points and weights
+      Array<SIMD<IntegrationPoint>> points;  // identifies the rule
+      VorB vb;
+      int ncomp;
+      Array<SIMD<double>> data;              // ne * ncomp * nip
+      unique_ptr<atomic<char>[]> state;      // 0 empty, 1 filling, 2 ready
+    };
+
+    size_t ne[4];
+    static constexpr int maxrules = 64;
+    unique_ptr<RuleData> rules[maxrules];
+    atomic<int> nrules{0};
+    mutex newrule_mutex;
+
+  public:
+    GeometryCache (const MeshAccess & ma);
+
+    class Entry
+    {
+      SIMD<double> * data = nullptr;
+      atomic<char> * state = nullptr;
+      bool ready = false;
+      friend class GeometryCache;
+    public:
+      /// the rule can be cached
+      bool Valid() const { return data != nullptr; }
+      /// data is available, otherwise the caller fills it and calls Publish
+      bool Ready() const { return ready; }
+      /// component c of point i
+      SIMD<double> & operator() (int c, size_t nip, size_t i) const { return data[c*nip+i]; }
+      void Publish () const { state->store(2, memory_order_release); }
+    };
+
+    /// get the block of element ei for the rule. Only one thread obtains
+    /// a not-ready entry for filling, the others get an invalid one
+    Entry Get (ElementId ei, const SIMD_IntegrationRule & ir, int ncomp);
+
+    /// memory in bytes
+    size_t MemoryUsage () const;
+
+  private:
+    RuleData * FindRule (ElementId ei, const SIMD_IntegrationRule & ir, int ncomp);
+  };
+
+
   /** 
       Access to mesh topology and geometry.
 
@@ -232,6 +292,9 @@ namespace ngcomp
     /// for ALE
     shared_ptr<GridFunction> deformation;  
 
+    /// cached geometry of curved elements, nullptr if disabled
+    shared_ptr<GeometryCache> geometry_cache;
+
     /// pml trafos per sub-domain
     Array<shared_ptr <PML_Transformation>> pml_trafos;
     
@@ -657,6 +720,13 @@ namespace ngcomp
       return deformation;
     }
 
+    /// store the geometry of curved elements at SIMD integration rules
+    void EnableGeometryCache (bool enable = true);
+    shared_ptr<GeometryCache> GetGeometryCache () const { return geometry_cache; }
+    /// memory of the geometry cache in bytes
+    size_t GeometryCacheMemory () const
+    { return geometry_cache ? geometry_cache->MemoryUsage() : 0; }
+
     void SetPML (const shared_ptr<PML_Transformation> & pml_trafo, int _domnr);
     void UnSetPML (int _domnr);
 
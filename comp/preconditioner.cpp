@@ -257,12 +257,16 @@ namespace ngcomp
 
     if (smoothertype == "point")
       {
-	sm = make_shared<GSSmoother> (*ma, *lo_bfa);
+	sm = make_shared<GSSmoother> (*ma, *lo_bfa, flags);
       }
     else if (smoothertype == "line")
       {
 	sm = make_shared<AnisotropicSmoother> (*ma, *lo_bfa);
       }
+    else if (smoothertype == "chebyshev")
+      {
+	sm = make_shared<ChebyshevSmoother> (*ma, *lo_bfa, flags);
+      }
     else if (smoothertype == "block") 
       {
 	if (!lfconstraint)
@@ -354,12 +358,16 @@ namespace ngcomp
 
     if (smoothertype == "point")
       {
-	sm = make_shared<GSSmoother> (*ma, *lo_bfa);
+	sm = make_shared<GSSmoother> (*ma, *lo_bfa, flags);
       }
     else if (smoothertype == "line")
       {
 	sm = make_shared<AnisotropicSmoother> (*ma, *lo_bfa);
       }
+    else if (smoothertype == "chebyshev")
+      {
+	sm = make_shared<ChebyshevSmoother> (*ma, *lo_bfa, flags);
+      }
     else if (smoothertype == "block") 
       {
 	// if (!lfconstraint)
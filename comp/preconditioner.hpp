@@ -67,6 +67,7 @@ namespace ngcomp
 
     virtual bool IsComplex() const override { return GetMatrix().IsComplex(); }
         
+    using BaseMatrix::Mult;
     ///
     virtual void Mult (const BaseVector & x, BaseVector & y) const override
     {
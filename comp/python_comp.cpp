@@ -1429,15 +1429,17 @@ parallel : bool
             
             py::gil_scoped_release release;
 
+            LocalHeap * alh = GetAsyncLocalHeap();
+            LocalHeap & lh = alh ? *alh : glh;
             if(tpspace)
             {
-              Transfer2TPMesh(cf.get(),self.get(),glh);
+              Transfer2TPMesh(cf.get(),self.get(),lh);
               return;
             }            
             if (reg)
-              SetValues (cf, *self, *reg, NULL, glh);
+              SetValues (cf, *self, *reg, NULL, lh);
             else
-              SetValues (cf, *self, vb, NULL, glh);
+              SetValues (cf, *self, vb, NULL, lh);
          },
           py::arg("coefficient"),
           py::arg("VOL_or_BND")=VOL,
@@ -1798,7 +1800,16 @@ space : ngsolve.FESpace
 		     py::arg("nonsym_storage") = "bool = False\n"
 		     " The full matrix is stored, even if the symmetric flag is set.",
                      py::arg("check_unused") = "bool = True\n"
-		     " If set prints warnings if not UNUSED_DOFS are not used."
+		     " If set prints warnings if not UNUSED_DOFS are not used.",
+                     py::arg("atomic_assembly") = "bool = False\n"
+                     "  Assemble without element coloring. Element matrices are added\n"
+                     "  to the global matrix by atomic operations, so all threads work\n"
+                     "  on a single element loop without synchronization between colors.",
+                     py::arg("batch_assembly") = "bool = False\n"
+                     "  Compute element matrices of simplicial elements in batches, SIMD lanes\n"
+                     "  run over elements instead of integration points (pays off for low order).\n"
+                     "  Only for real valued symbolic integrators, implies atomic_assembly.\n"
+                     "  With condense=True the inner blocks of a batch are factored together."
                      );
                 })
 
@@ -1887,7 +1898,9 @@ integrator : ngsolve.fem.BFI
     
     .def("Assemble", [](BF & self, bool reallocate)
          {
-           self.ReAssemble(glh,reallocate);
+           // asynchronous jobs have their own heap, glh is shared
+           LocalHeap * alh = GetAsyncLocalHeap();
+           self.ReAssemble(alh ? *alh : glh, reallocate);
          }, py::call_guard<py::gil_scoped_release>(),
          py::arg("reallocate")=false, docu_string(R"raw_string(
 Assemble the bilinear form.
@@ -2128,7 +2141,10 @@ integrator : ngsolve.fem.LFI
                            { return MakePyTuple (self->Integrators()); }, "returns tuple of integrators of the linear form")
 
     .def("Assemble", [](shared_ptr<LF> self)
-         { self->Assemble(glh); }, py::call_guard<py::gil_scoped_release>(), "Assemble linear form")
+         {
+           LocalHeap * alh = GetAsyncLocalHeap();
+           self->Assemble(alh ? *alh : glh);
+         }, py::call_guard<py::gil_scoped_release>(), "Assemble linear form")
     
     .def_property_readonly("components", [](shared_ptr<LF> self)
                    { 
@@ -3261,7 +3277,8 @@ deformation : ngsolve.comp.GridFunction
 
    py::class_<BaseVTKOutput, shared_ptr<BaseVTKOutput>>(m, "VTKOutput")
     .def(py::init([] (shared_ptr<MeshAccess> ma, py::list coefs_list,
-                      py::list names_list, string filename, int subdivision, int only_element)
+                      py::list names_list, string filename, int subdivision, int only_element,
+                      string format, bool background)
          -> shared_ptr<BaseVTKOutput>
          {
            Array<shared_ptr<CoefficientFunction> > coefs
@@ -3270,9 +3287,9 @@ deformation : ngsolve.comp.GridFunction
              = makeCArray<string> (names_list);
            shared_ptr<BaseVTKOutput> ret;
            if (ma->GetDimension() == 2)
-             ret = make_shared<VTKOutput<2>> (ma, coefs, names, filename, subdivision, only_element);
+             ret = make_shared<VTKOutput<2>> (ma, coefs, names, filename, subdivision, only_element, format, background);
            else
-             ret = make_shared<VTKOutput<3>> (ma, coefs, names, filename, subdivision, only_element);
+             ret = make_shared<VTKOutput<3>> (ma, coefs, names, filename, subdivision, only_element, format, background);
            return ret;
          }),
          py::arg("ma"),
@@ -3280,20 +3297,32 @@ deformation : ngsolve.comp.GridFunction
          py::arg("names") = py::list(),
          py::arg("filename") = "vtkout",
          py::arg("subdivision") = 0,
-         py::arg("only_element") = -1
+         py::arg("only_element") = -1,
+         py::arg("format") = "vtk",
+         py::arg("background") = false,
+         docu_string(R"raw_string(
+format : string
+  'vtk': legacy ASCII file, 'vtu': binary XML file, together with a
+  'filename.pvd' index of all outputs for time series
+
+background : bool
+  write vtu files on a background thread, overlapping with the
+  following computations
+)raw_string")
          )
-     .def("Do", [](shared_ptr<BaseVTKOutput> self, VorB vb)
+     .def("Do", [](shared_ptr<BaseVTKOutput> self, VorB vb, double time)
           { 
-            self->Do(glh,vb);
+            self->Do(glh,vb,nullptr,time);
           },
-          py::arg("vb")=VOL,
+          py::arg("vb")=VOL, py::arg("time")=-1,
           py::call_guard<py::gil_scoped_release>())
-     .def("Do", [](shared_ptr<BaseVTKOutput> self, VorB vb, const BitArray * drawelems)
+     .def("Do", [](shared_ptr<BaseVTKOutput> self, VorB vb, const BitArray * drawelems, double time)
           { 
-            self->Do(glh, vb, drawelems);
+            self->Do(glh, vb, drawelems, time);
           },
           py::arg("vb")=VOL,
           py::arg("drawelems"),
+          py::arg("time")=-1,
           py::call_guard<py::gil_scoped_release>())
      ;
 
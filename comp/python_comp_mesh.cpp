@@ -457,6 +457,15 @@ mesh (netgen.Mesh): a mesh generated from Netgen
 
     .def("UnsetDeformation", [](MeshAccess & ma){ ma.SetDeformation(nullptr);}, "Unset the deformation")
 
+    .def("EnableGeometryCache", &MeshAccess::EnableGeometryCache,
+         py::arg("enable")=true,
+         docu_string("Store mapped points and Jacobians of curved elements at SIMD integration rules,\n"
+                     "repeated operator applications then don't recompute the geometry.\n"
+                     "The cache is cleared when the mesh is refined, curved or deformed."))
+
+    .def_property_readonly("geometrycachememory", &MeshAccess::GeometryCacheMemory,
+                           "Memory used by the geometry cache in bytes")
+
     .def("SetPML", 
 	 [](MeshAccess & ma,  shared_ptr<PML> apml, py::object definedon)
           {
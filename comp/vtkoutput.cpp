@@ -19,7 +19,9 @@ namespace ngcomp
                 flags.GetStringListFlag ("fieldnames" ),
                 flags.GetStringFlag ("filename","output"),
                 (int) flags.GetNumFlag ( "subdivision", 0),
-                (int) flags.GetNumFlag ( "only_element", -1))
+                (int) flags.GetNumFlag ( "only_element", -1),
+                flags.GetStringFlag ("format","vtk"),
+                flags.GetDefineFlag ("background"))
   {;}
 
 
@@ -27,10 +29,14 @@ namespace ngcomp
   VTKOutput<D>::VTKOutput (shared_ptr<MeshAccess> ama,
                            const Array<shared_ptr<CoefficientFunction>> & a_coefs,
                            const Array<string> & a_field_names,
-                           string a_filename, int a_subdivision, int a_only_element)
+                           string a_filename, int a_subdivision, int a_only_element,
+                           string a_format, bool a_background)
     : ma(ama), coefs(a_coefs), fieldnames(a_field_names),
-      filename(a_filename), subdivision(a_subdivision), only_element(a_only_element)
+      filename(a_filename), subdivision(a_subdivision), only_element(a_only_element),
+      format(a_format), background(a_background)
   {
+    if (format != "vtk" && format != "vtu")
+      throw Exception ("VTKOutput: unknown format '"+format+"', use 'vtk' or 'vtu'");
     value_field.SetSize(a_coefs.Size());
     for (int i = 0; i < a_coefs.Size(); i++)
       if (fieldnames.Size() > i)
@@ -39,6 +45,13 @@ namespace ngcomp
         value_field[i] = make_shared<ValueField>(coefs[i]->Dimension(),"dummy" + to_string(i));
   }
 
+  template <int D> 
+  VTKOutput<D>::~VTKOutput()
+  {
+    if (writer.valid())
+      writer.wait();
+  }
+
 
   /// Empty all field 
   template <int D> 
@@ -46,6 +59,8 @@ namespace ngcomp
   {
     points.SetSize(0);
     cells.SetSize(0);
+    celltypes.SetSize(0);
+    geometry_valid = false;
     for (auto field : value_field)
       field->SetSize(0);
   }
@@ -409,136 +424,288 @@ namespace ngcomp
   }
     
 
+  /// points, cells and field values of all (drawn) elements, evaluated in parallel
   template <int D> 
-  void VTKOutput<D>::Do (LocalHeap & lh, VorB vb, const BitArray * drawelems)
+  bool VTKOutput<D>::FillData (LocalHeap & lh, VorB vb, const BitArray * drawelems)
   {
-    ostringstream filenamefinal;
-    filenamefinal << filename;
-    if (output_cnt > 0)
-      filenamefinal << "_" << output_cnt;
-    filenamefinal << ".vtk";
-    fileout = make_shared<ofstream>(filenamefinal.str());
-    cout << IM(4) << " Writing VTK-Output";
-    if (output_cnt > 0)
-      cout << IM(4) << " ( " << output_cnt << " )";
-    cout << IM(4) << ":" << flush;
-    
-    output_cnt++;
-
-    ResetArrays();
+    static Timer t("VTKOutput::FillData");
+    RegionTimer reg(t);
 
     Array<IntegrationPoint> ref_vertices_tet(0), ref_vertices_prism(0), ref_vertices_trig(0), ref_vertices_quad(0), ref_vertices_hex(0);
     Array<INT<ELEMENT_MAXPOINTS+1>> ref_tets(0), ref_prisms(0), ref_trigs(0), ref_quads(0), ref_hexes(0);
-    FlatArray<IntegrationPoint> ref_vertices;
-    FlatArray<INT<ELEMENT_MAXPOINTS+1>> ref_elems;
-    /*
-    if (D==3)
-      FillReferenceData3D(ref_vertices,ref_tets);
-    else
-      FillReferenceData2D(ref_vertices,ref_tets);
-    */
     FillReferenceTet(ref_vertices_tet,ref_tets);
     FillReferencePrism(ref_vertices_prism,ref_prisms);
     FillReferenceQuad(ref_vertices_quad,ref_quads);
     FillReferenceTrig(ref_vertices_trig,ref_trigs);
     FillReferenceHex(ref_vertices_hex,ref_hexes);
-      
-    // header:
-    *fileout << "# vtk DataFile Version 3.0" << endl;
-    *fileout << "vtk output" << endl;
-    *fileout << "ASCII" << endl;
-    *fileout << "DATASET UNSTRUCTURED_GRID" << endl;
 
-    int ne = ma->GetNE(vb);
+    // reference lattice and vtk cell type of an element type
+    auto reference = [&] (ELEMENT_TYPE eltype)
+      -> tuple<FlatArray<IntegrationPoint>, FlatArray<INT<ELEMENT_MAXPOINTS+1>>, unsigned char>
+      {
+        switch(eltype)
+          {
+          case ET_TRIG: return { ref_vertices_trig, ref_trigs, 5 };
+          case ET_QUAD: return { ref_vertices_quad, ref_quads, 9 };
+          case ET_TET: return { ref_vertices_tet, ref_tets, 10 };
+          case ET_HEX: return { ref_vertices_hex, ref_hexes, 12 };
+          case ET_PRISM: return { ref_vertices_prism, ref_prisms, 13 };
+          default:
+            throw Exception("VTK output for element-type"+ToString(eltype)+"not supported");
+          }
+      };
 
+    int ne = ma->GetNE(vb);
     IntRange range = only_element >= 0 ? IntRange(only_element,only_element+1) : IntRange(ne);
-    
-    for ( int elnr : range)
-    {
-      if (drawelems && !(drawelems->Test(elnr)))
-          continue;
-      
-      HeapReset hr(lh);
 
-      ElementId ei(vb, elnr);
-      ElementTransformation & eltrans = ma->GetTrafo (ei, lh);
-      ELEMENT_TYPE eltype = ma->GetElType(ei);
-
-      switch(eltype)
+    Array<int> elnrs;
+    Array<size_t> firstpoint(1), firstcell(1);
+    firstpoint[0] = firstcell[0] = 0;
+    for (int elnr : range)
       {
-      case ET_TRIG:
-        ref_vertices.Assign(ref_vertices_trig);
-        ref_elems.Assign(ref_trigs);
-        break;
-      case ET_QUAD:
-        ref_vertices.Assign(ref_vertices_quad);
-        ref_elems.Assign(ref_quads);
-        break;
-      case ET_TET:
-        ref_vertices.Assign(ref_vertices_tet);
-        ref_elems.Assign(ref_tets);
-        break;
-      case ET_HEX:
-        ref_vertices.Assign(ref_vertices_hex);
-        ref_elems.Assign(ref_hexes);
-        break;        
-      case ET_PRISM:
-        ref_vertices.Assign(ref_vertices_prism);
-        ref_elems.Assign(ref_prisms);
-        break;
-      default:
-        throw Exception("VTK output for element-type"+ToString(eltype)+"not supported");
+        if (drawelems && !(drawelems->Test(elnr)))
+          continue;
+        auto ref = reference(ma->GetElType(ElementId(vb, elnr)));
+        elnrs.Append (elnr);
+        firstpoint.Append (firstpoint.Last() + get<0>(ref).Size());
+        firstcell.Append (firstcell.Last() + get<1>(ref).Size());
       }
+    size_t np = firstpoint.Last();
 
-      int offset = points.Size();
-      for ( auto ip : ref_vertices)
+    bool reuse = geometry_valid && !drawelems && vb == geometry_vb
+      && ma->GetTimeStamp() == geometry_timestamp && !ma->GetDeformation();
+    if (!reuse)
       {
-        if (vb==VOL)
-        {
-          MappedIntegrationPoint<D,D> mip(ip, eltrans);
-          points.Append(mip.GetPoint());
-        }
-        else
-        {
-          MappedIntegrationPoint<D-1,D> mip(ip, eltrans);
-          points.Append(mip.GetPoint());
-        }
+        points.SetSize(np);
+        cells.SetSize(firstcell.Last());
+        celltypes.SetSize(firstcell.Last());
       }
-      
-      for (int i = 0; i < coefs.Size(); i++)
+    for (auto field : value_field)
+      field->SetSize(np * field->Dimension());
+
+    ParallelForRange
+      (elnrs.Size(), [&] (IntRange r)
+       {
+         LocalHeap slh = lh.Split();
+         for (auto k : r)
+           {
+             HeapReset hr(slh);
+             ElementId ei(vb, elnrs[k]);
+             ElementTransformation & eltrans = ma->GetTrafo (ei, slh);
+             auto ref = reference(eltrans.GetElementType());
+             FlatArray<IntegrationPoint> ref_vertices = get<0>(ref);
+             size_t offset = firstpoint[k];
+
+             IntegrationRule ir(ref_vertices.Size(), &ref_vertices[0]);
+             BaseMappedIntegrationRule & mir = eltrans(ir, slh);
+
+             if (!reuse)
+               {
+                 for (size_t j : Range(ir))
+                   points[offset+j] = mir[j].GetPoint();
+                 size_t cell = firstcell[k];
+                 for (auto elem : get<1>(ref))
+                   {
+                     for (int i = 1; i <= elem[0]; ++i)
+                       elem[i] += offset;
+                     cells[cell] = elem;
+                     celltypes[cell++] = get<2>(ref);
+                   }
+               }
+
+             for (int i = 0; i < coefs.Size(); i++)
+               {
+                 const int dim = coefs[i]->Dimension();
+                 FlatMatrix<> values(ir.Size(), dim, slh);
+                 coefs[i]->Evaluate (mir, values);
+                 auto & field = *value_field[i];
+                 for (size_t j : Range(ir))
+                   for (int d = 0; d < dim; ++d)
+                     field[(offset+j)*dim+d] = values(j,d);
+               }
+           }
+       });
+
+    if (!reuse)
       {
-        for ( auto ip : ref_vertices)
-        {
-          if (vb==VOL)
-          {
-            MappedIntegrationPoint<D,D> mip(ip, eltrans);
-            const int dim = coefs[i]->Dimension();
-            FlatVector<> tmp(dim,lh);
-            coefs[i]->Evaluate(mip,tmp);
-            for (int d = 0; d < dim; ++d)
-              value_field[i]->Append(tmp(d));
-          }
-          else
-          {
-            MappedIntegrationPoint<D-1,D> mip(ip, eltrans);
-            const int dim = coefs[i]->Dimension();
-            FlatVector<> tmp(dim,lh);
-            coefs[i]->Evaluate(mip,tmp);
-            for (int d = 0; d < dim; ++d)
-              value_field[i]->Append(tmp(d));
-          }
-        }
+        geometry_valid = !drawelems;
+        geometry_vb = vb;
+        geometry_timestamp = ma->GetTimeStamp();
+        if (format == "vtu") EncodeGeometry();
       }
-      
-      for ( auto elem : ref_elems)
+    return reuse;
+  }
+
+
+  // appends a data array as UInt64 byte count + raw data (VTK appended data)
+  template <typename T>
+  static void AppendBlock (Array<char> & block, FlatArray<T> data)
+  {
+    uint64_t nbytes = data.Size() * sizeof(T);
+    size_t pos = block.Size();
+    block.SetSize (pos + sizeof(nbytes) + nbytes);
+    memcpy (&block[pos], &nbytes, sizeof(nbytes));
+    if (nbytes)
+      memcpy (&block[pos+sizeof(nbytes)], &data[0], nbytes);
+  }
+
+  static string VTUArray (string type, string name, int ncomp, size_t offset)
+  {
+    stringstream str;
+    str << "        <DataArray type=\"" << type << "\"";
+    if (name != "") str << " Name=\"" << name << "\"";
+    if (ncomp > 1) str << " NumberOfComponents=\"" << ncomp << "\"";
+    str << " format=\"appended\" offset=\"" << offset << "\"/>\n";
+    return str.str();
+  }
+
+  /// binary points and cells, shared by all outputs on the same mesh
+  template <int D> 
+  void VTKOutput<D>::EncodeGeometry ()
+  {
+    Array<float> pts(3*points.Size());
+    ParallelFor (points.Size(), [&] (size_t i)
+                 {
+                   for (int j = 0; j < 3; j++)
+                     pts[3*i+j] = j < D ? points[i](j) : 0.0;
+                 });
+
+    Array<int64_t> offsets(cells.Size());
+    size_t nconn = 0;
+    for (size_t i : Range(cells))
+      offsets[i] = nconn += cells[i][0];
+    Array<int64_t> connectivity(nconn);
+    ParallelFor (cells.Size(), [&] (size_t i)
+                 {
+                   int nv = cells[i][0];
+                   for (int j = 0; j < nv; j++)
+                     connectivity[offsets[i]-nv+j] = cells[i][j+1];
+                 });
+
+    stringstream header;
+    geometry_block.SetSize(0);
+    header << "      <Points>\n" << VTUArray ("Float32", "", 3, geometry_block.Size());
+    AppendBlock (geometry_block, FlatArray<float>(pts));
+    header << "      </Points>\n      <Cells>\n"
+           << VTUArray ("Int64", "connectivity", 1, geometry_block.Size());
+    AppendBlock (geometry_block, FlatArray<int64_t>(connectivity));
+    header << VTUArray ("Int64", "offsets", 1, geometry_block.Size());
+    AppendBlock (geometry_block, FlatArray<int64_t>(offsets));
+    header << VTUArray ("UInt8", "types", 1, geometry_block.Size());
+    AppendBlock (geometry_block, FlatArray<unsigned char>(celltypes));
+    header << "      </Cells>\n";
+    geometry_header = header.str();
+  }
+
+  /// binary point data of the current output, appended after the geometry
+  template <int D> 
+  void VTKOutput<D>::EncodeFields ()
+  {
+    static Timer t("VTKOutput::EncodeFields");
+    RegionTimer reg(t);
+
+    field_block.SetSize(0);
+    stringstream fieldheader;
+    fieldheader << "      <PointData>\n";
+    for (auto field : value_field)
       {
-        INT<ELEMENT_MAXPOINTS+1> new_elem = elem;
-        for (int i = 1; i <= new_elem[0]; ++i)
-          new_elem[i] += offset;
-        cells.Append(new_elem);
+        fieldheader << VTUArray ("Float32", field->Name(), field->Dimension(),
+                                 geometry_block.Size()+field_block.Size());
+        Array<float> values(field->Size());
+        ParallelFor (values.Size(), [&] (size_t i) { values[i] = (*field)[i]; });
+        AppendBlock (field_block, FlatArray<float>(values));
       }
+    fieldheader << "      </PointData>\n";
+    field_header = fieldheader.str();
+  }
 
-    }
+  /// VTK XML unstructured grid, all arrays as raw appended data.
+  /// Only file output: may run on a thread outside the task manager
+  template <int D> 
+  void VTKOutput<D>::WriteVTU (string vtufile) const
+  {
+
+    uint16_t one = 1;
+    bool little_endian = *reinterpret_cast<char*>(&one) == 1;
+    stringstream header;
+    header << "<?xml version=\"1.0\"?>\n"
+           << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\""
+           << (little_endian ? "LittleEndian" : "BigEndian") << "\" header_type=\"UInt64\">\n"
+           << "  <UnstructuredGrid>\n"
+           << "    <Piece NumberOfPoints=\"" << points.Size()
+           << "\" NumberOfCells=\"" << cells.Size() << "\">\n"
+           << geometry_header << field_header
+           << "    </Piece>\n  </UnstructuredGrid>\n"
+           << "  <AppendedData encoding=\"raw\">\n_";
+    string footer = "\n  </AppendedData>\n</VTKFile>\n";
+
+    ofstream out(vtufile, ios::binary);
+    string sheader = header.str();
+    out.write (sheader.data(), sheader.size());
+    out.write (&geometry_block[0], geometry_block.Size());
+    if (field_block.Size())
+      out.write (&field_block[0], field_block.Size());
+    out.write (footer.data(), footer.size());
+    if (!out)
+      throw Exception ("VTKOutput: could not write " + vtufile);
+  }
+
+  template <int D> 
+  void VTKOutput<D>::Do (LocalHeap & lh, VorB vb, const BitArray * drawelems, double time)
+  {
+    // the previous output may still be written in the background
+    if (writer.valid())
+      writer.get();
+
+    ostringstream filenamefinal;
+    filenamefinal << filename;
+    if (output_cnt > 0)
+      filenamefinal << "_" << output_cnt;
+    filenamefinal << "." << format;
+    cout << IM(4) << " Writing VTK-Output";
+    if (output_cnt > 0)
+      cout << IM(4) << " ( " << output_cnt << " )";
+    cout << IM(4) << ":" << flush;
+    
+    if (time < 0) time = output_cnt;
+    output_cnt++;
+
+    FillData (lh, vb, drawelems);
+
+    if (format == "vtu")
+      {
+        // .pvd index of all outputs, file names relative to the index
+        string vtufile = filenamefinal.str();
+        timesteps.Append (make_tuple(time, vtufile.substr(vtufile.find_last_of("/\\")+1)));
+        stringstream pvd;
+        pvd << "<?xml version=\"1.0\"?>\n"
+            << "<VTKFile type=\"Collection\" version=\"0.1\">\n  <Collection>\n";
+        for (auto [t, file] : timesteps)
+          pvd << "    <DataSet timestep=\"" << setprecision(16) << t
+              << "\" part=\"0\" file=\"" << file << "\"/>\n";
+        pvd << "  </Collection>\n</VTKFile>\n";
+
+        // encoding uses the task manager, hence not on the writer thread
+        EncodeFields();
+        auto write = [this, vtufile, pvdfile = filename+".pvd", pvdtext = pvd.str()] ()
+          {
+            WriteVTU (vtufile);
+            ofstream (pvdfile) << pvdtext;
+          };
+        if (background)
+          writer = std::async (std::launch::async, write);
+        else
+          write();
+        cout << IM(4) << " Done." << endl;
+        return;
+      }
+
+    fileout = make_shared<ofstream>(filenamefinal.str());
+    // header:
+    *fileout << "# vtk DataFile Version 3.0" << endl;
+    *fileout << "vtk output" << endl;
+    *fileout << "ASCII" << endl;
+    *fileout << "DATASET UNSTRUCTURED_GRID" << endl;
 
     PrintPoints();
     PrintCells();
@@ -6,6 +6,8 @@
 /* Date:   1. June 2014                                              */
 /*********************************************************************/
 
+#include <future>
+
 namespace ngcomp
 { 
 
@@ -30,7 +32,8 @@ namespace ngcomp
   {
   public:
     virtual ~BaseVTKOutput() { ; }
-    virtual void Do (LocalHeap & lh, VorB vb = VOL, const BitArray * drawelems = 0) = 0;
+    virtual void Do (LocalHeap & lh, VorB vb = VOL, const BitArray * drawelems = 0,
+                     double time = -1) = 0;
   };
   
   template <int D> 
@@ -44,14 +47,33 @@ namespace ngcomp
     string filename;
     int subdivision;
     int only_element = -1;
+    /// "vtk": legacy ASCII, "vtu": XML with appended raw binary data + .pvd index
+    string format = "vtk";
+    /// write vtu files on a background thread, overlapping with the computation
+    bool background = false;
 
     Array<shared_ptr<ValueField>> value_field;
     Array<Vec<D>> points;
     Array<INT<ELEMENT_MAXPOINTS+1>> cells;
+    Array<unsigned char> celltypes;
 
     int output_cnt = 0;
     
     shared_ptr<ofstream> fileout;
+
+    /// geometry of the last output, reused as long as the mesh is unchanged
+    bool geometry_valid = false;
+    size_t geometry_timestamp = 0;
+    VorB geometry_vb = VOL;
+    Array<char> geometry_block;
+    string geometry_header;
+    /// point data of the current output, read by the background writer
+    Array<char> field_block;
+    string field_header;
+
+    /// (time, file) of all vtu outputs, for the .pvd index
+    Array<tuple<double,string>> timesteps;
+    std::future<void> writer;
     
   public:
 
@@ -59,8 +81,9 @@ namespace ngcomp
                const Flags &,shared_ptr<MeshAccess>);
 
     VTKOutput (shared_ptr<MeshAccess>, const Array<shared_ptr<CoefficientFunction>> &,
-               const Array<string> &, string, int, int);
-    virtual ~VTKOutput() { ; }
+               const Array<string> &, string, int, int,
+               string aformat = "vtk", bool abackground = false);
+    virtual ~VTKOutput();
     
     void ResetArrays();
     
@@ -75,7 +98,14 @@ namespace ngcomp
     void PrintCellTypes(VorB vb, const BitArray * drawelems=nullptr);
     void PrintFieldData();    
 
-    virtual void Do (LocalHeap & lh, VorB vb = VOL, const BitArray * drawelems = 0);
+    /// evaluates points (unless reused) and fields, returns true if the geometry was reused
+    bool FillData (LocalHeap & lh, VorB vb, const BitArray * drawelems);
+    void EncodeGeometry ();
+    void EncodeFields ();
+    void WriteVTU (string filename) const;
+
+    virtual void Do (LocalHeap & lh, VorB vb = VOL, const BitArray * drawelems = 0,
+                     double time = -1) override;
   };
 
 
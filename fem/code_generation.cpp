@@ -3,11 +3,16 @@
 #include<l2hofe_impl.hpp>
 #include<l2hofefo.hpp>
 #include<regex>
+#include<thread>
+#include<cstdio>
+#ifdef WIN32
+#include<process.h>
+#else
+#include<unistd.h>
+#endif
 
 namespace ngfem
 {
-    atomic<unsigned> Code::id_counter{0};
-
     void Code::AddLinkFlag(string flag)
     {
         if(std::find(std::begin(link_flags), std::end(link_flags), flag) == std::end(link_flags))
@@ -16,63 +21,143 @@ namespace ngfem
 
     string Code::AddPointer(const void *p)
     {
-        string name = "compiled_code_pointer" + ToString(id_counter++); 
-        top += "extern \"C\" void* " + name + ";\n";
-        stringstream s_ptr;
-#ifdef WIN32
-        s_ptr << "0x";
-#endif
-        s_ptr << std::hex << p;
-        pointer += "void *" + name + " = reinterpret_cast<void*>(" + s_ptr.str() + ");\n";
-        return name;
+        size_t pos = std::find(pointers.begin(), pointers.end(), p) - pointers.begin();
+        if(pos == pointers.size())
+          pointers.push_back(p);
+        return "compiled_code_pointers[" + ToString(pos) + "]";
+    }
+
+    static string & CodeCacheDirectory()
+    {
+      static string dir = [] ()
+        {
+          const char * env = getenv("NGSOLVE_CODE_CACHE_DIR");
+          return string(env ? env : ".");
+        } ();
+      return dir;
+    }
+
+    static atomic<size_t> code_cache_hits{0};
+    static atomic<size_t> code_cache_misses{0};
+
+    void SetCodeCacheDirectory (string dir)
+    {
+      CodeCacheDirectory() = dir;
+    }
+
+    string GetCodeCacheDirectory ()
+    {
+      return CodeCacheDirectory();
+    }
+
+    CodeCacheStatistics GetCodeCacheStatistics ()
+    {
+      return { code_cache_hits.load(), code_cache_misses.load() };
+    }
+
+    // FNV-1a, stable across runs and platforms (std::hash is not)
+    static uint64_t HashCode(const std::vector<string> &codes, const std::vector<string> &link_flags)
+    {
+      uint64_t hash = 14695981039346656037ull;
+      auto add = [&hash] (const string & s)
+        {
+          for (unsigned char c : s)
+            hash = (hash ^ c) * 1099511628211ull;
+          hash = (hash ^ 0xff) * 1099511628211ull;   // separator
+        };
+      add(ngsolve_version);
+      for (auto & code : codes) add(code);
+      for (auto & flag : link_flags) add(flag);
+      return hash;
     }
 
     unique_ptr<SharedLibrary> CompileCode(const std::vector<string> &codes, const std::vector<string> &link_flags )
     {
-      static int counter = 0;
       static ngstd::Timer tcompile("CompiledCF::Compile");
       static ngstd::Timer tlink("CompiledCF::Link");
-      string object_files;
-      int i = 0;
-      string prefix = "code" + ToString(counter++);
-      for(string code : codes) {
-        string file_prefix = prefix+"_"+ToString(i++);
-        ofstream codefile(file_prefix+".cpp");
-        codefile << code;
-        codefile.close();
-        cout << IM(3) << "compiling..." << endl;
-        tcompile.Start();
+      static atomic<int> counter{0};
+
+      stringstream shash;
+      shash << std::hex << std::setw(16) << std::setfill('0') << HashCode(codes, link_flags);
+      string dir = GetCodeCacheDirectory();
+      string libname = dir + "/ngscf_" + shash.str();
+#ifdef WIN32
+      libname += ".dll";
+#else
+      libname += ".so";
+#endif
+
+      auto library = make_unique<SharedLibrary>();
+      if (ifstream(libname).good())
+        {
+          code_cache_hits++;
+          cout << IM(3) << "using cached " << libname << endl;
+          library->Load(libname);
+          return library;
+        }
+      code_cache_misses++;
+
+      // unique names for temporary files, the same code may be compiled
+      // by several threads or processes at the same time
+#ifdef WIN32
+      int pid = _getpid();
+#else
+      int pid = getpid();
+#endif
+      string prefix = dir + "/ngscf_" + shash.str() + "_" + ToString(pid) + "_"
+        + ToString(std::hash<std::thread::id>()(std::this_thread::get_id()) % 1000000)
+        + "_" + ToString(counter++);
+
+      std::vector<string> object_files(codes.size());
+      cout << IM(3) << "compiling..." << endl;
+      tcompile.Start();
+      for (size_t i = 0; i < codes.size(); i++)
+        {
+          string file_prefix = prefix+"_"+ToString(i);
+          ofstream codefile(file_prefix+".cpp");
+          codefile << codes[i];
+          codefile.close();
 #ifdef WIN32
-        string scompile = "cmd /C \"ngscxx.bat " + file_prefix + ".cpp\"";
-        object_files += file_prefix+".obj ";
+          string scompile = "cmd /C \"ngscxx.bat " + file_prefix + ".cpp\"";
+          object_files[i] = file_prefix+".obj";
 #else
-        string scompile = "ngscxx -c " + file_prefix + ".cpp -o " + file_prefix + ".o";
-        object_files += file_prefix+".o ";
+          string scompile = "ngscxx -c " + file_prefix + ".cpp -o " + file_prefix + ".o";
+          object_files[i] = file_prefix+".o";
 #endif
-        int err = system(scompile.c_str());
-        if (err) throw Exception ("problem calling compiler");
-        tcompile.Stop();
-      }
+          if (system(scompile.c_str()))
+            throw Exception ("problem calling compiler");
+        }
+      tcompile.Stop();
 
+      string tmpname = prefix;
+#ifdef WIN32
+      tmpname += ".dll";
+#else
+      tmpname += ".so";
+#endif
       cout << IM(3) << "linking..." << endl;
       tlink.Start();
+      string objects;
+      for (auto & obj : object_files)
+        objects += obj + " ";
 #ifdef WIN32
-        string slink = "cmd /C \"ngsld.bat /OUT:" + prefix+".dll " + object_files + "\"";
+        string slink = "cmd /C \"ngsld.bat /OUT:" + tmpname + " " + objects + "\"";
 #else
-        string slink = "ngsld -shared " + object_files + " -o " + prefix + ".so -lngstd -lngbla -lngfem -lngcore";
+        string slink = "ngsld -shared " + objects + " -o " + tmpname + " -lngstd -lngbla -lngfem -lngcore";
         for (auto flag : link_flags)
             slink += " "+flag;
 #endif
       int err = system(slink.c_str());
       if (err) throw Exception ("problem calling linker");      
       tlink.Stop();
+      for (auto & obj : object_files)
+        std::remove(obj.c_str());
+
+      // publish atomically, a concurrent writer produced the same library
+      if (std::rename(tmpname.c_str(), libname.c_str()) != 0)
+        std::remove(tmpname.c_str());
       cout << IM(3) << "done" << endl;
-      auto library = make_unique<SharedLibrary>();
-#ifdef WIN32
-      library->Load(prefix+".dll");
-#else
-      library->Load("./"+prefix+".so");
-#endif
+      library->Load(libname);
       return library;
     }
 
@@ -47,13 +47,14 @@ namespace ngfem
     int deriv;
     std::vector<string> link_flags;
 
-    string pointer;
+    // runtime pointers, passed to the compiled functions as
+    // 'void ** compiled_code_pointers' (keeps the code reusable)
+    std::vector<const void*> pointers;
 
     string AddPointer(const void *p );
 
     void AddLinkFlag(string flag);
 
-    static atomic<unsigned> id_counter;
     static string Map( string code, std::map<string,string> variables ) {
       for ( auto mapping : variables ) {
         string oldStr = '{'+mapping.first+'}';
@@ -177,7 +178,23 @@ namespace ngfem
     }
   }
 
+  /*
+    Compiles and links the code units to a shared library. Libraries
+    are cached on disk, keyed by a hash of code, link flags and ngsolve
+    version, and reused by later calls (also from other processes).
+  */
   unique_ptr<SharedLibrary> CompileCode(const std::vector<string> &codes, const std::vector<string> &libraries );
+
+  // directory of the compiled-code cache (default: $NGSOLVE_CODE_CACHE_DIR or ".")
+  NGS_DLL_HEADER void SetCodeCacheDirectory (string dir);
+  NGS_DLL_HEADER string GetCodeCacheDirectory ();
+
+  struct CodeCacheStatistics
+  {
+    size_t hits;
+    size_t misses;
+  };
+  NGS_DLL_HEADER CodeCacheStatistics GetCodeCacheStatistics ();
   namespace detail {
       string GenerateL2ElementCode(int order);
   }
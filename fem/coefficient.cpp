@@ -11,6 +11,7 @@
 #include <fem.hpp>
 #include <../ngstd/evalfunc.hpp>
 #include <algorithm>
+#include <unordered_map>
 
 namespace ngstd
 {
@@ -240,6 +241,11 @@ namespace ngfem
     return ToString(val);
   }
 
+  string ConstantCoefficientFunction :: StructuralKey () const
+  {
+    return "Constant "+ToLiteral(val);
+  }
+
   
   /*
   virtual string ConsantCoefficientFunction :: GetDescription() const 
@@ -1014,6 +1020,10 @@ public:
     });
   }
 
+  virtual bool ElementBatchable () const override { return true; }
+  virtual string StructuralKey () const override { return "Scale "+ToLiteral(scal); }
+  double GetScalingFactor () const { return scal; }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     c1->TraverseTree (func);
@@ -1129,6 +1139,8 @@ public:
   // virtual bool IsComplex() const { return true; }
   // virtual int Dimension() const { return c1->Dimension(); }
 
+  virtual bool ElementBatchable () const override { return true; }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     c1->TraverseTree (func);
@@ -1206,6 +1218,9 @@ public:
     SetDimensions (c2->Dimensions());
   }
   
+  virtual bool ElementBatchable () const override { return true; }
+  virtual string StructuralKey () const override { return typeid(*this).name(); }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     c1->TraverseTree (func);
@@ -1368,6 +1383,9 @@ public:
     code.body += Var(index).Assign(result.S());
   }
 
+  virtual bool ElementBatchable () const override { return true; }
+  virtual string StructuralKey () const override { return typeid(*this).name(); }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     c1->TraverseTree (func);
@@ -1522,6 +1540,9 @@ public:
     code.body += Var(index).Assign(result.S());
   }
 
+  virtual bool ElementBatchable () const override { return true; }
+  virtual string StructuralKey () const override { return typeid(*this).name(); }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     c1->TraverseTree (func);
@@ -1727,6 +1748,9 @@ public:
     ar.Shallow(c1) & dim1;
   }
   
+  virtual bool ElementBatchable () const override { return true; }
+  virtual string StructuralKey () const override { return typeid(*this).name(); }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     c1->TraverseTree (func);
@@ -1863,6 +1887,9 @@ public:
     ar.Shallow(c1) & dim1;
   }
   
+  virtual bool ElementBatchable () const override { return true; }
+  virtual string StructuralKey () const override { return typeid(*this).name(); }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     c1->TraverseTree (func);
@@ -1980,6 +2007,9 @@ public:
     inner_dim = dims_c1[1];
   }
   
+  virtual bool ElementBatchable () const override { return true; }
+  virtual string StructuralKey () const override { return typeid(*this).name(); }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     c1->TraverseTree (func);
@@ -2206,6 +2236,9 @@ public:
   // virtual int Dimension() const { return dims[0]; }
   // virtual Array<int> Dimensions() const { return Array<int> (dims); } 
 
+  virtual bool ElementBatchable () const override { return true; }
+  virtual string StructuralKey () const override { return typeid(*this).name(); }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     c1->TraverseTree (func);
@@ -2375,6 +2408,9 @@ public:
   virtual string GetDescription () const override
   { return "Matrix transpose"; }
   
+  virtual bool ElementBatchable () const override { return true; }
+  virtual string StructuralKey () const override { return typeid(*this).name(); }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     c1->TraverseTree (func);
@@ -2528,6 +2564,9 @@ public:
     ar.Shallow(c1);
   }
   
+  virtual bool ElementBatchable () const override { return true; }
+  virtual string StructuralKey () const override { return typeid(*this).name(); }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     c1->TraverseTree (func);
@@ -2693,6 +2732,9 @@ public:
     ar.Shallow(c1);
   }
   
+  virtual bool ElementBatchable () const override { return true; }
+  virtual string StructuralKey () const override { return typeid(*this).name(); }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     c1->TraverseTree (func);
@@ -2856,6 +2898,9 @@ public:
     ar.Shallow(c1);
   }
   
+  virtual bool ElementBatchable () const override { return true; }
+  virtual string StructuralKey () const override { return typeid(*this).name(); }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     c1->TraverseTree (func);
@@ -3206,6 +3251,10 @@ public:
     code.body += Var(index).Assign( Var(inputs[0], i, j ));
   }
 
+  virtual bool ElementBatchable () const override { return true; }
+  virtual string StructuralKey () const override
+  { return string(typeid(*this).name()) + " " + ToString(comp); }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     c1->TraverseTree (func);
@@ -3381,6 +3430,8 @@ public:
     code.body += "}\n";
   }
 
+  virtual bool ElementBatchable () const override { return true; }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     for (auto & cf : ci)
@@ -4021,6 +4072,9 @@ class IfPosCoefficientFunction : public T_CoefficientFunction<IfPosCoefficientFu
     }
     */
     
+    virtual bool ElementBatchable () const override { return true; }
+    virtual string StructuralKey () const override { return typeid(*this).name(); }
+
     virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
     {
       cf_if->TraverseTree (func);
@@ -4115,6 +4169,9 @@ public:
   
   virtual void GenerateCode(Code &code, FlatArray<int> inputs, int index) const override;
 
+  virtual bool ElementBatchable () const override { return true; }
+  virtual string StructuralKey () const override { return typeid(*this).name(); }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     for (auto cf : ci)
@@ -4316,6 +4373,9 @@ public:
       return string("coordinate ")+dirname;
     }
 
+    virtual bool ElementBatchable () const override { return true; }
+    virtual string StructuralKey () const override { return GetDescription(); }
+
     using BASE::Evaluate;
     virtual double Evaluate (const BaseMappedIntegrationPoint & ip) const override
     {
@@ -4396,15 +4456,15 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
   // ///////////////////////////// Compiled CF /////////////////////////
   class CompiledCoefficientFunction : public CoefficientFunction, public std::enable_shared_from_this<CompiledCoefficientFunction>
   {
-    typedef void (*lib_function)(const ngfem::BaseMappedIntegrationRule &, ngbla::BareSliceMatrix<double>);
-    typedef void (*lib_function_simd)(const ngfem::SIMD_BaseMappedIntegrationRule &, BareSliceMatrix<SIMD<double>>);
-    typedef void (*lib_function_deriv)(const ngfem::BaseMappedIntegrationRule &, ngbla::BareSliceMatrix<AutoDiff<1,double>>);
-    typedef void (*lib_function_simd_deriv)(const ngfem::SIMD_BaseMappedIntegrationRule &, BareSliceMatrix<AutoDiff<1,SIMD<double>>>);
-    typedef void (*lib_function_dderiv)(const ngfem::BaseMappedIntegrationRule &, ngbla::BareSliceMatrix<AutoDiffDiff<1,double>>);
-    typedef void (*lib_function_simd_dderiv)(const ngfem::SIMD_BaseMappedIntegrationRule &, BareSliceMatrix<AutoDiffDiff<1,SIMD<double>>>);
+    typedef void (*lib_function)(const ngfem::BaseMappedIntegrationRule &, ngbla::BareSliceMatrix<double>, void **);
+    typedef void (*lib_function_simd)(const ngfem::SIMD_BaseMappedIntegrationRule &, BareSliceMatrix<SIMD<double>>, void **);
+    typedef void (*lib_function_deriv)(const ngfem::BaseMappedIntegrationRule &, ngbla::BareSliceMatrix<AutoDiff<1,double>>, void **);
+    typedef void (*lib_function_simd_deriv)(const ngfem::SIMD_BaseMappedIntegrationRule &, BareSliceMatrix<AutoDiff<1,SIMD<double>>>, void **);
+    typedef void (*lib_function_dderiv)(const ngfem::BaseMappedIntegrationRule &, ngbla::BareSliceMatrix<AutoDiffDiff<1,double>>, void **);
+    typedef void (*lib_function_simd_dderiv)(const ngfem::SIMD_BaseMappedIntegrationRule &, BareSliceMatrix<AutoDiffDiff<1,SIMD<double>>>, void **);
 
-    typedef void (*lib_function_complex)(const ngfem::BaseMappedIntegrationRule &, ngbla::BareSliceMatrix<Complex>);
-    typedef void (*lib_function_simd_complex)(const ngfem::SIMD_BaseMappedIntegrationRule &, BareSliceMatrix<SIMD<Complex>>);
+    typedef void (*lib_function_complex)(const ngfem::BaseMappedIntegrationRule &, ngbla::BareSliceMatrix<Complex>, void **);
+    typedef void (*lib_function_simd_complex)(const ngfem::SIMD_BaseMappedIntegrationRule &, BareSliceMatrix<SIMD<Complex>>, void **);
 
     shared_ptr<CoefficientFunction> cf;
     Array<CoefficientFunction*> steps;
@@ -4415,6 +4475,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     Array<bool> is_complex;
     // Array<Timer*> timers;
     unique_ptr<SharedLibrary> library;
+    Array<void*> code_pointers;
     lib_function compiled_function = nullptr;
     lib_function_simd compiled_function_simd = nullptr;
     lib_function_deriv compiled_function_deriv = nullptr;
@@ -4424,47 +4485,187 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
 
     lib_function_complex compiled_function_complex = nullptr;
     lib_function_simd_complex compiled_function_simd_complex = nullptr;
+    // constants created by folding, referenced by steps
+    Array<shared_ptr<CoefficientFunction>> folded;
 
-  public:
-    CompiledCoefficientFunction() = default;
-    CompiledCoefficientFunction (shared_ptr<CoefficientFunction> acf)
-      : CoefficientFunction(acf->Dimension(), acf->IsComplex()), cf(acf) // , compiled_function(nullptr), compiled_function_simd(nullptr)
+    /*
+      Linearizes the DAG into steps. Nodes with equal StructuralKey and
+      equal inputs are merged, scalar real constant subexpressions are
+      folded, x*1, x+0, x-0, x/1, 1*x are short-cut and 0*x becomes 0 for
+      scalars. Only steps the result depends on are kept.
+     */
+    void BuildSteps ()
     {
-      SetDimensions (cf->Dimensions());
+      Array<CoefficientFunction*> raw;
+      std::unordered_map<CoefficientFunction*,int> rawpos;
       cf -> TraverseTree
         ([&] (CoefficientFunction & stepcf)
          {
-           if (!steps.Contains(&stepcf))
-             {
-               steps.Append (&stepcf);
-               // timers.Append (new Timer(string("CompiledCF")+typeid(stepcf).name()));
-               dim.Append (stepcf.Dimension());
-               is_complex.Append (stepcf.IsComplex());
-             }
+           if (rawpos.emplace (&stepcf, raw.Size()).second)
+             raw.Append (&stepcf);
          });
-      
+
+      Array<CoefficientFunction*> nodes;
+      DynamicTable<int> nodeinputs(raw.Size()+1);
+      Array<bool> isconst;
+      Array<double> constval;
+      std::unordered_map<string,int> known;
+      folded.SetSize0();
+
+      auto add_node = [&] (CoefficientFunction * node, FlatArray<int> in) -> int
+        {
+          for (auto i : in)
+            nodeinputs.Add (nodes.Size(), i);
+          nodes.Append (node);
+          auto ccf = dynamic_cast<ConstantCoefficientFunction*> (node);
+          isconst.Append (ccf != nullptr);
+          constval.Append (ccf ? ccf->EvaluateConst() : 0.0);
+          return nodes.Size()-1;
+        };
+      auto full_key = [] (CoefficientFunction * node, FlatArray<int> in)
+        {
+          string key = node->StructuralKey();
+          key += node->IsComplex() ? " c(" : " r(";
+          for (auto d : node->Dimensions())
+            key += ToString(d) + ",";
+          key += ")";
+          for (auto i : in)
+            key += " " + ToString(i);
+          return key;
+        };
+      auto make_const = [&] (double val) -> int
+        {
+          auto ccf = make_shared<ConstantCoefficientFunction> (val);
+          string key = full_key (ccf.get(), FlatArray<int>());
+          auto it = known.find (key);
+          if (it != known.end()) return it->second;
+          folded.Append (ccf);
+          return known[key] = add_node (ccf.get(), FlatArray<int>());
+        };
+
+      Array<int> canon(raw.Size());
+      for (size_t r : Range(raw))
+        {
+          CoefficientFunction * node = raw[r];
+          Array<int> in;
+          for (auto incf : node->InputCoefficientFunctions())
+            in.Append (canon[rawpos[incf.get()]]);
+
+          auto has_value = [&] (int i, double val) { return isconst[in[i]] && constval[in[i]] == val; };
+          auto same_dims = [&] (int i)
+            {
+              auto d1 = node->Dimensions(), d2 = nodes[in[i]]->Dimensions();
+              if (d1.Size() != d2.Size()) return false;
+              for (auto j : Range(d1))
+                if (d1[j] != d2[j]) return false;
+              return true;
+            };
+          bool scalar = node->Dimension() == 1 && node->Dimensions().Size() <= 1 && !node->IsComplex();
+          bool allconst = in.Size() > 0;
+          for (auto i : in)
+            allconst = allconst && isconst[i];
+
+          int res = -1;
+          auto & type = typeid(*node);
+          if (type == typeid(cl_BinaryOpCF<GenericMult>))
+            {
+              if (has_value(0, 1) && same_dims(1)) res = in[1];
+              else if (has_value(1, 1) && same_dims(0)) res = in[0];
+              else if (scalar && (has_value(0, 0) || has_value(1, 0))) res = make_const(0);
+              else if (scalar && allconst) res = make_const(constval[in[0]] * constval[in[1]]);
+            }
+          else if (type == typeid(cl_BinaryOpCF<GenericPlus>))
+            {
+              if (has_value(0, 0) && same_dims(1)) res = in[1];
+              else if (has_value(1, 0) && same_dims(0)) res = in[0];
+              else if (scalar && allconst) res = make_const(constval[in[0]] + constval[in[1]]);
+            }
+          else if (type == typeid(cl_BinaryOpCF<GenericMinus>))
+            {
+              if (has_value(1, 0) && same_dims(0)) res = in[0];
+              else if (scalar && allconst) res = make_const(constval[in[0]] - constval[in[1]]);
+            }
+          else if (type == typeid(cl_BinaryOpCF<GenericDiv>))
+            {
+              if (has_value(1, 1) && same_dims(0)) res = in[0];
+              else if (scalar && allconst) res = make_const(constval[in[0]] / constval[in[1]]);
+            }
+          else if (type == typeid(ScaleCoefficientFunction))
+            {
+              double scal = static_cast<ScaleCoefficientFunction*>(node)->GetScalingFactor();
+              if (scal == 1 && same_dims(0)) res = in[0];
+              else if (scalar && (scal == 0 || allconst)) res = make_const(scal * constval[in[0]]);
+            }
+          else if (scalar && allconst && node->StructuralKey() != "")
+            {
+              // e.g. unary functions of constants
+              try { res = make_const(node->EvaluateConst()); }
+              catch (const Exception &) { ; }
+            }
+
+          if (res == -1)
+            {
+              if (node->StructuralKey() == "")
+                res = add_node (node, in);
+              else
+                {
+                  string key = full_key (node, in);
+                  auto it = known.find (key);
+                  if (it != known.end())
+                    res = it->second;
+                  else
+                    res = known[key] = add_node (node, in);
+                }
+            }
+          canon[r] = res;
+        }
+
+      // keep only what the result depends on, inputs come first
+      Array<bool> used(nodes.Size());
+      used = false;
+      used[canon.Last()] = true;
+      for (int i = nodes.Size()-1; i >= 0; i--)
+        if (used[i])
+          for (auto j : nodeinputs[i])
+            used[j] = true;
+      Array<int> stepnr(nodes.Size());
+      steps.SetSize0();
+      dim.SetSize0();
+      is_complex.SetSize0();
+      for (auto i : Range(nodes))
+        if (used[i])
+          {
+            stepnr[i] = steps.Size();
+            steps.Append (nodes[i]);
+            dim.Append (nodes[i]->Dimension());
+            is_complex.Append (nodes[i]->IsComplex());
+          }
+
       totdim = 0;
       for (int d : dim) totdim += d;
-      
+      inputs = DynamicTable<int> (steps.Size());
+      max_inputsize = 0;
+      for (auto i : Range(nodes))
+        if (used[i])
+          {
+            max_inputsize = max2(nodeinputs[i].Size(), max_inputsize);
+            for (auto j : nodeinputs[i])
+              inputs.Add (stepnr[i], stepnr[j]);
+          }
+      cout << IM(3) << "Compiled CF: " << raw.Size() << " nodes, " << steps.Size() << " steps" << endl;
+    }
+
+  public:
+    CompiledCoefficientFunction() = default;
+    CompiledCoefficientFunction (shared_ptr<CoefficientFunction> acf)
+      : CoefficientFunction(acf->Dimension(), acf->IsComplex()), cf(acf) // , compiled_function(nullptr), compiled_function_simd(nullptr)
+    {
+      SetDimensions (cf->Dimensions());
+      BuildSteps();
+
       cout << IM(3) << "Compiled CF:" << endl;
       for (auto cf : steps)
         cout << IM(3) << typeid(*cf).name() << endl;
-      
-      inputs = DynamicTable<int> (steps.Size());
-      max_inputsize = 0;
-      
-      cf -> TraverseTree
-        ([&] (CoefficientFunction & stepcf)
-         {
-           int mypos = steps.Pos (&stepcf);
-           if (!inputs[mypos].Size())
-             {
-               Array<shared_ptr<CoefficientFunction>> in = stepcf.InputCoefficientFunctions();
-               max_inputsize = max2(in.Size(), max_inputsize);
-               for (auto incf : in)
-                 inputs.Add (mypos, steps.Pos(incf.get()));
-             }
-         });
       cout << IM(3) << "inputs = " << endl << inputs << endl;
 
     }
@@ -4519,36 +4720,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
       CoefficientFunction::DoArchive(ar);
       ar.Shallow(cf);
       if(ar.Input())
-        {
-          cf -> TraverseTree
-            ([&] (CoefficientFunction & stepcf)
-             {
-               if (!steps.Contains(&stepcf))
-                 {
-                   steps.Append (&stepcf);
-                   // timers.Append (new Timer(string("CompiledCF")+typeid(stepcf).name()));
-                   dim.Append (stepcf.Dimension());
-                   is_complex.Append (stepcf.IsComplex());
-                 }
-             });
-          totdim = 0;
-          for (int d : dim) totdim += d;
-          inputs = DynamicTable<int> (steps.Size());
-          max_inputsize = 0;
-
-          cf -> TraverseTree
-            ([&] (CoefficientFunction & stepcf)
-             {
-               int mypos = steps.Pos (&stepcf);
-               if (!inputs[mypos].Size())
-                 {
-                   Array<shared_ptr<CoefficientFunction>> in = stepcf.InputCoefficientFunctions();
-                   max_inputsize = max2(in.Size(), max_inputsize);
-                   for (auto incf : in)
-                     inputs.Add (mypos, steps.Pos(incf.get()));
-                 }
-             });
-        }
+        BuildSteps();
     }
 
     void RealCompile(int maxderiv, bool wait)
@@ -4557,7 +4729,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
         if(cf->IsComplex())
             maxderiv = 0;
         stringstream s;
-        string pointer_code;
+        std::vector<const void*> pointers;
         string top_code = ""
              "#include<fem.hpp>\n"
              "using namespace ngfem;\n"
@@ -4572,6 +4744,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
             Code code;
             code.is_simd = simd;
             code.deriv = deriv;
+            code.pointers = pointers;
 
             string res_type = cf->IsComplex() ? "Complex" : "double";
             if(simd) res_type = "SIMD<" + res_type + ">";
@@ -4585,7 +4758,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
               step.GenerateCode(code, inputs[i],i);
             }
 
-            pointer_code += code.pointer;
+            pointers = code.pointers;
             top_code += code.top;
 
             // set results
@@ -4635,11 +4808,11 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
             // Function parameters
             if (simd)
               {
-                s << "(SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<" << res_type << "> results";
+                s << "(SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<" << res_type << "> results, void ** compiled_code_pointers";
               }
             else
               {
-                s << "(BaseMappedIntegrationRule & mir, BareSliceMatrix<" << res_type << "> results";
+                s << "(BaseMappedIntegrationRule & mir, BareSliceMatrix<" << res_type << "> results, void ** compiled_code_pointers";
                 /*
                 string param_type = simd ? "BareSliceMatrix<SIMD<"+scal_type+">> " : "FlatMatrix<"+scal_type+"> ";
                 if (simd && deriv == 0) param_type = "BareSliceMatrix<SIMD<"+scal_type+">> ";
@@ -4666,11 +4839,9 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
         string file_code = top_code + s.str();
         std::vector<string> codes;
         codes.push_back(file_code);
-        if(pointer_code.size()) {
-          pointer_code = "extern \"C\" {\n" + pointer_code;
-          pointer_code += "}\n";
-          codes.push_back(pointer_code);
-        }
+        code_pointers.SetSize(pointers.size());
+        for (auto i : Range(pointers.size()))
+          code_pointers[i] = const_cast<void*>(pointers[i]);
 
         auto self = shared_from_this();
         auto compile_func = [self, codes, link_flags, maxderiv] () {
@@ -4817,7 +4988,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     {
       if(compiled_function)
       {
-        compiled_function(ir,values);
+        compiled_function(ir, values, code_pointers);
         return;
       }
 
@@ -4869,7 +5040,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     {
       if(compiled_function_deriv)
         {
-          compiled_function_deriv(ir, values);
+          compiled_function_deriv(ir, values, code_pointers);
           return;
         }
 
@@ -4908,7 +5079,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     {
       if(compiled_function_dderiv)
       {
-        compiled_function_dderiv(ir, values);
+        compiled_function_dderiv(ir, values, code_pointers);
         return;
       }
 
@@ -4947,7 +5118,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     {
       if(compiled_function_simd_deriv)
         {
-          compiled_function_simd_deriv(ir, values);
+          compiled_function_simd_deriv(ir, values, code_pointers);
           return;
         }
 
@@ -4988,7 +5159,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     {
       if(compiled_function_simd_dderiv)
       {
-        compiled_function_simd_dderiv(ir, values);
+        compiled_function_simd_dderiv(ir, values, code_pointers);
         return;
       }
       
@@ -5029,7 +5200,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     {
       if(compiled_function_simd)
       {
-        compiled_function_simd(ir, values);
+        compiled_function_simd(ir, values, code_pointers);
         return;
       }
 
@@ -5070,7 +5241,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     {
       if(compiled_function_complex)
       {
-          compiled_function_complex(ir,values);
+          compiled_function_complex(ir, values, code_pointers);
           return;
       }
       else
@@ -5084,7 +5255,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     {
       if(compiled_function_simd_complex)
       {
-        compiled_function_simd_complex(ir,values);
+        compiled_function_simd_complex(ir, values, code_pointers);
         return;
       }
       else
@@ -337,7 +337,13 @@ namespace ngfem
     virtual Array<shared_ptr<CoefficientFunction>> InputCoefficientFunctions() const
     { return Array<shared_ptr<CoefficientFunction>>(); }
     virtual bool StoreUserData() const { return false; }
-
+    /// the node uses only mapped points and the element index, 
+    /// so it can be evaluated with SIMD lanes belonging to different elements
+    virtual bool ElementBatchable () const { return false; }
+    /// identifies the operation if the value depends only on the inputs
+    /// and the integration point; nodes with equal keys and equal inputs
+    /// are merged by the CompiledCF. Empty string: not comparable
+    virtual string StructuralKey () const { return ""; }
   };
 
   inline ostream & operator<< (ostream & ost, const CoefficientFunction & cf)
@@ -608,6 +614,8 @@ namespace ngfem
 
     using BASE::Evaluate;
     // virtual bool ElementwiseConstant () const override { return true; }
+    virtual bool ElementBatchable () const override { return true; }
+    virtual string StructuralKey () const override;
     
     virtual double Evaluate (const BaseMappedIntegrationPoint & ip) const override
     {
@@ -703,6 +711,7 @@ namespace ngfem
     ConstantCoefficientFunctionC() = default;
     ConstantCoefficientFunctionC (Complex aval);
     virtual ~ConstantCoefficientFunctionC ();
+    virtual bool ElementBatchable () const override { return true; }
 
     void DoArchive(Archive& ar) override
     {
@@ -734,6 +743,7 @@ namespace ngfem
     ParameterCoefficientFunction (double aval);
     ///
     virtual ~ParameterCoefficientFunction ();
+    virtual bool ElementBatchable () const override { return true; }
     ///
     void DoArchive(Archive& ar) override
     {
@@ -776,6 +786,7 @@ namespace ngfem
     virtual int NumRegions () override { return val.Size(); }
     ///
     virtual ~DomainConstantCoefficientFunction ();
+    virtual bool ElementBatchable () const override { return true; }
     ///
       using T_CoefficientFunction<DomainConstantCoefficientFunction, CoefficientFunctionNoDerivative>::Evaluate;
       using CoefficientFunction::Evaluate;
@@ -1175,6 +1186,10 @@ public:
         });
   }
 
+  virtual bool ElementBatchable () const override { return true; }
+  virtual string StructuralKey () const override
+  { return string(typeid(*this).name()) + " " + name; }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     c1->TraverseTree (func);
@@ -1380,6 +1395,10 @@ public:
     });
   }
 
+  virtual bool ElementBatchable () const override { return true; }
+  virtual string StructuralKey () const override
+  { return string(typeid(*this).name()) + " " + opname; }
+
   virtual void TraverseTree (const function<void(CoefficientFunction&)> & func) override
   {
     c1->TraverseTree (func);
@@ -0,0 +1,376 @@
+#include <fem.hpp>
+#include "h1hofetp.hpp"
+
+namespace ngfem
+{
+  // vertex coordinates of the reference quad/hex
+  static const int tp_vertex[8][3] =
+    { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 },
+      { 0, 0, 1 }, { 1, 0, 1 }, { 1, 1, 1 }, { 0, 1, 1 } };
+
+
+  /*
+    1D factors 1-x, x, x(1-x) E_k(2x-1), x(1-x) Q_k(2x-1), k <= p1d-2
+    and their derivatives in the points of a 1D rule.
+    The polynomials must match EdgeOrthoPol and QuadOrthoPol in h1hofe_impl.hpp
+  */
+  static void CalcShape1D (int p1d, const SIMD_IntegrationRule & ir1,
+                           FlatMatrix<SIMD<double>> shape,
+                           FlatMatrix<SIMD<double>> dshape)
+  {
+    for (size_t i = 0; i < ir1.Size(); i++)
+      {
+        AutoDiff<1,SIMD<double>> x(ir1[i](0), 0);
+        auto store = [&] (size_t nr, AutoDiff<1,SIMD<double>> val)
+          {
+            shape(nr, i) = val.Value();
+            dshape(nr, i) = val.DValue(0);
+          };
+
+        store (0, 1-x);
+        store (1, x);
+        if (p1d < 2) continue;
+
+        AutoDiff<1,SIMD<double>> xi = 2*x-1;
+        AutoDiff<1,SIMD<double>> bub = x*(1-x);
+        IntLegNoBubble::EvalMult (p1d-2, xi, bub,
+                                  SBLambda([&] (size_t nr, auto val)
+                                           { store (2+nr, val); }));
+        ChebyPolynomial::EvalMult (p1d-2, xi, bub,
+                                   SBLambda([&] (size_t nr, auto val)
+                                            { store (p1d+1+nr, val); }));
+      }
+  }
+
+
+  // 1D tables for all directions of a tensor-product rule
+  static void CalcShapesTP (int p1d, int dim, const SIMD_IntegrationRule * const * ir1,
+                            const size_t * offset, SIMD<double> * mem)
+  {
+    size_t n1 = 2*p1d;
+    for (int d = 0; d < dim; d++)
+      {
+        size_t n = ir1[d]->Size();
+        CalcShape1D (p1d, *ir1[d],
+                     FlatMatrix<SIMD<double>> (n1, n, mem+offset[d]),
+                     FlatMatrix<SIMD<double>> (n1, n, mem+offset[d]+n1*n));
+      }
+  }
+
+  // values or derivatives of the 1D factors as a (n1 x nip) double matrix
+  static SliceMatrix<double> ShapeTP (size_t n1, const SIMD_IntegrationRule & ir1,
+                                      bool deriv, SIMD<double> * mem)
+  {
+    size_t n = ir1.Size();
+    SIMD<double> * p = mem + (deriv ? n1*n : 0);
+    return SliceMatrix<double> (n1, ir1.GetNIP(), SIMD<double>::Size()*n, &p[0][0]);
+  }
+
+
+  template <ELEMENT_TYPE ET>
+  bool H1HighOrderFETP<ET> :: UseTP (const SIMD_IntegrationRule & ir) const
+  {
+    if (!ir.IsTP()) return false;
+    size_t nip = ir.GetIRX().GetNIP() * ir.GetIRY().GetNIP();
+    if constexpr (DIM == 3) nip *= ir.GetIRZ().GetNIP();
+    return nip == ir.GetNIP();
+  }
+
+  template <ELEMENT_TYPE ET>
+  int H1HighOrderFETP<ET> :: Order1D () const
+  {
+    int p = 1;
+    for (int i = 0; i < N_EDGE; i++)
+      p = max2 (p, int(order_edge[i]));
+    for (int i = 0; i < N_FACE; i++)
+      p = max2 (p, int(Max (order_face[i])));
+    if constexpr (DIM == 3)
+      p = max2 (p, int(Max (order_cell[0])));
+    return p;
+  }
+
+
+  /*
+    Same enumeration as H1HighOrderFE_Shape<ET_QUAD/ET_HEX>::T_CalcShape.
+    An oriented edge or face coordinate xi = -(2x-1) flips the sign of
+    the odd polynomials.
+   */
+  template <ELEMENT_TYPE ET> template <typename FUNC>
+  void H1HighOrderFETP<ET> :: IterateTensorDofs (int p1d, FUNC func) const
+  {
+    const int offe = 2, offq = p1d+1;
+    auto dir = [] (int v1, int v2)
+      {
+        for (int j = 0; j < DIM; j++)
+          if (tp_vertex[v1][j] != tp_vertex[v2][j]) return j;
+        return 0;
+      };
+    auto sign = [] (int k, bool flip) { return (flip && (k % 2)) ? -1.0 : 1.0; };
+
+    size_t ii = 0;
+    INT<DIM> ind;
+
+    for (int v = 0; v < N_VERTEX; v++)
+      {
+        for (int j = 0; j < DIM; j++) ind[j] = tp_vertex[v][j];
+        func (ii++, ind, 1.0);
+      }
+
+    for (int i = 0; i < N_EDGE; i++)
+      {
+        int p = order_edge[i];
+        if (p < 2) continue;
+
+        INT<2> e = this->GetVertexOrientedEdge (i);
+        int c = dir (e[0], e[1]);
+        bool flip = tp_vertex[e[1]][c] == 0;
+        for (int j = 0; j < DIM; j++) ind[j] = tp_vertex[e[0]][j];
+        for (int k = 0; k <= p-2; k++)
+          {
+            ind[c] = offe+k;
+            func (ii++, ind, sign(k, flip));
+          }
+      }
+
+    for (int i = 0; i < N_FACE; i++)
+      {
+        INT<2> p = order_face[i];
+        if (p[0] < 2 || p[1] < 2) continue;
+
+        INT<4> f = this->GetVertexOrientedFace (i);
+        int c1 = dir (f[0], f[1]);
+        int c2 = dir (f[0], f[3]);
+        bool flip1 = tp_vertex[f[0]][c1] == 0;
+        bool flip2 = tp_vertex[f[0]][c2] == 0;
+        for (int j = 0; j < DIM; j++) ind[j] = tp_vertex[f[0]][j];
+        for (int k = 0; k <= p[0]-2; k++)
+          for (int l = 0; l <= p[1]-2; l++)
+            {
+              ind[c1] = offq+k;
+              ind[c2] = offq+l;
+              func (ii++, ind, sign(k, flip1)*sign(l, flip2));
+            }
+      }
+
+    if constexpr (DIM == 3)
+      {
+        INT<3> p = order_cell[0];
+        if (p[0] >= 2 && p[1] >= 2 && p[2] >= 2)
+          for (int k = 0; k <= p[0]-2; k++)
+            for (int l = 0; l <= p[1]-2; l++)
+              for (int m = 0; m <= p[2]-2; m++)
+                func (ii++, INT<3> (offq+k, offq+l, offq+m), 1.0);
+      }
+  }
+
+
+  template <ELEMENT_TYPE ET>
+  void H1HighOrderFETP<ET> ::
+  EvaluateTP (const SIMD_IntegrationRule & ir, int dir,
+              BareSliceVector<> coefs, BareVector<SIMD<double>> values) const
+  {
+    static Timer t("H1TP evaluate");
+    ThreadRegionTimer reg(t, TaskManager::GetThreadId());
+
+    int p1d = Order1D();
+    size_t n1 = 2*p1d;
+
+    const SIMD_IntegrationRule * ir1[3] =
+      { &ir.GetIRX(), &ir.GetIRY(), DIM == 3 ? &ir.GetIRZ() : nullptr };
+    size_t offset[DIM+1] = { 0 };
+    for (int d = 0; d < DIM; d++)
+      offset[d+1] = offset[d] + 2*n1*ir1[d]->Size();
+    STACK_ARRAY(SIMD<double>, mem_shape, offset[DIM]);
+    CalcShapesTP (p1d, DIM, ir1, offset, mem_shape);
+    auto shape = [&] (int d) { return ShapeTP (n1, *ir1[d], d == dir, mem_shape+offset[d]); };
+
+    // dofs -> coefficient tensor of the 1D basis
+    STACK_ARRAY(double, mem_tcoefs, n1*n1*(DIM == 3 ? n1 : 1));
+    FlatVector<> tcoefs(n1*n1*(DIM == 3 ? n1 : 1), mem_tcoefs);
+    tcoefs = 0.0;
+    IterateTensorDofs (p1d, [&] (size_t nr, INT<DIM> ind, double sign)
+                       {
+                         size_t ii = ind[0];
+                         for (int j = 1; j < DIM; j++) ii = n1*ii + ind[j];
+                         tcoefs(ii) = sign * coefs(nr);
+                       });
+
+    values(ir.Size()-1) = 0.0;  // clear overhead
+
+    if constexpr (DIM == 2)
+      {
+        size_t nx = ir1[0]->GetNIP(), ny = ir1[1]->GetNIP();
+        STACK_ARRAY(double, mem1, n1*ny);
+        FlatMatrix<> temp1(n1, ny, mem1);
+        temp1 = FlatMatrix<> (n1, n1, &tcoefs(0)) * shape(1);
+        FlatMatrix<> mvalues(nx, ny, &values(0)[0]);
+        mvalues = Trans(shape(0)) * temp1;
+      }
+    else
+      {
+        size_t nx = ir1[0]->GetNIP(), ny = ir1[1]->GetNIP(), nz = ir1[2]->GetNIP();
+        STACK_ARRAY(double, mem1, n1*n1*nz);
+        FlatMatrix<> temp1(n1*n1, nz, mem1);
+        temp1 = FlatMatrix<> (n1*n1, n1, &tcoefs(0)) * shape(2);
+
+        STACK_ARRAY(double, mem2, n1*ny*nz);
+        FlatMatrix<> temp2(n1, ny*nz, mem2);
+        for (size_t ix = 0; ix < n1; ix++)
+          {
+            FlatMatrix<> temp2x(ny, nz, &temp2(ix,0));
+            temp2x = Trans(shape(1)) * temp1.Rows(ix*n1, (ix+1)*n1);
+          }
+
+        FlatMatrix<> mvalues(nx, ny*nz, &values(0)[0]);
+        mvalues = Trans(shape(0)) * temp2;
+      }
+  }
+
+
+  template <ELEMENT_TYPE ET>
+  void H1HighOrderFETP<ET> ::
+  AddTransTP (const SIMD_IntegrationRule & ir, int dir,
+              BareVector<SIMD<double>> values, BareSliceVector<> coefs) const
+  {
+    static Timer t("H1TP addtrans");
+    ThreadRegionTimer reg(t, TaskManager::GetThreadId());
+
+    int p1d = Order1D();
+    size_t n1 = 2*p1d;
+
+    const SIMD_IntegrationRule * ir1[3] =
+      { &ir.GetIRX(), &ir.GetIRY(), DIM == 3 ? &ir.GetIRZ() : nullptr };
+    size_t offset[DIM+1] = { 0 };
+    for (int d = 0; d < DIM; d++)
+      offset[d+1] = offset[d] + 2*n1*ir1[d]->Size();
+    STACK_ARRAY(SIMD<double>, mem_shape, offset[DIM]);
+    CalcShapesTP (p1d, DIM, ir1, offset, mem_shape);
+    auto shape = [&] (int d) { return ShapeTP (n1, *ir1[d], d == dir, mem_shape+offset[d]); };
+
+    STACK_ARRAY(double, mem_tcoefs, n1*n1*(DIM == 3 ? n1 : 1));
+    FlatVector<> tcoefs(n1*n1*(DIM == 3 ? n1 : 1), mem_tcoefs);
+
+    if constexpr (DIM == 2)
+      {
+        size_t nx = ir1[0]->GetNIP(), ny = ir1[1]->GetNIP();
+        FlatMatrix<> mvalues(nx, ny, &values(0)[0]);
+        STACK_ARRAY(double, mem1, n1*ny);
+        FlatMatrix<> temp1(n1, ny, mem1);
+        temp1 = shape(0) * mvalues;
+        FlatMatrix<> mtcoefs(n1, n1, &tcoefs(0));
+        mtcoefs = temp1 * Trans(shape(1));
+      }
+    else
+      {
+        size_t nx = ir1[0]->GetNIP(), ny = ir1[1]->GetNIP(), nz = ir1[2]->GetNIP();
+        FlatMatrix<> mvalues(nx, ny*nz, &values(0)[0]);
+        STACK_ARRAY(double, mem2, n1*ny*nz);
+        FlatMatrix<> temp2(n1, ny*nz, mem2);
+        temp2 = shape(0) * mvalues;
+
+        STACK_ARRAY(double, mem1, n1*n1*nz);
+        FlatMatrix<> temp1(n1*n1, nz, mem1);
+        for (size_t ix = 0; ix < n1; ix++)
+          {
+            FlatMatrix<> temp1x(n1, nz, &temp1(ix*n1,0));
+            FlatMatrix<> temp2x(ny, nz, &temp2(ix,0));
+            temp1x = shape(1) * temp2x;
+          }
+
+        FlatMatrix<> mtcoefs(n1*n1, n1, &tcoefs(0));
+        mtcoefs = temp1 * Trans(shape(2));
+      }
+
+    // coefficient tensor -> dofs
+    IterateTensorDofs (p1d, [&] (size_t nr, INT<DIM> ind, double sign)
+                       {
+                         size_t ii = ind[0];
+                         for (int j = 1; j < DIM; j++) ii = n1*ii + ind[j];
+                         coefs(nr) += sign * tcoefs(ii);
+                       });
+  }
+
+
+  template <ELEMENT_TYPE ET>
+  void H1HighOrderFETP<ET> ::
+  Evaluate (const SIMD_IntegrationRule & ir,
+            BareSliceVector<> coefs,
+            BareVector<SIMD<double>> values) const
+  {
+    if (UseTP (ir))
+      EvaluateTP (ir, -1, coefs, values);
+    else
+      TBASE::Evaluate (ir, coefs, values);
+  }
+
+  template <ELEMENT_TYPE ET>
+  void H1HighOrderFETP<ET> ::
+  AddTrans (const SIMD_IntegrationRule & ir,
+            BareVector<SIMD<double>> values,
+            BareSliceVector<> coefs) const
+  {
+    if (UseTP (ir))
+      AddTransTP (ir, -1, values, coefs);
+    else
+      TBASE::AddTrans (ir, values, coefs);
+  }
+
+  template <ELEMENT_TYPE ET>
+  void H1HighOrderFETP<ET> ::
+  EvaluateGrad (const SIMD_IntegrationRule & ir,
+                BareSliceVector<> coefs,
+                BareSliceMatrix<SIMD<double>> values) const
+  {
+    if (!UseTP (ir))
+      {
+        TBASE::EvaluateGrad (ir, coefs, values);
+        return;
+      }
+    for (int j = 0; j < DIM; j++)
+      EvaluateTP (ir, j, coefs, values.Row(j));
+  }
+
+  template <ELEMENT_TYPE ET>
+  void H1HighOrderFETP<ET> ::
+  EvaluateGrad (const SIMD_BaseMappedIntegrationRule & mir,
+                BareSliceVector<> coefs,
+                BareSliceMatrix<SIMD<double>> values) const
+  {
+    auto & ir = mir.IR();
+    if (!UseTP (ir) || mir.DimSpace() != DIM)
+      {
+        TBASE::EvaluateGrad (mir, coefs, values);
+        return;
+      }
+    for (int j = 0; j < DIM; j++)
+      EvaluateTP (ir, j, coefs, values.Row(j));
+    mir.TransformGradient (values);
+  }
+
+  template <ELEMENT_TYPE ET>
+  void H1HighOrderFETP<ET> ::
+  AddGradTrans (const SIMD_BaseMappedIntegrationRule & mir,
+                BareSliceMatrix<SIMD<double>> values,
+                BareSliceVector<> coefs) const
+  {
+    auto & ir = mir.IR();
+    if (!UseTP (ir) || mir.DimSpace() != DIM)
+      {
+        TBASE::AddGradTrans (mir, values, coefs);
+        return;
+      }
+
+    // pull back to the reference element, don't modify the input
+    STACK_ARRAY(SIMD<double>, mem_refvalues, DIM*ir.Size());
+    FlatMatrix<SIMD<double>> refvalues(DIM, ir.Size(), mem_refvalues);
+    refvalues = values.AddSize(DIM, ir.Size());
+    mir.TransformGradientTrans (refvalues);
+
+    for (int j = 0; j < DIM; j++)
+      AddTransTP (ir, j, refvalues.Row(j), coefs);
+  }
+
+
+  template class H1HighOrderFETP<ET_QUAD>;
+  template class H1HighOrderFETP<ET_HEX>;
+}
@@ -0,0 +1,86 @@
+#ifndef FILE_H1HOFETP
+#define FILE_H1HOFETP
+
+namespace ngfem
+{
+
+  /**
+     H1 high order quads and hexes with sum-factorization on
+     tensor-product integration rules.
+
+     Every H1 shape function on a tensor-product element is a product
+     of 1D factors from the list
+
+       1-x, x, x(1-x) E_k(2x-1), x(1-x) Q_k(2x-1)
+
+     (E = edge polynomials, Q = quad/cell polynomials of h1hofe_impl.hpp),
+     up to a sign from the vertex orientation. The dofs are mapped to
+     the coefficient tensor of this 1D basis, and evaluation is done
+     one direction after the other. For order p this costs O(p^{D+1})
+     per element instead of O(p^{2D}).
+   */
+  template <ELEMENT_TYPE ET>
+  class H1HighOrderFETP : public H1HighOrderFE<ET>
+  {
+    typedef H1HighOrderFE<ET> TBASE;
+    enum { DIM = ET_trait<ET>::DIM };
+
+    using TBASE::order_edge;
+    using TBASE::order_face;
+    using TBASE::order_cell;
+    using TBASE::N_VERTEX;
+    using TBASE::N_EDGE;
+    using TBASE::N_FACE;
+
+  public:
+    using TBASE::TBASE;
+
+    using TBASE::Evaluate;
+    using TBASE::AddTrans;
+    using TBASE::EvaluateGrad;
+    using TBASE::AddGradTrans;
+
+    virtual void Evaluate (const SIMD_IntegrationRule & ir,
+                           BareSliceVector<> coefs,
+                           BareVector<SIMD<double>> values) const override;
+
+    virtual void AddTrans (const SIMD_IntegrationRule & ir,
+                           BareVector<SIMD<double>> values,
+                           BareSliceVector<> coefs) const override;
+
+    virtual void EvaluateGrad (const SIMD_IntegrationRule & ir,
+                               BareSliceVector<> coefs,
+                               BareSliceMatrix<SIMD<double>> values) const override;
+
+    virtual void EvaluateGrad (const SIMD_BaseMappedIntegrationRule & mir,
+                               BareSliceVector<> coefs,
+                               BareSliceMatrix<SIMD<double>> values) const override;
+
+    virtual void AddGradTrans (const SIMD_BaseMappedIntegrationRule & mir,
+                               BareSliceMatrix<SIMD<double>> values,
+                               BareSliceVector<> coefs) const override;
+
+  protected:
+    /// true if ir is a tensor-product rule with matching number of points
+    bool UseTP (const SIMD_IntegrationRule & ir) const;
+
+    /// highest polynomial order in any direction
+    int Order1D () const;
+
+    /// calls func (dofnr, INT<DIM> tensor-index, sign) for all dofs
+    template <typename FUNC>
+    void IterateTensorDofs (int p1d, FUNC func) const;
+
+    /// values (or derivative if dir>=0) in reference coordinates
+    void EvaluateTP (const SIMD_IntegrationRule & ir, int dir,
+                     BareSliceVector<> coefs, BareVector<SIMD<double>> values) const;
+
+    void AddTransTP (const SIMD_IntegrationRule & ir, int dir,
+                     BareVector<SIMD<double>> values, BareSliceVector<> coefs) const;
+  };
+
+  extern template class H1HighOrderFETP<ET_QUAD>;
+  extern template class H1HighOrderFETP<ET_HEX>;
+}
+
+#endif
@@ -208,6 +208,16 @@ namespace ngfem
     CalcElementMatrix(fel, eltrans, helmat, lh);
     elmat += helmat;
   }
+
+  void BilinearFormIntegrator ::
+  CalcElementMatrixBatchAdd (const FiniteElement & fel,
+                             FlatArray<const ElementTransformation*> trafos,
+                             FlatArray<FlatMatrix<double>> elmats,
+                             LocalHeap & lh) const
+  {
+    for (size_t i = 0; i < trafos.Size(); i++)
+      CalcElementMatrixAdd (fel, *trafos[i], elmats[i], lh);
+  }
   
 
 
@@ -329,6 +329,21 @@ namespace ngfem
                             FlatMatrix<Complex> elmat,
                             LocalHeap & lh) const;
     
+    /// can element matrices be computed for batches of elements ?
+    virtual bool SupportsElementBatch () const { return false; }
+
+    /**
+       Computes element matrices for a batch of elements.
+       All elements share the same finite element (type, order and 
+       vertex ordering) and the same element index.
+       Adds the element matrix of element i to elmats[i]
+    */
+    virtual void
+      CalcElementMatrixBatchAdd (const FiniteElement & fel,
+                                 FlatArray<const ElementTransformation*> trafos,
+                                 FlatArray<FlatMatrix<double>> elmats,
+                                 LocalHeap & lh) const;
+
 
     
     virtual void
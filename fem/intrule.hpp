@@ -1626,6 +1626,7 @@ namespace ngstd
     // int GetIPNr() const { return ip.Nr(); }
 
     void SetMeasure (SIMD<double> _measure) { measure = _measure; }
+    void SetJacobiDet (SIMD<double> _det) { det = _det; }
     SIMD<double> GetMeasure() const { return measure; }
     SIMD<double> GetWeight() const { return measure * ip.Weight(); }
     SIMD<double> GetJacobiDet() const { return det; }
@@ -2075,6 +2075,18 @@ alpha : double
                            
   m.def("GenerateL2ElementCode", &GenerateL2ElementCode);
 
+  m.def("SetCodeCacheDirectory", &SetCodeCacheDirectory, py::arg("dir"),
+        "directory for libraries of compiled CoefficientFunctions, reused across runs");
+  m.def("GetCodeCacheDirectory", &GetCodeCacheDirectory);
+  m.def("CodeCacheStatistics", [] ()
+        {
+          auto stats = GetCodeCacheStatistics();
+          py::dict res;
+          res["hits"] = stats.hits;
+          res["misses"] = stats.misses;
+          return res;
+        }, "number of cache hits and misses of compiled CoefficientFunctions");
+
 }
 
 
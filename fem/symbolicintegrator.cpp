@@ -923,6 +923,15 @@ namespace ngfem
     elementwise_constant = cf -> ElementwiseConstant();
     cout << IM(6) << "element-wise constant = " << elementwise_constant << endl;
 
+    element_batch = vb == VOL && element_vb == VOL && !cf->IsComplex();
+    cf->TraverseTree
+      ( [&] (CoefficientFunction & nodecf)
+        {
+          if (!nodecf.ElementBatchable())
+            element_batch = false;
+        });
+    cout << IM(6) << "element batches = " << element_batch << endl;
+
     // find non-zeros
     int cnttest = 0, cnttrial = 0;
     for (auto proxy : trial_proxies)
@@ -1668,6 +1677,189 @@ namespace ngfem
   }
 
 
+  void 
+  SymbolicBilinearFormIntegrator ::
+  CalcElementMatrixBatchAdd (const FiniteElement & fel,
+                             FlatArray<const ElementTransformation*> trafos,
+                             FlatArray<FlatMatrix<double>> elmats,
+                             LocalHeap & lh) const
+  {
+    constexpr size_t W = SIMD<double>::Size();
+    size_t first = 0;
+
+    bool batch = SupportsElementBatch() && typeid(fel) != typeid(const MixedFiniteElement&);
+    for (auto trafo : trafos)
+      if (trafo->IsComplex() || trafo->SpaceDim() != fel.Dim())
+        batch = false;
+    
+    if (batch)
+      try
+        {
+          for ( ; first < trafos.Size(); first += W)
+            {
+              size_t next = min2(first+W, trafos.Size());
+              switch (fel.Dim())
+                {
+                case 1:
+                  T_CalcElementMatrixBatchAdd<1> (fel, trafos.Range(first, next), elmats.Range(first, next), lh);
+                  break;
+                case 2:
+                  T_CalcElementMatrixBatchAdd<2> (fel, trafos.Range(first, next), elmats.Range(first, next), lh);
+                  break;
+                case 3:
+                  T_CalcElementMatrixBatchAdd<3> (fel, trafos.Range(first, next), elmats.Range(first, next), lh);
+                  break;
+                default:
+                  throw ExceptionNOSIMD ("no element batches for dim = "+ToString(fel.Dim()));
+                }
+            }
+          return;
+        }
+      catch (ExceptionNOSIMD e)
+        {
+          cout << IM(6) << e.What() << endl
+               << "switching to scalar evaluation" << endl;
+          simd_evaluate = false;
+        }
+
+    // remaining elements one by one
+    for (size_t i = first; i < trafos.Size(); i++)
+      {
+        HeapReset hr(lh);
+        FlatMatrix<double> elmat(elmats[i].Height(), elmats[i].Width(), lh);
+        CalcElementMatrix (fel, *trafos[i], elmat, lh);
+        elmats[i] += elmat;
+      }
+  }
+
+  
+  template <int D>
+  void SymbolicBilinearFormIntegrator ::
+  T_CalcElementMatrixBatchAdd (const FiniteElement & fel,
+                               FlatArray<const ElementTransformation*> trafos,
+                               FlatArray<FlatMatrix<double>> elmats,
+                               LocalHeap & lh) const
+  {
+    // the SIMD lanes run over up to W elements, the integration points are 
+    // processed one after the other. All elements share fel.
+    static Timer t("SymbolicBFI::CalcElementMatrixBatchAdd", 2);
+    ThreadRegionTimer reg(t, TaskManager::GetThreadId());
+
+    constexpr size_t W = SIMD<double>::Size();
+    HeapReset hr(lh);
+    size_t nel = trafos.Size();
+    
+    const IntegrationRule & ir = GetIntegrationRule (fel, lh);
+    size_t nip = ir.Size();
+
+    SIMD_IntegrationRule simd_ir(nip*W, lh);
+    for (size_t i = 0; i < nip; i++)
+      simd_ir[i] = [&] (int j) { return ir[i]; };
+
+    // unused lanes repeat the last element
+    FlatArray<MappedIntegrationRule<D,D>*> mirs(W, lh);
+    for (size_t j = 0; j < W; j++)
+      mirs[j] = j < nel ?
+        static_cast<MappedIntegrationRule<D,D>*> (&(*trafos[j])(ir, lh)) : mirs[nel-1];
+    
+    SIMD_MappedIntegrationRule<D,D> & mir =
+      *new (lh) SIMD_MappedIntegrationRule<D,D> (simd_ir, *trafos[0], -1, lh);
+    for (size_t i = 0; i < nip; i++)
+      {
+        for (int k = 0; k < D; k++)
+          {
+            mir[i].Point()(k) = [&] (int j) { return (*mirs[j])[i].GetPoint()(k); };
+            for (int l = 0; l < D; l++)
+              mir[i].Jacobian()(k,l) = [&] (int j) { return (*mirs[j])[i].GetJacobian()(k,l); };
+          }
+        mir[i].Compute();
+      }
+
+    ProxyUserData ud;
+    const_cast<ElementTransformation*>(trafos[0])->userdata = &ud;
+
+    // element matrices are summed up here, and added only if SIMD evaluation succeeds
+    size_t h = elmats[0].Height(), w = elmats[0].Width();
+    FlatMatrix<SIMD<double>> sum_elmat(h, w, lh);
+    sum_elmat = SIMD<double>(0.0);
+    
+    for (size_t k1nr : Range(trial_proxies))
+      for (size_t l1nr : Range(test_proxies))
+        {
+          auto proxy1 = trial_proxies[k1nr];
+          auto proxy2 = test_proxies[l1nr];
+          size_t k1 = trial_cum[k1nr], l1 = test_cum[l1nr];
+          size_t dim_proxy1 = proxy1->Dimension();
+          size_t dim_proxy2 = proxy2->Dimension();
+
+          size_t tt_pair = l1nr*trial_proxies.Size()+k1nr;
+          if (!nonzeros_proxies(tt_pair)) continue;
+          bool is_diagonal = diagonal_proxies(tt_pair);
+          bool samediffop = same_diffops(tt_pair);
+          
+          HeapReset hr(lh);
+          FlatMatrix<SIMD<double>> proxyvalues(dim_proxy1*dim_proxy2, nip, lh);
+          for (size_t k = 0, kk = 0; k < dim_proxy1; k++)
+            for (size_t l = 0; l < dim_proxy2; l++, kk++)
+              if (nonzeros(l1+l, k1+k) && (!is_diagonal || k == l))
+                {
+                  ud.trialfunction = proxy1;
+                  ud.trial_comp = k;
+                  ud.testfunction = proxy2;
+                  ud.test_comp = l;
+                  cf -> Evaluate (mir, proxyvalues.Rows(kk,kk+1));
+                  for (size_t i = 0; i < nip; i++)
+                    proxyvalues(kk,i) *= mir[i].GetWeight();
+                }
+
+          IntRange r1 = proxy1->Evaluator()->UsedDofs(fel);
+          IntRange r2 = proxy2->Evaluator()->UsedDofs(fel);
+          
+          FlatMatrix<SIMD<double>> bbmat1(w*dim_proxy1, nip, lh);
+          FlatMatrix<SIMD<double>> bbmat2 = samediffop ?
+            bbmat1 : FlatMatrix<SIMD<double>>(h*dim_proxy2, nip, lh);
+          proxy1->Evaluator()->CalcMatrix(fel, mir, bbmat1);
+          if (!samediffop)
+            proxy2->Evaluator()->CalcMatrix(fel, mir, bbmat2);
+
+          // bdbmat1 = D * B1
+          FlatMatrix<SIMD<double>> bdbmat1(w*dim_proxy2, nip, lh);
+          FlatMatrix<SIMD<double>> hbdbmat1(w, dim_proxy2*nip, &bdbmat1(0,0));
+          FlatMatrix<SIMD<double>> hbbmat2(h, dim_proxy2*nip, &bbmat2(0,0));
+          hbdbmat1.Rows(r1) = SIMD<double>(0.0);
+          for (size_t j = 0; j < dim_proxy2; j++)
+            for (size_t k = 0; k < dim_proxy1; k++)
+              if (nonzeros(l1+j, k1+k) && (!is_diagonal || k == j))
+                {
+                  auto proxyvalues_jk = proxyvalues.Row(k*dim_proxy2+j);
+                  auto bbmat1_k = bbmat1.RowSlice(k, dim_proxy1).Rows(r1);
+                  auto bdbmat1_j = bdbmat1.RowSlice(j, dim_proxy2).Rows(r1);
+                  for (size_t i = 0; i < nip; i++)
+                    bdbmat1_j.Col(i).AddSize(r1.Size()) += proxyvalues_jk(i) * bbmat1_k.Col(i);
+                }
+
+          // element-wise B2^T * (D B1), lanes are independent element matrices
+          bool symmetric = samediffop && is_diagonal;
+          for (size_t i : r2)
+            for (size_t j : r1)
+              {
+                if (symmetric && j > i) break;
+                SIMD<double> sum(0.0);
+                for (size_t k = 0; k < hbbmat2.Width(); k++)
+                  sum += hbbmat2(i,k) * hbdbmat1(j,k);
+                sum_elmat(i,j) += sum;
+                if (symmetric && j != i)
+                  sum_elmat(j,i) += sum;
+              }
+        }
+
+    for (size_t e = 0; e < nel; e++)
+      for (size_t i = 0; i < h; i++)
+        for (size_t j = 0; j < w; j++)
+          elmats[e](i,j) += sum_elmat(i,j)[e];
+  }
+
+
   
 
   template <typename SCAL, typename SCAL_SHAPES, typename SCAL_RES>
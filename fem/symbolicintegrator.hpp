@@ -216,6 +216,8 @@ public:
   */
   
   // virtual bool ElementwiseConstant () const  override{ return true; }
+  // in matrix assembly proxies are just unit vectors
+  virtual bool ElementBatchable () const override { return true; }
 
   NGS_DLL_HEADER virtual void NonZeroPattern (const class ProxyUserData & ud,
                                               FlatVector<bool> nonzero,
@@ -621,6 +623,7 @@ public:
     Matrix<bool> diagonal_proxies; // do proxies interact diagonally ?
     Matrix<bool> same_diffops; // are diffops the same ? 
     bool elementwise_constant;
+    bool element_batch;  // SIMD lanes may run over elements
 
     int trial_difforder, test_difforder;
     bool is_symmetric;
@@ -672,6 +675,21 @@ public:
                                  FlatMatrix<SCAL_RES> elmat,
                                  LocalHeap & lh) const;
 
+    virtual bool SupportsElementBatch () const override
+    { return element_batch && simd_evaluate; }
+
+    NGS_DLL_HEADER virtual void
+    CalcElementMatrixBatchAdd (const FiniteElement & fel,
+                               FlatArray<const ElementTransformation*> trafos,
+                               FlatArray<FlatMatrix<double>> elmats,
+                               LocalHeap & lh) const override;
+
+    template <int D>
+    void T_CalcElementMatrixBatchAdd (const FiniteElement & fel,
+                                      FlatArray<const ElementTransformation*> trafos,
+                                      FlatArray<FlatMatrix<double>> elmats,
+                                      LocalHeap & lh) const;
+
     template <typename SCAL, typename SCAL_SHAPES, typename SCAL_RES>
     void T_CalcElementMatrixEBAdd (const FiniteElement & fel,
                                    const ElementTransformation & trafo, 
@@ -160,6 +160,18 @@ namespace ngla
     // throw Exception(string("MultHermitianAdd not overloaded for type ")+typeid(*this).name());
   }
   
+  void BaseMatrix :: Mult (const MultiVector & x, MultiVector & y) const
+  {
+    y.SetScalar (0.0);
+    MultAdd (1, x, y);
+  }
+
+  void BaseMatrix :: MultAdd (double s, const MultiVector & x, MultiVector & y) const
+  {
+    for (size_t i = 0; i < x.Size(); i++)
+      MultAdd (s, *x[i], *y[i]);
+  }
+
    // to split mat x vec for symmetric matrices
   void BaseMatrix :: MultAdd1 (double s, const BaseVector & x, BaseVector & y,
 			       const BitArray * ainner,
@@ -174,6 +186,12 @@ namespace ngla
   {
     ;
   }
+
+  bool BaseMatrix :: MultAddRows (double s, const BaseVector & x, BaseVector & y,
+                                  FlatArray<int> rows) const
+  {
+    return false;
+  }
   
 
 
@@ -286,6 +304,8 @@ namespace ngla
       case MUMPS:           return "mumps";
       case MASTERINVERSE:   return "masterinverse";
       case UMFPACK:         return "umfpack";
+      case SPARSECHOLESKY_ND: return "sparsecholesky_nd";
+      case SPARSECHOLESKY_MIXED: return "sparsecholesky_mixed";
       }
     return "";
   }
@@ -13,7 +13,7 @@ namespace ngla
 
 
   // sets the solver which is used for InverseMatrix
-  enum INVERSETYPE { PARDISO, PARDISOSPD, SPARSECHOLESKY, SUPERLU, SUPERLU_DIST, MUMPS, MASTERINVERSE, UMFPACK };
+  enum INVERSETYPE { PARDISO, PARDISOSPD, SPARSECHOLESKY, SUPERLU, SUPERLU_DIST, MUMPS, MASTERINVERSE, UMFPACK, SPARSECHOLESKY_ND, SPARSECHOLESKY_MIXED };
   extern string GetInverseName (INVERSETYPE type);
 
   /**
@@ -108,6 +108,11 @@ namespace ngla
    /// y += s Trans(matrix) * x
     virtual void MultConjTransAdd (Complex s, const BaseVector & x, BaseVector & y) const;
 
+    /// y[i] = matrix * x[i] for all vectors
+    virtual void Mult (const MultiVector & x, MultiVector & y) const;
+    /// y[i] += s matrix * x[i], blocked matrices read their data once for several vectors
+    virtual void MultAdd (double s, const MultiVector & x, MultiVector & y) const;
+
 
 
 
@@ -124,6 +129,11 @@ namespace ngla
 			   const BitArray * ainner = NULL,
 			   const Array<int> * acluster = NULL) const;
 
+    /// y += s matrix * x only for the given rows, other rows of y are not touched.
+    /// returns false if the matrix does not support row-wise products
+    virtual bool MultAddRows (double s, const BaseVector & x, BaseVector & y,
+                              FlatArray<int> rows) const;
+
 
     void SetParallelDofs (shared_ptr<ParallelDofs> pardofs) { paralleldofs = pardofs; }
     shared_ptr<ParallelDofs> GetParallelDofs () const { return paralleldofs; }
@@ -169,6 +179,7 @@ namespace ngla
     virtual ~S_BaseMatrix ();
     virtual bool IsComplex() const { return true; }
     
+    using BaseMatrix::MultAdd;
     /// calls MultAdd (Complex s);
     virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const;
     /// must be overloaded
@@ -256,6 +267,8 @@ namespace ngla
     virtual AutoVector CreateRowVector () const override { return bm.CreateColVector(); }
     virtual AutoVector CreateColVector () const override { return bm.CreateRowVector(); }
 
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     virtual void Mult (const BaseVector & x, BaseVector & y) const override
     {
       bm.MultTrans (x, y);
@@ -317,6 +330,8 @@ namespace ngla
     virtual AutoVector CreateRowVector () const override { return spbm->CreateColVector(); }
     virtual AutoVector CreateColVector () const override { return spbm->CreateRowVector(); }
 
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     virtual void Mult (const BaseVector & x, BaseVector & y) const override
     {
       y = 0.0;
@@ -389,6 +404,8 @@ namespace ngla
     virtual AutoVector CreateRowVector () const override { return bmb.CreateRowVector(); }
     virtual AutoVector CreateColVector () const override { return bma.CreateColVector(); }
     
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     ///
     virtual void Mult (const BaseVector & x, BaseVector & y) const override
     {
@@ -491,6 +508,8 @@ namespace ngla
         }
     }
 
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     virtual void Mult (const BaseVector & x, BaseVector & y) const override
     {
       static Timer t("SumMatrix::Mult"); RegionTimer reg(t);
@@ -576,6 +595,7 @@ namespace ngla
       : bm(*aspbm), spbm(aspbm), scale(ascale) { ; }
     virtual bool IsComplex() const override
     { return bm.IsComplex() || typeid(TSCAL)==typeid(Complex); } 
+    using BaseMatrix::MultAdd;
     ///
     virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override
     {
@@ -635,6 +655,8 @@ namespace ngla
       : has_format(true), size(asize), is_complex(ais_complex) { ; }
     
     virtual bool IsComplex() const override { return is_complex; }
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     ///
     virtual void Mult (const BaseVector & x, BaseVector & y) const override
     {
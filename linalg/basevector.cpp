@@ -182,6 +182,31 @@ namespace ngla
       InnerProduct (v2, conjugate);
   }
 
+  void BaseVector :: MultiInnerProductD (FlatArray<const BaseVector*> basis, FlatVector<double> res) const
+  {
+    for (size_t i = 0; i < basis.Size(); i++)
+      res(i) = basis[i]->InnerProductD (*this);
+  }
+
+  void BaseVector :: MultiInnerProductC (FlatArray<const BaseVector*> basis, FlatVector<Complex> res,
+                                         bool conjugate) const
+  {
+    for (size_t i = 0; i < basis.Size(); i++)
+      res(i) = basis[i]->InnerProductC (*this, conjugate);
+  }
+
+  void BaseVector :: MultiAdd (FlatVector<double> c, FlatArray<const BaseVector*> basis)
+  {
+    for (size_t i = 0; i < basis.Size(); i++)
+      Add (c(i), *basis[i]);
+  }
+
+  void BaseVector :: MultiAdd (FlatVector<Complex> c, FlatArray<const BaseVector*> basis)
+  {
+    for (size_t i = 0; i < basis.Size(); i++)
+      Add (c(i), *basis[i]);
+  }
+
 
   AutoVector BaseVector ::Range (size_t begin, size_t end) const
   {
@@ -346,6 +371,39 @@ namespace ngla
     return InnerProduct(v2, conjugate);
   }
 
+  template <class SCAL>
+  void S_BaseVector<SCAL> :: MultiInnerProductD (FlatArray<const BaseVector*> basis,
+                                                 FlatVector<double> res) const
+  {
+    LocalMultiInnerProduct<double> (basis, *this, res, false);
+  }
+
+  template <class SCAL>
+  void S_BaseVector<SCAL> :: MultiInnerProductC (FlatArray<const BaseVector*> basis,
+                                                 FlatVector<Complex> res, bool conjugate) const
+  {
+    LocalMultiInnerProduct<Complex> (basis, *this, res, conjugate);
+  }
+
+  template <class SCAL>
+  void S_BaseVector<SCAL> :: MultiAdd (FlatVector<double> c, FlatArray<const BaseVector*> basis)
+  {
+    if (IsComplex())
+      {
+        Vector<Complex> cc(c.Size());
+        cc = c;
+        LocalMultiAdd<Complex> (*this, cc, basis);
+      }
+    else
+      LocalMultiAdd<double> (*this, c, basis);
+  }
+
+  template <class SCAL>
+  void S_BaseVector<SCAL> :: MultiAdd (FlatVector<Complex> c, FlatArray<const BaseVector*> basis)
+  {
+    LocalMultiAdd<Complex> (*this, c, basis);
+  }
+
 
 
 
@@ -841,6 +899,265 @@ namespace ngla
   }
   
   
+  MultiVector :: MultiVector (shared_ptr<BaseVector> v, size_t cnt)
+    : refvec(v)
+  {
+    Extend (cnt);
+  }
+
+  MultiVector :: MultiVector (const Array<shared_ptr<BaseVector>> & avecs)
+    : vecs(avecs)
+  {
+    if (!vecs.Size())
+      throw Exception ("MultiVector needs at least one vector");
+    refvec = vecs[0];
+  }
+
+  void MultiVector :: Extend (size_t nr)
+  {
+    for (size_t i = 0; i < nr; i++)
+      {
+        shared_ptr<BaseVector> v = refvec->CreateVector();
+        vecs.Append (v);
+      }
+  }
+
+  void MultiVector :: SetScalar (double s)
+  {
+    for (auto & v : vecs)
+      v->SetScalar (s);
+  }
+
+  void MultiVector :: Set (const MultiVector & v2)
+  {
+    for (size_t i : ngstd::Range(vecs))
+      vecs[i]->Set (1.0, *v2[i]);
+  }
+
+  void MultiVector :: Add (double s, const MultiVector & v2)
+  {
+    for (size_t i : ngstd::Range(vecs))
+      vecs[i]->Add (s, *v2[i]);
+  }
+
+
+  static bool AllSequential (const MultiVector & v)
+  {
+    for (size_t i = 0; i < v.Size(); i++)
+      if (v[i]->GetParallelStatus() != NOT_PARALLEL)
+        return false;
+    return true;
+  }
+
+  // row-blocks small enough such that all vectors of the block stay in cache
+  constexpr size_t MULTIVEC_BLOCK = 1024;
+
+  template <typename SCAL>
+  static void MultiVecAdd (MultiVector & y, const MultiVector & x, FlatMatrix<SCAL> a)
+  {
+    if (!AllSequential(x) || !AllSequential(y))
+      {
+        for (size_t j = 0; j < y.Size(); j++)
+          for (size_t i = 0; i < x.Size(); i++)
+            if (a(i,j) != SCAL(0.0))
+              y[j]->Add (a(i,j), *x[i]);
+        return;
+      }
+
+    size_t n = x[0]->FV<SCAL>().Size();
+    ParallelForRange (n, [&] (IntRange r)
+                      {
+                        for (size_t first = r.First(); first < r.Next(); first += MULTIVEC_BLOCK)
+                          {
+                            IntRange rb(first, min2(first+MULTIVEC_BLOCK, r.Next()));
+                            for (size_t j = 0; j < y.Size(); j++)
+                              {
+                                auto fy = y[j]->FV<SCAL>().Range(rb);
+                                for (size_t i = 0; i < x.Size(); i++)
+                                  fy += a(i,j) * x[i]->FV<SCAL>().Range(rb);
+                              }
+                          }
+                      }, TasksPerThread(4));
+  }
+
+  template <typename SCAL, typename FUNC>
+  static Matrix<SCAL> MultiVecInnerProduct (const MultiVector & x, const MultiVector & y,
+                                            bool conjugate, FUNC pairwise)
+  {
+    Matrix<SCAL> res(x.Size(), y.Size());
+    if (!AllSequential(x) || !AllSequential(y))
+      {
+        for (size_t i = 0; i < x.Size(); i++)
+          for (size_t j = 0; j < y.Size(); j++)
+            res(i,j) = pairwise (*x[i], *y[j]);
+        return res;
+      }
+
+    res = SCAL(0.0);
+    mutex m;
+    size_t n = x[0]->FV<SCAL>().Size();
+    ParallelForRange (n, [&] (IntRange r)
+                      {
+                        Matrix<SCAL> hres(x.Size(), y.Size());
+                        hres = SCAL(0.0);
+                        for (size_t first = r.First(); first < r.Next(); first += MULTIVEC_BLOCK)
+                          {
+                            IntRange rb(first, min2(first+MULTIVEC_BLOCK, r.Next()));
+                            for (size_t i = 0; i < x.Size(); i++)
+                              {
+                                auto fx = x[i]->FV<SCAL>().Range(rb);
+                                for (size_t j = 0; j < y.Size(); j++)
+                                  {
+                                    auto fy = y[j]->FV<SCAL>().Range(rb);
+                                    SCAL sum = 0.0;
+                                    if (conjugate)
+                                      for (size_t k = 0; k < fx.Size(); k++)
+                                        sum += Conj(fx(k)) * fy(k);
+                                    else
+                                      for (size_t k = 0; k < fx.Size(); k++)
+                                        sum += fx(k) * fy(k);
+                                    hres(i,j) += sum;
+                                  }
+                              }
+                          }
+                        lock_guard<mutex> guard(m);
+                        res += hres;
+                      }, TasksPerThread(4));
+    return res;
+  }
+
+  void MultiVector :: Add (const MultiVector & x, FlatMatrix<double> a)
+  {
+    MultiVecAdd<double> (*this, x, a);
+  }
+
+  void MultiVector :: Add (const MultiVector & x, FlatMatrix<Complex> a)
+  {
+    MultiVecAdd<Complex> (*this, x, a);
+  }
+
+  Matrix<double> MultiVector :: InnerProductD (const MultiVector & v2) const
+  {
+    return MultiVecInnerProduct<double>
+      (*this, v2, false,
+       [] (const BaseVector & a, const BaseVector & b) { return a.InnerProductD(b); });
+  }
+
+  Matrix<Complex> MultiVector :: InnerProductC (const MultiVector & v2, bool conjugate) const
+  {
+    return MultiVecInnerProduct<Complex>
+      (*this, v2, conjugate,
+       [conjugate] (const BaseVector & a, const BaseVector & b) { return a.InnerProductC(b, conjugate); });
+  }
+
+  Array<double> MultiVector :: L2Norm () const
+  {
+    Array<double> norms(Size());
+    for (size_t i = 0; i < Size(); i++)
+      norms[i] = vecs[i]->L2Norm();
+    return norms;
+  }
+
+
+  template <typename SCAL>
+  static void GetBasisPointers (FlatArray<const BaseVector*> basis, const BaseVector & y,
+                                FlatArray<SCAL*> fx)
+  {
+    if (y.IsComplex() != is_same<SCAL,Complex>::value)
+      throw Exception ("MultiInnerProduct/MultiAdd: scalar type does not match the vector");
+    size_t n = y.FV<SCAL>().Size();
+    for (size_t i = 0; i < basis.Size(); i++)
+      {
+        FlatVector<SCAL> fxi = basis[i]->FV<SCAL>();
+        if (fxi.Size() != n)
+          throw Exception ("MultiInnerProduct/MultiAdd: basis vector " + ToString(i) +
+                           " has size " + ToString(fxi.Size()) + ", expected " + ToString(n));
+        fx[i] = fxi.Addr(0);
+      }
+  }
+
+  template <typename SCAL>
+  void LocalMultiInnerProduct (FlatArray<const BaseVector*> basis, const BaseVector & y,
+                               FlatVector<SCAL> res, bool conjugate)
+  {
+    static Timer t("BaseVector::MultiInnerProduct"); RegionTimer reg(t);
+
+    size_t m = basis.Size();
+    res = SCAL(0.0);
+    if (m == 0) return;
+
+    Array<SCAL*> fx(m);
+    GetBasisPointers<SCAL> (basis, y, fx);
+    FlatVector<SCAL> fy = y.FV<SCAL>();
+    t.AddFlops (m * fy.Size());
+
+    mutex mut;
+    ParallelForRange (fy.Size(), [&] (IntRange r)
+                      {
+                        Vector<SCAL> hres(m);
+                        hres = SCAL(0.0);
+                        for (size_t first = r.First(); first < r.Next(); first += MULTIVEC_BLOCK)
+                          {
+                            IntRange rb(first, min2(first+MULTIVEC_BLOCK, r.Next()));
+                            // the block of y stays in cache while the basis is streamed
+                            for (size_t i = 0; i < m; i++)
+                              {
+                                SCAL * px = fx[i];
+                                SCAL sum = 0.0;
+                                if (conjugate)
+                                  for (size_t k : rb)
+                                    sum += Conj(px[k]) * fy(k);
+                                else
+                                  for (size_t k : rb)
+                                    sum += px[k] * fy(k);
+                                hres(i) += sum;
+                              }
+                          }
+                        lock_guard<mutex> guard(mut);
+                        res += hres;
+                      }, TasksPerThread(4));
+  }
+
+  template <typename SCAL>
+  void LocalMultiAdd (BaseVector & y, FlatVector<SCAL> c, FlatArray<const BaseVector*> basis)
+  {
+    static Timer t("BaseVector::MultiAdd"); RegionTimer reg(t);
+
+    size_t m = basis.Size();
+    if (m == 0) return;
+
+    Array<SCAL*> fx(m);
+    GetBasisPointers<SCAL> (basis, y, fx);
+    FlatVector<SCAL> fy = y.FV<SCAL>();
+    t.AddFlops (m * fy.Size());
+
+    ParallelForRange (fy.Size(), [&] (IntRange r)
+                      {
+                        for (size_t first = r.First(); first < r.Next(); first += MULTIVEC_BLOCK)
+                          {
+                            IntRange rb(first, min2(first+MULTIVEC_BLOCK, r.Next()));
+                            for (size_t i = 0; i < m; i++)
+                              {
+                                if (c(i) == SCAL(0.0)) continue;
+                                SCAL ci = c(i);
+                                SCAL * px = fx[i];
+                                for (size_t k : rb)
+                                  fy(k) += ci * px[k];
+                              }
+                          }
+                      }, TasksPerThread(4));
+  }
+
+  template void LocalMultiInnerProduct<double>
+  (FlatArray<const BaseVector*>, const BaseVector &, FlatVector<double>, bool);
+  template void LocalMultiInnerProduct<Complex>
+  (FlatArray<const BaseVector*>, const BaseVector &, FlatVector<Complex>, bool);
+  template void LocalMultiAdd<double>
+  (BaseVector &, FlatVector<double>, FlatArray<const BaseVector*>);
+  template void LocalMultiAdd<Complex>
+  (BaseVector &, FlatVector<Complex>, FlatArray<const BaseVector*>);
+
+  
   template <typename TSCAL>
   S_BaseVectorPtr<TSCAL> :: ~S_BaseVectorPtr ()
   {
@@ -218,6 +218,11 @@ namespace ngla
     virtual double InnerProductD (const BaseVector & v2) const;
     virtual Complex InnerProductC (const BaseVector & v2, bool conjuagte = false) const;
 
+    /// res(i) = <basis[i], this>, all products in one sweep over the vectors
+    virtual void MultiInnerProductD (FlatArray<const BaseVector*> basis, FlatVector<double> res) const;
+    virtual void MultiInnerProductC (FlatArray<const BaseVector*> basis, FlatVector<Complex> res,
+                                     bool conjugate = false) const;
+
     virtual double L2Norm () const;
     virtual bool IsComplex() const { return false; }
 
@@ -233,6 +238,10 @@ namespace ngla
     virtual BaseVector & Add (double scal, const BaseVector & v);
     virtual BaseVector & Add (Complex scal, const BaseVector & v);
 
+    /// this += sum_i c(i) * basis[i], in one sweep over the vectors
+    virtual void MultiAdd (FlatVector<double> c, FlatArray<const BaseVector*> basis);
+    virtual void MultiAdd (FlatVector<Complex> c, FlatArray<const BaseVector*> basis);
+
     virtual ostream & Print (ostream & ost) const;
     virtual void Save(ostream & ost) const;
     virtual void Load(istream & ist);
@@ -443,6 +452,27 @@ namespace ngla
       return vec->InnerProductC (v2, conjugate);
     }
 
+    virtual void MultiInnerProductD (FlatArray<const BaseVector*> basis, FlatVector<double> res) const
+    {
+      vec->MultiInnerProductD (basis, res);
+    }
+
+    virtual void MultiInnerProductC (FlatArray<const BaseVector*> basis, FlatVector<Complex> res,
+                                     bool conjugate) const
+    {
+      vec->MultiInnerProductC (basis, res, conjugate);
+    }
+
+    virtual void MultiAdd (FlatVector<double> c, FlatArray<const BaseVector*> basis)
+    {
+      vec->MultiAdd (c, basis);
+    }
+
+    virtual void MultiAdd (FlatVector<Complex> c, FlatArray<const BaseVector*> basis)
+    {
+      vec->MultiAdd (c, basis);
+    }
+
     virtual double L2Norm () const
     {
       return vec->L2Norm();
@@ -569,6 +599,11 @@ namespace ngla
     virtual double InnerProductD (const BaseVector & v2) const;
     virtual Complex InnerProductC (const BaseVector & v2, bool conjugate = false) const;
 
+    virtual void MultiInnerProductD (FlatArray<const BaseVector*> basis, FlatVector<double> res) const;
+    virtual void MultiInnerProductC (FlatArray<const BaseVector*> basis, FlatVector<Complex> res,
+                                     bool conjugate = false) const;
+    virtual void MultiAdd (FlatVector<double> c, FlatArray<const BaseVector*> basis);
+    virtual void MultiAdd (FlatVector<Complex> c, FlatArray<const BaseVector*> basis);
 
     virtual FlatVector<double> FVDouble () const;
     virtual FlatVector<Complex> FVComplex () const;
@@ -591,6 +626,15 @@ namespace ngla
   template <>
   double S_BaseVector<double> :: InnerProduct (const BaseVector & v2, bool conjugate) const;
 
+  /// local parts of MultiInnerProduct and MultiAdd, without communication.
+  /// The vectors are processed in row-blocks, every basis vector is read once.
+  template <typename SCAL>
+  NGS_DLL_HEADER void LocalMultiInnerProduct (FlatArray<const BaseVector*> basis, const BaseVector & y,
+                                              FlatVector<SCAL> res, bool conjugate);
+  template <typename SCAL>
+  NGS_DLL_HEADER void LocalMultiAdd (BaseVector & y, FlatVector<SCAL> c,
+                                     FlatArray<const BaseVector*> basis);
+
 
 #if not defined(FILE_BASEVECTOR_CPP)
   extern template class S_BaseVector<double>;
@@ -707,6 +751,99 @@ namespace ngla
     virtual BaseVector & Add (double scal, const BaseVector & v);
   };
 
+
+
+  /**
+     A set of vectors of the same size and type,
+     e.g. many right hand sides for the same matrix.
+     Matrices can process all vectors in one sweep (see BaseMatrix::MultAdd).
+     The vectors are shared, so sub-sets are views.
+  */
+  class NGS_DLL_HEADER MultiVector
+  {
+    Array<shared_ptr<BaseVector>> vecs;
+    shared_ptr<BaseVector> refvec;
+  public:
+    /// cnt new vectors of the same type as v
+    MultiVector (shared_ptr<BaseVector> v, size_t cnt);
+    /// set of existing vectors
+    MultiVector (const Array<shared_ptr<BaseVector>> & avecs);
+
+    size_t Size() const { return vecs.Size(); }
+    shared_ptr<BaseVector> operator[] (size_t i) const { return vecs[i]; }
+    shared_ptr<BaseVector> RefVec () const { return refvec; }
+    bool IsComplex() const { return refvec->IsComplex(); }
+
+    void Append (shared_ptr<BaseVector> v) { vecs.Append (v); }
+    /// append nr new vectors
+    void Extend (size_t nr = 1);
+    /// new MultiVector of same size and type
+    MultiVector CreateVector () const { return MultiVector (refvec, Size()); }
+
+    void SetScalar (double s);
+    /// this[i] = v2[i]
+    void Set (const MultiVector & v2);
+    /// this[i] += s * v2[i]
+    void Add (double s, const MultiVector & v2);
+    /// this[j] += sum_i x[i] * a(i,j), x must not share vectors with this
+    void Add (const MultiVector & x, FlatMatrix<double> a);
+    void Add (const MultiVector & x, FlatMatrix<Complex> a);
+
+    /// res(i,j) = <this[i], v2[j]>, all products in one sweep over the vectors
+    Matrix<double> InnerProductD (const MultiVector & v2) const;
+    Matrix<Complex> InnerProductC (const MultiVector & v2, bool conjugate = false) const;
+    /// norms of all vectors
+    Array<double> L2Norm () const;
+
+    /// copy vectors [first, first+W) into interleaved storage, missing vectors are zero
+    template <int W, typename SCAL>
+    void GetInterleaved (size_t first, FlatVector<Vec<W,SCAL>> hv) const
+    {
+      size_t cnt = min2 (size_t(W), Size()-first);
+      for (size_t k = 0; k < cnt; k++)
+        {
+          FlatVector<SCAL> fv = vecs[first+k]->FV<SCAL>();
+          for (size_t i = 0; i < hv.Size(); i++)
+            hv(i)(k) = fv(i);
+        }
+      for (size_t k = cnt; k < W; k++)
+        for (size_t i = 0; i < hv.Size(); i++)
+          hv(i)(k) = SCAL(0.0);
+    }
+
+    /// this[first+k] += s * hv(.)(k)
+    template <int W, typename SCAL>
+    void AddInterleaved (size_t first, SCAL s, FlatVector<Vec<W,SCAL>> hv) const
+    {
+      size_t cnt = min2 (size_t(W), Size()-first);
+      for (size_t k = 0; k < cnt; k++)
+        {
+          FlatVector<SCAL> fv = vecs[first+k]->FV<SCAL>();
+          for (size_t i = 0; i < hv.Size(); i++)
+            fv(i) += s * hv(i)(k);
+        }
+    }
+  };
+
+  /// calls func(first, integral_constant<int,W>) for blocks of W = 8, 4, 2, or 1 vectors,
+  /// the last block may be padded
+  template <typename FUNC>
+  inline void IterateMultiVectorBlocks (size_t cnt, FUNC func)
+  {
+    size_t first = 0;
+    for ( ; first+8 <= cnt; first += 8)
+      func (first, integral_constant<int,8>());
+    size_t rest = cnt-first;
+    if (rest > 4)
+      func (first, integral_constant<int,8>());
+    else if (rest > 2)
+      func (first, integral_constant<int,4>());
+    else if (rest == 2)
+      func (first, integral_constant<int,2>());
+    else if (rest == 1)
+      func (first, integral_constant<int,1>());
+  }
+
   
 
 
@@ -1021,6 +1158,38 @@ namespace ngla
     // return InnerProduct( v2.FVComplex(), Conj(v1.FVComplex()) );
   }
 
+  /// res(i) = S_InnerProduct<IPTYPE> (*basis[i], y), for parallel vectors with one reduction
+  template <class IPTYPE>
+  inline void S_MultiInnerProduct (FlatArray<const BaseVector*> basis, const BaseVector & y,
+                                   FlatVector<typename SCAL_TRAIT<IPTYPE>::SCAL> res)
+  {
+    for (size_t i = 0; i < basis.Size(); i++)
+      res(i) = S_InnerProduct<IPTYPE> (*basis[i], y);
+  }
+
+  template <> inline void
+  S_MultiInnerProduct<double> (FlatArray<const BaseVector*> basis, const BaseVector & y,
+                               FlatVector<double> res)
+  {
+    y.MultiInnerProductD (basis, res);
+  }
+
+  template <> inline void
+  S_MultiInnerProduct<Complex> (FlatArray<const BaseVector*> basis, const BaseVector & y,
+                                FlatVector<Complex> res)
+  {
+    y.MultiInnerProductC (basis, res);
+  }
+
+  template <> inline void
+  S_MultiInnerProduct<ComplexConjugate> (FlatArray<const BaseVector*> basis, const BaseVector & y,
+                                         FlatVector<Complex> res)
+  {
+    y.MultiInnerProductC (basis, res, true);
+    for (size_t i = 0; i < res.Size(); i++)
+      res(i) = Conj (res(i));
+  }
+
   ///
   inline double L2Norm (const BaseVector & v)
   {
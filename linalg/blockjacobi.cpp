@@ -400,6 +400,8 @@ namespace ngla
 	  for (size_t k = 0; k < blocki.Size(); k++)
 	    blockmat(j,k) = mat(blocki[j], blocki[k]);
         NgProfiler::StopThreadTimer (tget, TaskManager::GetThreadId());                         
+        // real blocks are inverted batched, see below
+        if (is_same<TM,double>::value) continue;
         NgProfiler::StartThreadTimer (tinv, TaskManager::GetThreadId());
 	CalcInverse (blockmat);
         NgProfiler::StopThreadTimer (tinv, TaskManager::GetThreadId());        
@@ -407,6 +409,30 @@ namespace ngla
        }
          NgProfiler::StopThreadTimer (tpar, TaskManager::GetThreadId());                  
        } );
+
+    if constexpr (is_same<TM,double>::value)
+      {
+        // block sizes repeat, invert blocks of equal size across SIMD lanes
+        static Timer tbatch("BlockJacobiPrecond ctor inv batched");
+        RegionTimer reg(tbatch);
+        
+        size_t maxbs = 0;
+        for (auto & block : invdiag)
+          maxbs = max2(maxbs, size_t(block.Height()));
+        
+        TableCreator<double*> creator(maxbs+1);
+        for ( ; !creator.Done(); creator++)
+          for (auto & block : invdiag)
+            if (block.Height())
+              creator.Add (block.Height(), &block(0,0));
+        Table<double*> bysize = creator.MoveTable();
+
+        for (size_t bs : Range(bysize))
+          ParallelForRange (bysize[bs].Size(), [&] (IntRange r)
+                            {
+                              CalcInverseBatch (bs, bysize[bs].Range(r));
+                            });
+      }
     
     cout << IM(3) << "\rBuilding block " << blocktable->Size() << "/" << blocktable->Size() << flush;
     *testout << "block coloring";
@@ -143,6 +143,7 @@ namespace ngla
     }
 
 
+    using BaseMatrix::MultAdd;
     ///
     virtual void MultAdd (TSCAL s, const BaseVector & x, BaseVector & y) const; 
 
@@ -238,6 +239,7 @@ namespace ngla
 
     void ComputeBlockFactor (FlatArray<int> block, int bw, FlatBandCholeskyFactors<TM> & inv) const;
   
+    using BaseMatrix::MultAdd;
     ///
     virtual void MultAdd (TSCAL s, const BaseVector & x, BaseVector & y) const;
 
@@ -11,6 +11,7 @@
 */ 
 
 #include <la.hpp>
+#include "../parallel/parallelvector.hpp"
 
 namespace ngla
 {
@@ -593,6 +594,8 @@ namespace ngla
 	wdn = S_InnerProduct<IPTYPE> (w,d);
 
 	if (printrates) cout << IM(1) << "0 " << sqrt(Abs(wdn)) << endl;
+        residuals.SetSize0();
+        residuals.Append (sqrt(Abs(wdn)));
 	if (wdn == 0.0) wdn = 1;	
 
 	if(stop_absolute)
@@ -626,6 +629,7 @@ namespace ngla
 	    s += w;
 
 	    if (printrates ) cout << IM(1) << n << " " << sqrt (Abs (wdn)) << endl;
+            residuals.Append (sqrt(Abs(wdn)));
 	    if ( sh )
 	      sh->SetThreadPercentage(100.*max2(double(n)/double(maxsteps),
 						(lwstart-log(Abs(wdn)))/(lwstart-lerr)));
@@ -650,6 +654,454 @@ namespace ngla
 
 
 
+  // the inner products of all pairs of vectors, according to IPTYPE
+  template <class IPTYPE>
+  Matrix<typename SCAL_TRAIT<IPTYPE>::SCAL> BlockInnerProduct (const MultiVector & x, const MultiVector & y);
+
+  template <> Matrix<double>
+  BlockInnerProduct<double> (const MultiVector & x, const MultiVector & y)
+  { return x.InnerProductD (y); }
+
+  template <> Matrix<Complex>
+  BlockInnerProduct<Complex> (const MultiVector & x, const MultiVector & y)
+  { return x.InnerProductC (y, false); }
+
+  template <> Matrix<Complex>
+  BlockInnerProduct<ComplexConjugate> (const MultiVector & x, const MultiVector & y)
+  { return x.InnerProductC (y, true); }
+
+
+  /*
+    Inverts the small Gram matrix m in place. Returns false if m is
+    numerically singular, i.e. the block vectors are (nearly) dependent.
+    The condition is estimated after diagonal scaling, so vectors with
+    very different residuals are not mistaken for dependent ones.
+  */
+  template <class SCAL>
+  bool InvertGramMatrix (FlatMatrix<SCAL> m)
+  {
+    size_t n = m.Height();
+    Vector<double> scale(n);
+    for (size_t i = 0; i < n; i++)
+      {
+        double dii = Abs (m(i,i));
+        if (dii == 0 || !std::isfinite (dii)) return false;
+        scale(i) = 1.0 / sqrt (dii);
+      }
+
+    double norm = 0;
+    for (size_t i = 0; i < n; i++)
+      for (size_t j = 0; j < n; j++)
+        norm = max2 (norm, scale(i) * scale(j) * Abs (m(i,j)));
+
+    try
+      {
+        CalcInverse (m);
+      }
+    catch (Exception &)
+      {
+        return false;
+      }
+
+    double invnorm = 0;
+    for (size_t i = 0; i < n; i++)
+      for (size_t j = 0; j < n; j++)
+        invnorm = max2 (invnorm, Abs (m(i,j)) / (scale(i) * scale(j)));
+    // max-entry norms bound the condition number up to a factor n
+    return std::isfinite (invnorm) && n * norm * invnorm < 1e12;
+  }
+
+  template <class IPTYPE>
+  void BlockCGSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & u) const
+  {
+    Array<shared_ptr<BaseVector>> vf, vu;
+    vf.Append (shared_ptr<BaseVector> (const_cast<BaseVector*>(&f), NOOP_Deleter));
+    vu.Append (shared_ptr<BaseVector> (&u, NOOP_Deleter));
+    MultiVector mu(vu);
+    Mult (MultiVector(vf), mu);
+  }
+
+  template <class IPTYPE>
+  void BlockCGSolver<IPTYPE> :: MultAdd (double s, const MultiVector & f, MultiVector & u) const
+  {
+    MultiVector hu = u.CreateVector();
+    Mult (f, hu);
+    u.Add (s, hu);
+  }
+
+  template <class IPTYPE>
+  void BlockCGSolver<IPTYPE> :: Mult (const MultiVector & f, MultiVector & u) const
+  {
+    static Timer timer ("Block-CG solver");
+    RegionTimer reg (timer);
+
+    size_t k = f.Size();
+    MultiVector d = f.CreateVector();
+    MultiVector w = f.CreateVector();
+    MultiVector s = f.CreateVector();
+    MultiVector as = f.CreateVector();
+    MultiVector hv = f.CreateVector();
+
+    if (initialize)
+      {
+        u.SetScalar (0.0);
+        d.Set (f);
+      }
+    else
+      {
+        a->Mult (u, hv);
+        d.Set (f);
+        d.Add (-1, hv);
+      }
+
+    if (c)
+      c->Mult (d, w);
+    else
+      w.Set (d);
+
+    // tolerances per vector
+    Array<double> err(k);
+    Array<int> active;
+    for (size_t i = 0; i < k; i++)
+      {
+        double wdn = Abs (S_InnerProduct<IPTYPE> (*w[i], *d[i]));
+        err[i] = stop_absolute ? prec*prec : prec*prec*wdn;
+        if (wdn > err[i])
+          active.Append (i);
+      }
+    if (printrates) cout << IM(1) << "Block-CG, " << k << " vectors" << endl;
+
+    auto select = [&] (const MultiVector & mv)
+      {
+        Array<shared_ptr<BaseVector>> vecs;
+        for (int i : active)
+          vecs.Append (mv[i]);
+        return MultiVector(vecs);
+      };
+
+    int n = 0;
+    bool breakdown = false;
+    while (active.Size() && n < maxsteps && !breakdown)
+      {
+        // (re)start with the remaining vectors
+        MultiVector da = select(d), wa = select(w), sa = select(s);
+        MultiVector asa = select(as), ua = select(u), hva = select(hv);
+        size_t ka = active.Size();
+
+        sa.Set (wa);
+        Matrix<SCAL> wd = BlockInnerProduct<IPTYPE> (wa, da);
+        Matrix<SCAL> alpha(ka), beta(ka);
+
+        bool converged = false;
+        while (!converged && n++ < maxsteps)
+          {
+            a->Mult (sa, asa);
+            Matrix<SCAL> sas = BlockInnerProduct<IPTYPE> (sa, asa);
+            if (!InvertGramMatrix<SCAL> (sas))
+              {
+                breakdown = true;
+                break;
+              }
+            alpha = sas * wd;
+            for (size_t i = 0; i < ka; i++)
+              for (size_t j = 0; j < ka; j++)
+                if (!std::isfinite (Abs (alpha(i,j))))
+                  breakdown = true;
+            if (breakdown) break;
+
+            ua.Add (sa, alpha);
+            alpha *= SCAL(-1.0);
+            da.Add (asa, alpha);
+
+            if (c)
+              c->Mult (da, wa);
+            else
+              wa.Set (da);
+
+            Matrix<SCAL> wdn = BlockInnerProduct<IPTYPE> (wa, da);
+
+            double maxres = 0;
+            for (size_t i = 0; i < ka; i++)
+              {
+                maxres = max2 (maxres, sqrt (Abs (wdn(i,i))));
+                if (Abs (wdn(i,i)) <= err[active[i]])
+                  converged = true;
+              }
+            if (printrates) cout << IM(1) << n << " " << maxres << endl;
+
+            // s = w + s * (wd^-1 wdn)
+            if (!InvertGramMatrix<SCAL> (wd))
+              {
+                breakdown = true;
+                break;
+              }
+            beta = wd * wdn;
+            hva.Set (wa);
+            hva.Add (sa, beta);
+            sa.Set (hva);
+            wd = wdn;
+          }
+
+        if (breakdown) break;
+
+        Array<int> still_active;
+        for (int i : active)
+          if (Abs (S_InnerProduct<IPTYPE> (*w[i], *d[i])) > err[i])
+            still_active.Append (i);
+        active = move(still_active);
+      }
+
+    if (breakdown)
+      {
+        // dependent vectors in the block: finish the remaining ones one by one
+        if (printrates)
+          cout << IM(1) << "Block-CG: block is rank deficient, continue with CG for "
+               << active.Size() << " vectors" << endl;
+        CGSolver<IPTYPE> cg(a, c);
+        cg.SetMaxSteps (maxsteps-n);
+        cg.SetInitialize (0);
+        cg.SetPrintRates (printrates);
+        int maxcg = 0;
+        for (int i : active)
+          {
+            cg.SetAbsolutePrecision (sqrt (err[i]));
+            cg.Mult (*f[i], *u[i]);
+            maxcg = max2 (maxcg, cg.GetSteps());
+          }
+        n += maxcg;
+      }
+
+    const_cast<int&> (steps) = n;
+  }
+
+
+
+  // a_i * b_i, conjugated as in S_InnerProduct<IPTYPE>
+  template <class IPTYPE>
+  struct FusedIP
+  {
+    template <typename T>
+    static INLINE T Prod (T a, T b) { return a*b; }
+  };
+
+  template <>
+  struct FusedIP<ComplexConjugate>
+  {
+    static INLINE Complex Prod (Complex a, Complex b) { return a*conj(b); }
+  };
+
+  /*
+    Several inner products (x[k], y) with the same y. The local parts
+    are computed in one sweep over the vectors, and summed over the
+    processes by one non-blocking reduction.
+   */
+  template <class IPTYPE>
+  class FusedInnerProducts
+  {
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    Vector<SCAL> values;
+#ifdef PARALLEL
+    MPI_Request request;
+    bool running = false;
+#endif
+  public:
+    FusedInnerProducts (size_t n) : values(n) { ; }
+
+    void Start (FlatArray<const BaseVector*> x, const BaseVector & y)
+    {
+      static Timer t("FusedInnerProducts"); RegionTimer reg(t);
+      size_t n = x.Size();
+
+      // one cumulated and one distributed vector, as in ParallelBaseVector::InnerProduct
+      auto ypar = dynamic_cast_ParallelBaseVector(&y);
+      bool parallel = ypar && ypar->Status() != NOT_PARALLEL;
+      if (parallel)
+        for (auto xk : x)
+          {
+            auto xpar = dynamic_cast_ParallelBaseVector(xk);
+            if (xpar->Status() == DISTRIBUTED && ypar->Status() == DISTRIBUTED)
+              xpar->Cumulate();
+            else if (xpar->Status() == CUMULATED && ypar->Status() == CUMULATED)
+              xpar->Distribute();
+          }
+
+      FlatVector<SCAL> fy = y.FV<SCAL>();
+      ArrayMem<SCAL*,4> fx(n);
+      for (size_t k = 0; k < n; k++)
+        fx[k] = &x[k]->FV<SCAL>()(0);
+      t.AddFlops (n * fy.Size());
+
+      constexpr int nparts = 16;
+      Matrix<SCAL> parts(nparts, n);
+      ParallelJob ([&] (TaskInfo ti)
+                   {
+                     auto r = ngstd::Range(fy).Split (ti.task_nr, ti.ntasks);
+                     ArrayMem<SCAL,4> sum(n);
+                     sum = SCAL(0.0);
+                     for (size_t i : r)
+                       {
+                         SCAL yi = fy(i);
+                         for (size_t k = 0; k < n; k++)
+                           sum[k] += FusedIP<IPTYPE>::Prod (fx[k][i], yi);
+                       }
+                     for (size_t k = 0; k < n; k++)
+                       parts(ti.task_nr, k) = sum[k];
+                   }, nparts);
+
+      values = SCAL(0.0);
+      for (int j = 0; j < nparts; j++)
+        values += parts.Row(j);
+
+#ifdef PARALLEL
+      if (parallel)
+        {
+          MPI_Iallreduce (MPI_IN_PLACE, &values(0), n, MyGetMPIType<SCAL>(), MPI_SUM,
+                          ypar->GetParallelDofs()->GetCommunicator(), &request);
+          running = true;
+        }
+#endif
+    }
+
+    FlatVector<SCAL> Wait ()
+    {
+#ifdef PARALLEL
+      if (running)
+        MPI_Wait (&request, MPI_STATUS_IGNORE);
+      running = false;
+#endif
+      return values;
+    }
+  };
+
+
+  template <class IPTYPE>
+  void PipelinedCGSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & u) const
+  {
+    static Timer timer ("Pipelined CG solver");
+    RegionTimer reg (timer);
+
+    try
+      {
+	if(sh)
+	  sh->SetThreadPercentage(0);
+
+        // r .. residual, pr = C r, w = A pr, m = C w, n = A m,
+        // p .. search direction, s = A p, q = C s, z = A q 
+        auto r = f.CreateVector();
+        auto pr = f.CreateVector();
+        auto w = f.CreateVector();
+        auto m = f.CreateVector();
+        auto n = f.CreateVector();
+        auto p = f.CreateVector();
+        auto s = f.CreateVector();
+        auto q = f.CreateVector();
+        auto z = f.CreateVector();
+
+        auto precond = [this] (const BaseVector & x, BaseVector & y)
+          {
+            if (c)
+              c->Mult (x, y);
+            else
+              y = x;
+          };
+
+	if (initialize)
+	  {
+	    u = 0.0;
+	    r = f;
+	  }
+	else
+	  r = f - (*a) * u;
+
+        precond (r, pr);
+        a->Mult (pr, w);
+
+        FusedInnerProducts<IPTYPE> ips(2);
+        ArrayMem<const BaseVector*,2> rw(2);
+        rw[0] = &r;
+        rw[1] = &w;
+
+        SCAL gamma, gamma_old = 0.0, delta, alpha = 0.0, beta;
+        double err = 0, lwstart = 0, lerr = 0;
+        int it = 0;
+        residuals.SetSize0();
+        
+        while (true)
+          {
+            // gamma = (r, C r), delta = (A C r, C r), reduced while m and n are computed
+            ips.Start (rw, pr);
+            precond (w, m);
+            a->Mult (m, n);
+            FlatVector<SCAL> vals = ips.Wait();
+            gamma = vals(0);
+            delta = vals(1);
+
+            if (printrates) cout << IM(1) << it << " " << sqrt(Abs(gamma)) << endl;
+            residuals.Append (sqrt(Abs(gamma)));
+
+            if (it == 0)
+              {
+                double wdn = Abs(gamma);
+                if (wdn == 0.0) wdn = 1;
+                err = stop_absolute ? prec*prec : prec*prec*wdn;
+                lwstart = log(wdn);
+                lerr = log(err);
+              }
+            else if (sh)
+              sh->SetThreadPercentage(100.*max2(double(it)/double(maxsteps),
+                                                (lwstart-log(Abs(gamma)))/(lwstart-lerr)));
+
+            if (Abs(gamma) <= err || it >= maxsteps || (sh && sh->ShouldTerminate()))
+              break;
+
+            if (it == 0)
+              {
+                beta = 0.0;
+                if (delta == 0.0) break;
+                alpha = gamma / delta;
+                z = n;
+                q = m;
+                s = w;
+                p = pr;
+              }
+            else
+              {
+                beta = gamma / gamma_old;
+                SCAL denom = delta - beta * gamma / alpha;
+                if (denom == 0.0) break;
+                alpha = gamma / denom;
+                z *= beta; z += n;
+                q *= beta; q += m;
+                s *= beta; s += w;
+                p *= beta; p += pr;
+              }
+
+            u += alpha * p;
+            r -= alpha * s;
+            pr -= alpha * q;
+            w -= alpha * z;
+            gamma_old = gamma;
+            it++;
+          }
+
+	const_cast<int&> (steps) = it;
+      }
+
+    catch (Exception & e)
+      {
+	e.Append ("in caught in PipelinedCGSolver::Mult\n");
+	throw;
+      }
+    catch (exception & e)
+      {
+	throw Exception(e.what() +
+			string ("\ncaught in PipelinedCGSolver::Mult\n"));
+      }
+  }
+
+
+
+
   template <class IPTYPE>
   void BiCGStabSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & u) const
   {
@@ -884,9 +1336,11 @@ namespace ngla
 	auto hv = f.CreateVector();
 
         Array<AutoVector> vi(maxsteps);
+        Array<const BaseVector*> basis(maxsteps);
         Matrix<SCAL> h(maxsteps+1, maxsteps);
         Matrix<SCAL> h2(maxsteps+1, maxsteps);
         Vector<SCAL> gammai(maxsteps), ci(maxsteps), si(maxsteps);
+        Vector<SCAL> proj(maxsteps), mproj(maxsteps);
 
 
         h = SCAL(0.0);
@@ -915,6 +1369,8 @@ namespace ngla
         gammai(0) = norm;
 
 	if (printrates) cout << IM(1) << "0 " << norm << endl;
+        residuals.SetSize0();
+        residuals.Append (norm);
 	
 	double err;
 	if(stop_absolute)
@@ -927,6 +1383,10 @@ namespace ngla
 	  {
             vi[j].AssignPointer (f.CreateVector());
             vi[j] = v;
+            basis[j] = &*vi[j];
+            FlatArray<const BaseVector*> vj = basis.Range(0, j+1);
+            FlatVector<SCAL> hp = proj.Range(0, j+1);
+            FlatVector<SCAL> hm = mproj.Range(0, j+1);
 
             av = (*a) * v;
             if (c)
@@ -935,15 +1395,24 @@ namespace ngla
                 av = hv;
               }
 
+            // classical Gram-Schmidt with one re-orthogonalization (CGS2):
+            // every pass is one sweep over the basis and one reduction
+            S_MultiInnerProduct<IPTYPE> (vj, av, hp);
+            w = av;
+            hm = -hp;
+            w.MultiAdd (hm, vj);
             for (int i = 0; i <= j; i++)
-              h2(i,j) = h(i,j) = S_InnerProduct<IPTYPE> (*vi[i], av);
+              h(i,j) = hp(i);
 
-            w = av;
+            S_MultiInnerProduct<IPTYPE> (vj, w, hp);
+            hm = -hp;
+            w.MultiAdd (hm, vj);
             for (int i = 0; i <= j; i++)
-              w -= h(i,j) * (*vi[i]);
+              h2(i,j) = h(i,j) += hp(i);
 
-            v = (1.0 / sqrt (S_InnerProduct<IPTYPE> (w, w))) * w;
-            h2(j+1,j) = h(j+1,j) = S_InnerProduct<IPTYPE> (v, av);
+            SCAL hnorm = sqrt (S_InnerProduct<IPTYPE> (w, w));
+            v = (1.0 / hnorm) * w;
+            h2(j+1,j) = h(j+1,j) = hnorm;
 
             for (int i = 0; i < j; i++)
               {
@@ -965,6 +1434,7 @@ namespace ngla
 
 
             norm = fabs (gammai(j));
+            residuals.Append (norm);
           }
         
         j--;
@@ -978,8 +1448,7 @@ namespace ngla
             y(i) = sum / h(i,i);
           }
 
-        for (int i = 0; i <= j; i++)
-          x += y(i) * *vi[i];
+        x.MultiAdd (y.Range(0, j+1), basis.Range(0, j+1));
 
 	const_cast<int&> (steps) = j;
 	
@@ -1325,6 +1794,12 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
   template class CGSolver<Complex>;
   template class CGSolver<ComplexConjugate>;
   template class CGSolver<ComplexConjugate2>;
+  template class BlockCGSolver<double>;
+  template class BlockCGSolver<Complex>;
+  template class BlockCGSolver<ComplexConjugate>;
+  template class PipelinedCGSolver<double>;
+  template class PipelinedCGSolver<Complex>;
+  template class PipelinedCGSolver<ComplexConjugate>;
   template class BiCGStabSolver<double>;
   template class BiCGStabSolver<Complex>;
   template class BiCGStabSolver<ComplexConjugate>;
@@ -40,6 +40,9 @@ namespace ngla
     ///
     const BaseStatusHandler * sh;
 
+    /// error estimate of every iteration of the last solve
+    mutable Array<double> residuals;
+
   public:
     ///
     NGS_DLL_HEADER KrylovSpaceSolver();
@@ -87,6 +90,10 @@ namespace ngla
     ///
     int GetSteps () const
     { return steps; }
+    /// convergence history of the last solve
+    FlatArray<double> GetResiduals () const
+    { return residuals; }
+    using BaseMatrix::Mult;
     ///
     NGS_DLL_HEADER virtual void Mult (const BaseVector & v, BaseVector & prod) const = 0;
     ///
@@ -120,11 +127,66 @@ namespace ngla
     CGSolver (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ac)
       : KrylovSpaceSolver (aa, ac) { ; }
 
+    using BaseMatrix::Mult;
     ///
     NGS_DLL_HEADER virtual void Mult (const BaseVector & v, BaseVector & prod) const;
   };
 
 
+  /**
+     Block conjugate gradient solver (O'Leary).
+     Solves for all vectors of a MultiVector at once with one matrix
+     and one preconditioner application to the whole block per step.
+     Converged vectors are removed and the block iteration restarts
+     with the remaining ones.
+     If the block becomes rank deficient (e.g. linearly dependent right
+     hand sides) the remaining vectors are solved by standard CG.
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER BlockCGSolver : public KrylovSpaceSolver
+  {
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    ///
+    BlockCGSolver (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ac)
+      : KrylovSpaceSolver (aa, ac) { ; }
+
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const override;
+    ///
+    virtual void Mult (const MultiVector & f, MultiVector & u) const override;
+    ///
+    virtual void MultAdd (double s, const MultiVector & f, MultiVector & u) const override;
+  };
+
+
+  /**
+     Pipelined conjugate gradient solver (Ghysels, Vanroose).
+     A recurrence for the preconditioned residual and its image under
+     the matrix moves both inner products of an iteration into one
+     reduction, which is computed in one sweep over the vectors and
+     summed over processes by a non-blocking MPI_Iallreduce while the
+     next preconditioner and matrix application run.
+     Needs 3 more vectors than CG, and is less stable for
+     ill-conditioned problems (the residual is not recomputed).
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER PipelinedCGSolver : public KrylovSpaceSolver
+  {
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    ///
+    PipelinedCGSolver (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ac)
+      : KrylovSpaceSolver (aa, ac) { ; }
+
+    using BaseMatrix::Mult;
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const override;
+  };
+
+
   /// The BiCGStab solver
   template <class IPTYPE>
   class NGS_DLL_HEADER BiCGStabSolver : public KrylovSpaceSolver
@@ -142,6 +204,7 @@ namespace ngla
     BiCGStabSolver (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ac)
       : KrylovSpaceSolver (aa, ac) { ; }
 
+    using BaseMatrix::Mult;
     ///
     virtual void Mult (const BaseVector & v, BaseVector & prod) const;
   };
@@ -168,6 +231,7 @@ namespace ngla
     ///
     SimpleIterationSolver (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ac)
       : KrylovSpaceSolver (aa, ac) { tau = 1; }
+    using BaseMatrix::Mult;
     ///
     virtual void Mult (const BaseVector & v, BaseVector & prod) const;
 
@@ -176,7 +240,11 @@ namespace ngla
 
 
 
-  /// The conjugate gradient solver
+  /**
+     GMRES without restart. The Krylov basis is orthogonalized by classical
+     Gram-Schmidt with one re-orthogonalization (CGS2), using fused
+     multi-inner-products and updates over the whole basis.
+  */
   template <class IPTYPE>
   class NGS_DLL_HEADER GMRESSolver : public KrylovSpaceSolver
   {
@@ -193,6 +261,7 @@ namespace ngla
     GMRESSolver (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ac)
       : KrylovSpaceSolver (aa, ac) { ; }
 
+    using BaseMatrix::Mult;
     ///
     virtual void Mult (const BaseVector & v, BaseVector & prod) const;
   };
@@ -220,6 +289,7 @@ namespace ngla
     QMRSolver (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ac)
       : KrylovSpaceSolver (aa, ac), c2(0) { ; }
 
+    using BaseMatrix::Mult;
     ///
     virtual void Mult (const BaseVector & v, BaseVector & prod) const;
   };
@@ -85,4 +85,139 @@ namespace ngla
   }
 
 
+
+  static double RealInnerProduct (const BaseVector & a, const BaseVector & b)
+  {
+    return a.IsComplex() ? a.InnerProductC (b, true).real() : a.InnerProductD (b);
+  }
+
+  // number of eigenvalues < x of the symmetric tridiagonal matrix (Sturm sequence)
+  static int CountEigenvaluesBelow (FlatArray<double> diag, FlatArray<double> offdiag, double x)
+  {
+    int cnt = 0;
+    double q = 1;
+    for (size_t i = 0; i < diag.Size(); i++)
+      {
+        double off2 = i > 0 ? sqr(offdiag[i-1]) : 0;
+        q = diag[i] - x - off2 / q;
+        if (q == 0) q = 1e-300;
+        if (q < 0) cnt++;
+      }
+    return cnt;
+  }
+  
+  ChebyshevJacobi :: ChebyshevJacobi (shared_ptr<BaseSparseMatrix> amat, shared_ptr<BitArray> freedofs,
+                                      int adegree, double ratio, int lanczos_steps)
+    : mat(amat), degree(adegree)
+  {
+    static Timer t("ChebyshevJacobi - estimate lmax"); RegionTimer reg(t);
+    jacobi = mat->CreateJacobiPrecond (freedofs);
+
+    // the coefficients of preconditioned CG give the Lanczos matrix of D^-1 A
+    auto r = mat->CreateColVector();
+    auto z = mat->CreateColVector();
+    auto p = mat->CreateColVector();
+    auto w = mat->CreateColVector();
+    
+    r.SetRandom();
+    z = (*jacobi) * r;
+    p = z;
+    double rz = RealInnerProduct (r, z);
+
+    Array<double> diag, offdiag;
+    double alpha_old = 1, beta_old = 0;
+    for (int k = 0; k < lanczos_steps && rz > 0; k++)
+      {
+        w = (*mat) * p;
+        double pw = RealInnerProduct (p, w);
+        if (pw <= 0) break;
+        double alpha = rz / pw;
+        
+        r -= alpha * w;
+        z = (*jacobi) * r;
+        double rz_new = RealInnerProduct (r, z);
+        double beta = rz_new / rz;
+        
+        diag.Append (1/alpha + beta_old/alpha_old);
+        if (k > 0) offdiag.Append (sqrt(beta_old)/alpha_old);
+        
+        p *= beta;
+        p += z;
+        rz = rz_new;
+        alpha_old = alpha;
+        beta_old = beta;
+      }
+
+    if (diag.Size() == 0)
+      lmax = 1;
+    else
+      {
+        // bisection within the Gershgorin bound
+        double upper = 0;
+        for (size_t i = 0; i < diag.Size(); i++)
+          {
+            double row = fabs(diag[i]);
+            if (i > 0) row += fabs(offdiag[i-1]);
+            if (i+1 < diag.Size()) row += fabs(offdiag[i]);
+            upper = max2 (upper, row);
+          }
+        double lower = 0;
+        int n = diag.Size();
+        for (int it = 0; it < 60 && upper-lower > 1e-6*upper; it++)
+          {
+            double mid = 0.5 * (lower+upper);
+            if (CountEigenvaluesBelow (diag, offdiag, mid) < n)
+              lower = mid;
+            else
+              upper = mid;
+          }
+        // Lanczos converges from below
+        lmax = 1.1 * upper;
+      }
+    lmin = lmax / ratio;
+    cout << IM(5) << "ChebyshevJacobi: lmax = " << lmax << endl;
+  }
+
+  void ChebyshevJacobi :: Smooth (BaseVector & x, const BaseVector & b, int steps) const
+  {
+    static Timer t("ChebyshevJacobi::Smooth"); RegionTimer reg(t);
+    
+    auto r = b.CreateVector();
+    auto d = b.CreateVector();
+    auto w = b.CreateVector();
+
+    double theta = 0.5 * (lmax+lmin);
+    double delta = 0.5 * (lmax-lmin);
+    double sigma = theta / delta;
+    
+    for (int s = 0; s < steps; s++)
+      {
+        r = b - (*mat) * x;
+        d = (*jacobi) * r;
+        d *= 1/theta;
+        
+        double rho = 1/sigma;
+        for (int k = 1; k <= degree; k++)
+          {
+            x += d;
+            if (k == degree) break;
+            
+            r -= (*mat) * d;
+            w = (*jacobi) * r;
+            
+            double rho_new = 1 / (2*sigma - rho);
+            d *= rho_new * rho;
+            d += (2*rho_new/delta) * w;
+            rho = rho_new;
+          }
+      }
+  }
+
+  void ChebyshevJacobi :: Mult (const BaseVector & b, BaseVector & x) const
+  {
+    x = 0;
+    Smooth (x, b, 1);
+  }
+
+
 }
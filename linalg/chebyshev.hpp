@@ -29,12 +29,57 @@ namespace ngla
     virtual bool IsComplex() const { return a->IsComplex(); } 
     ///
     void SetBounds (double almin, double almax);
+    using BaseMatrix::Mult;
     ///
     virtual void Mult (const BaseVector & v, BaseVector & prod) const;
     ///
     virtual AutoVector CreateVector () const;
   };
 
+
+  /**
+     Chebyshev-Jacobi smoother for symmetric positive definite matrices.
+     The polynomial damps the eigenvalues of D^-1 A in [lmax/ratio, lmax].
+     lmax is estimated by a few Lanczos steps (from preconditioned CG)
+     at setup. Needs only matrix-vector products and vector updates.
+  */
+  class NGS_DLL_HEADER ChebyshevJacobi : public BaseMatrix
+  {
+  protected:
+    shared_ptr<BaseSparseMatrix> mat;
+    /// inverse diagonal, zero for non-free dofs
+    shared_ptr<BaseJacobiPrecond> jacobi;
+    /// degree of the polynomial
+    int degree;
+    ///
+    double lmin, lmax;
+  public:
+    ///
+    ChebyshevJacobi (shared_ptr<BaseSparseMatrix> amat, shared_ptr<BitArray> freedofs,
+                     int adegree = 3, double ratio = 30, int lanczos_steps = 10);
+
+    virtual bool IsComplex() const override { return mat->IsComplex(); }
+    virtual int VHeight() const override { return mat->VHeight(); }
+    virtual int VWidth() const override { return mat->VWidth(); }
+    
+    /// estimate of the largest eigenvalue of D^-1 A
+    double GetLambdaMax () const { return lmax; }
+    ///
+    void SetBounds (double almin, double almax) { lmin = almin; lmax = almax; }
+    
+    /// steps times x += p(D^-1 A) D^-1 (b - A x)
+    void Smooth (BaseVector & x, const BaseVector & b, int steps = 1) const;
+    /// the polynomial is symmetric, the same as Smooth
+    void SmoothBack (BaseVector & x, const BaseVector & b, int steps = 1) const
+    { Smooth (x, b, steps); }
+    
+    using BaseMatrix::Mult;
+    /// one smoothing step with zero initial guess
+    virtual void Mult (const BaseVector & b, BaseVector & x) const override;
+    virtual AutoVector CreateRowVector () const override { return mat->CreateColVector(); }
+    virtual AutoVector CreateColVector () const override { return mat->CreateRowVector(); }
+  };
+
 }
 
 #endif
@@ -32,6 +32,7 @@ namespace ngla
     virtual bool IsComplex() const { return false; }
 
     virtual void ComputeMatrices (const BaseSparseMatrix & mat) = 0;
+    using BaseMatrix::Mult;
     virtual void Mult (const BaseVector & x, BaseVector & y) const = 0;
 
 
@@ -60,6 +61,7 @@ namespace ngla
     virtual void ComputeMatrices (const BaseSparseMatrix & mat);
     virtual size_t NZE() const;
 
+    using BaseMatrix::Mult;
     virtual void Mult (const BaseVector & x, BaseVector & y) const;
   };
 
@@ -88,6 +90,7 @@ namespace ngla
     virtual void ComputeMatrices (const BaseSparseMatrix & mat);
     virtual size_t NZE() const;
 
+    using BaseMatrix::Mult;
     virtual void Mult (const BaseVector & x, BaseVector & y) const;
   };
 
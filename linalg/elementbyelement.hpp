@@ -58,6 +58,7 @@ namespace ngla
       return make_shared<VVector<double>> (height);
     }
 
+    using BaseMatrix::MultAdd;
     virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const;
     virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const;
 
@@ -136,6 +137,7 @@ namespace ngla
     virtual int VHeight() const override { return h; }
     virtual int VWidth() const override { return w; }
     
+    using BaseMatrix::MultAdd;
     virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
     virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
     
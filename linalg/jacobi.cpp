@@ -9,6 +9,101 @@
 
 namespace ngla
 {
+
+  /*
+    Splits the rows into sets of independent Gauss-Seidel updates.
+    Update i reads the vector entries reads(i) and writes the entries
+    writes(i), both are called with a function taking the index.
+    levels == true: level scheduling of the natural ordering, sweeping
+    the sets gives the same result as the sequential sweep.
+    levels == false: greedy coloring, 32 colors per pass (as in block-Jacobi).
+    Both are computed sequentially, so the result does not depend on the
+    number of threads.
+  */
+  template <typename FREAD, typename FWRITE>
+  Table<int> CalcIndependentSets (size_t nrows, size_t n, bool levels,
+                                  FREAD reads, FWRITE writes)
+  {
+    static Timer t("Jacobi - independent sets"); RegionTimer reg(t);
+    Array<int> setnr(nrows);
+    int maxset = -1;
+    
+    if (levels)
+      {
+        Array<int> lastread(n), lastwrite(n);
+        lastread = -1;
+        lastwrite = -1;
+        for (size_t i = 0; i < nrows; i++)
+          {
+            int level = 0;
+            writes (i, [&] (size_t c) { level = max3(level, lastread[c]+1, lastwrite[c]+1); });
+            reads (i, [&] (size_t c) { level = max2(level, lastwrite[c]+1); });
+            writes (i, [&] (size_t c) { lastwrite[c] = level; });
+            reads (i, [&] (size_t c) { lastread[c] = max2(lastread[c], level); });
+            setnr[i] = level;
+            maxset = max2(maxset, level);
+          }
+      }
+    else
+      {
+        Array<unsigned int> readmask(n), writemask(n);
+        setnr = -1;
+        int basecol = 0;
+        size_t found = 0;
+        while (found < nrows)
+          {
+            readmask = 0;
+            writemask = 0;
+            for (size_t i = 0; i < nrows; i++)
+              {
+                if (setnr[i] >= 0) continue;
+
+                unsigned int check = 0;
+                writes (i, [&] (size_t c) { check |= readmask[c] | writemask[c]; });
+                reads (i, [&] (size_t c) { check |= writemask[c]; });
+                if (check == UINT_MAX) continue;
+
+                unsigned int checkbit = 1;
+                int color = basecol;
+                while (check & checkbit)
+                  {
+                    color++;
+                    checkbit *= 2;
+                  }
+                setnr[i] = color;
+                maxset = max2(maxset, color);
+                found++;
+                
+                writes (i, [&] (size_t c) { writemask[c] |= checkbit; });
+                reads (i, [&] (size_t c) { readmask[c] |= checkbit; });
+              }
+            basecol += 8*sizeof(unsigned int);
+          }
+      }
+    
+    TableCreator<int> creator(maxset+1);
+    for ( ; !creator.Done(); creator++)
+      for (size_t i = 0; i < nrows; i++)
+        creator.Add (setnr[i], i);
+    return creator.MoveTable();
+  }
+
+  /// loop over an independent set, small sets are done sequentially
+  template <typename FUNC>
+  INLINE void IterateIndependentSet (FlatArray<int> set, FUNC f)
+  {
+    if (set.Size() < 1024)
+      {
+        for (int i : set) f(i);
+        return;
+      }
+    ParallelForRange (set.Size(), [&] (IntRange r)
+                      {
+                        for (int i : set.Range(r)) f(i);
+                      });
+  }
+
+  
   template <class TM, class TV_ROW, class TV_COL>
   JacobiPrecond<TM,TV_ROW,TV_COL> ::
   JacobiPrecond (const SparseMatrix<TM,TV_ROW,TV_COL> & amat, 
@@ -108,6 +203,21 @@ namespace ngla
     FlatVector<TV_ROW> fx = x.FV<TV_ROW> ();
     const FlatVector<TV_ROW> fb = b.FV<TV_ROW> ();
 
+    if (gs_sets.Size())
+      {
+        for (auto set : gs_sets)
+          IterateIndependentSet
+            (set, [&] (int i)
+             {
+               if (!this->inner || this->inner->Test(i))
+                 {
+                   TV_ROW ax = mat.RowTimesVector (i, fx);
+                   fx(i) += invdiag[i] * (fb(i) - ax);
+                 }
+             });
+        return;
+      }
+    
     for (int i = 0; i < height; i++)
       if (!this->inner || this->inner->Test(i))
 	{
@@ -129,6 +239,21 @@ namespace ngla
     FlatVector<TV_ROW> fx = x.FV<TV_ROW> ();
     const FlatVector<TV_ROW> fb = b.FV<TV_ROW> ();
 
+    if (gs_sets.Size())
+      {
+        for (int c = gs_sets.Size()-1; c >= 0; c--)
+          IterateIndependentSet
+            (gs_sets[c], [&] (int i)
+             {
+               if (!this->inner || this->inner->Test(i))
+                 {
+                   TV_ROW ax = mat.RowTimesVector (i, fx);
+                   fx(i) += invdiag[i] * (fb(i) - ax);
+                 }
+             });
+        return;
+      }
+
     for (int i = height-1; i >= 0; i--)
       if (!this->inner || this->inner->Test(i))
 	{
@@ -144,9 +269,48 @@ namespace ngla
 		     const Array<int> & numbering, 
 		     int forward) const
   {
-    ;
+    FlatVector<TV_ROW> fx = x.FV<TV_ROW> ();
+    const FlatVector<TV_ROW> fb = b.FV<TV_ROW> ();
+
+    auto smooth_row = [&] (int i)
+      {
+        if (this->inner && !this->inner->Test(i)) return;
+        TV_ROW ax = mat.RowTimesVector (i, fx);
+        fx(i) += invdiag[i] * (fb(i) - ax);
+      };
+
+    if (forward)
+      for (int i : numbering)
+        smooth_row (i);
+    else
+      for (int k = numbering.Size()-1; k >= 0; k--)
+        smooth_row (numbering[k]);
   }
 
+  template <class TM, class TV_ROW, class TV_COL>
+  void JacobiPrecond<TM,TV_ROW,TV_COL> :: SetGSOrdering (string ordering)
+  {
+    if (ordering == "natural")
+      gs_sets = Table<int>();
+    else if (ordering == "coloring")
+      CalcGSSets (false);
+    else if (ordering == "levels")
+      CalcGSSets (true);
+    else
+      throw Exception ("JacobiPrecond: unknown Gauss-Seidel ordering '" + ordering +
+                       "', use 'natural', 'coloring' or 'levels'");
+    cout << IM(4) << "Gauss-Seidel ordering " << ordering << ", " << gs_sets.Size() << " sets" << endl;
+  }
+
+  template <class TM, class TV_ROW, class TV_COL>
+  void JacobiPrecond<TM,TV_ROW,TV_COL> :: CalcGSSets (bool levels)
+  {
+    // row i reads x(cols), writes x(i)
+    gs_sets = CalcIndependentSets
+      (height, height, levels,
+       [&] (size_t i, auto f) { for (auto c : mat.GetRowIndices(i)) f(c); },
+       [&] (size_t i, auto f) { f(i); });
+  }
 
 
 
@@ -170,6 +334,19 @@ namespace ngla
     FlatVector<TVX> fx = x.FV<TVX> ();
     const FlatVector<TVX> fb = b.FV<TVX> ();
 
+    if (this->gs_sets.Size())
+      {
+        if (this->inner)
+          ParallelFor (this->height, [&] (size_t i)
+                       {
+                         if (!this->inner->Test(i)) fx(i) = TVX(0);
+                       });
+        Vector<TV> y(this->height);
+        CalcPartialResidual (fx, fb, y);
+        SmoothSets (fx, y, false);
+        return;
+      }
+
     const SparseMatrixSymmetric<TM,TV> & smat =
       dynamic_cast<const SparseMatrixSymmetric<TM,TV>&> (this->mat);
 
@@ -204,6 +381,12 @@ namespace ngla
     FlatVector<TVX> fx = x.FV<TVX> ();
     FlatVector<TVX> fy = y.FV<TVX> ();
 
+    if (this->gs_sets.Size())
+      {
+        SmoothSets (fx, fy, false);
+        return;
+      }
+
     const SparseMatrixSymmetric<TM,TV> & smat =
       dynamic_cast<const SparseMatrixSymmetric<TM,TV>&> (this->mat);
 
@@ -242,6 +425,19 @@ namespace ngla
     const FlatVector<TVX> fb = b.FV<TVX> ();
     // dynamic_cast<const T_BaseVector<TVX> &> (b).FV();
 
+    if (this->gs_sets.Size())
+      {
+        if (this->inner)
+          ParallelFor (this->height, [&] (size_t i)
+                       {
+                         if (!this->inner->Test(i)) fx(i) = TVX(0);
+                       });
+        Vector<TV> y(this->height);
+        CalcPartialResidual (fx, fb, y);
+        SmoothSets (fx, y, true);
+        return;
+      }
+
     const SparseMatrixSymmetric<TM,TV> & smat =
       dynamic_cast<const SparseMatrixSymmetric<TM,TV>&> (this->mat);
     
@@ -278,6 +474,12 @@ namespace ngla
     FlatVector<TVX> fy = y.FV<TVX>();
     // FlatVector<TVX> fb = b.FV<TVX>();
 
+    if (this->gs_sets.Size())
+      {
+        SmoothSets (fx, fy, true);
+        return;
+      }
+
     for (int i = smat.Height()-1; i >=0; i--)
       if (!this->inner || this->inner->Test(i))
 	{
@@ -297,10 +499,100 @@ namespace ngla
 		     const Array<int> & numbering, 
 		     int forward) const
   {
-    ;
+    FlatVector<TVX> fx = x.FV<TVX> ();
+    const FlatVector<TVX> fb = b.FV<TVX> ();
+
+    const SparseMatrixSymmetric<TM,TV> & smat =
+      dynamic_cast<const SparseMatrixSymmetric<TM,TV>&> (this->mat);
+
+    if (this->inner)
+      for (int i = 0; i < this->height; i++)
+        if (!this->inner->Test(i)) fx(i) = TVX(0);
+
+    // the partial residual y = b - (D+L^t) x stays valid in any order
+    Vector<TV> y(this->height);
+    CalcPartialResidual (fx, fb, y);
+
+    auto smooth_row = [&] (int i)
+      {
+        if (this->inner && !this->inner->Test(i)) return;
+        TVX d = y(i) - smat.RowTimesVectorNoDiag (i, fx);
+        TVX w = this->invdiag[i] * d;
+        fx(i) += w;
+        smat.AddRowTransToVector (i, -w, y);
+      };
+
+    if (forward)
+      for (int i : numbering)
+        smooth_row (i);
+    else
+      for (int k = numbering.Size()-1; k >= 0; k--)
+        smooth_row (numbering[k]);
   }
 
+  template <class TM, class TV>
+  void JacobiPrecondSymmetric<TM,TV> :: CalcGSSets (bool levels)
+  {
+    // with the partial residual, row i writes x(i) and y(cols), and reads x(cols)
+    this->gs_sets = CalcIndependentSets
+      (this->height, this->height, levels,
+       [] (size_t i, auto f) { ; },
+       [&] (size_t i, auto f)
+       {
+         f(i);
+         for (auto c : this->mat.GetRowIndices(i)) f(c);
+       });
+  }
 
+  template <class TM, class TV>
+  void JacobiPrecondSymmetric<TM,TV> ::
+  CalcPartialResidual (FlatVector<TV> x, FlatVector<TV> b, FlatVector<TV> y) const
+  {
+    const SparseMatrixSymmetric<TM,TV> & smat =
+      dynamic_cast<const SparseMatrixSymmetric<TM,TV>&> (this->mat);
+
+    ParallelForRange (this->height, [&] (IntRange r) { y.Range(r) = b.Range(r); });
+
+    if (!this->gs_sets.Size())
+      {
+        for (int i = 0; i < this->height; i++)
+          smat.AddRowTransToVector (i, -x(i), y);
+        return;
+      }
+
+    // rows of one set do not share columns, so the scatter is conflict free
+    for (auto set : this->gs_sets)
+      IterateIndependentSet
+        (set, [&] (int i)
+         {
+           smat.AddRowTransToVector (i, -x(i), y);
+         });
+  }
+
+  template <class TM, class TV>
+  void JacobiPrecondSymmetric<TM,TV> ::
+  SmoothSets (FlatVector<TV> x, FlatVector<TV> y, bool backward) const
+  {
+    static Timer t("JacobiPrecondSymmetric::SmoothSets"); RegionTimer reg(t);
+    t.AddFlops (this->mat.NZE());
+    
+    const SparseMatrixSymmetric<TM,TV> & smat =
+      dynamic_cast<const SparseMatrixSymmetric<TM,TV>&> (this->mat);
+
+    auto smooth_row = [&] (int i)
+      {
+        if (this->inner && !this->inner->Test(i)) return;
+        TVX d = y(i) - smat.RowTimesVectorNoDiag (i, x);
+        TVX w = this->invdiag[i] * d;
+        x(i) += w;
+        smat.AddRowTransToVector (i, -w, y);
+      };
+
+    size_t nsets = this->gs_sets.Size();
+    for (size_t c = 0; c < nsets; c++)
+      IterateIndependentSet (this->gs_sets[backward ? nsets-1-c : c], smooth_row);
+  }
+  
 
   template class JacobiPrecond<double>;
   template class JacobiPrecond<Complex>;
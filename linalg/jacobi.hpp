@@ -21,6 +21,9 @@ namespace ngla
     virtual void GSSmooth (BaseVector & x, const BaseVector & b) const = 0;
     virtual void GSSmooth (BaseVector & x, const BaseVector & b, BaseVector & y /* , BaseVector & help */) const = 0;
     virtual void GSSmoothBack (BaseVector & x, const BaseVector & b) const = 0;
+
+    /// Gauss-Seidel ordering: "natural" (sequential), "coloring" or "levels" (parallel)
+    virtual void SetGSOrdering (string ordering) = 0;
   };
 
   /// A Jaboci preconditioner for general sparse matrices
@@ -36,6 +39,11 @@ namespace ngla
     int height;
     ///
     Array<TM> invdiag;
+    /// independent sets of rows for parallel Gauss-Seidel, empty for natural ordering
+    Table<int> gs_sets;
+
+    /// computes gs_sets by coloring or level scheduling
+    virtual void CalcGSSets (bool levels);
   public:
     // typedef typename mat_traits<TM>::TV_ROW TVX;
     typedef typename mat_traits<TM>::TSCAL TSCAL;
@@ -50,6 +58,7 @@ namespace ngla
     virtual int VHeight() const { return height; }
     virtual int VWidth() const  { return height; }
   
+    using BaseMatrix::MultAdd;
     ///
     virtual void MultAdd (TSCAL s, const BaseVector & x, BaseVector & y) const;
 
@@ -73,6 +82,9 @@ namespace ngla
     virtual void GSSmoothNumbering (BaseVector & x, const BaseVector & b,
 				    const Array<int> & numbering, 
 				    int forward = 1) const;
+
+    ///
+    virtual void SetGSOrdering (string ordering);
   };
 
 
@@ -87,6 +99,13 @@ namespace ngla
   template <class TM, class TV>
   class NGS_DLL_HEADER JacobiPrecondSymmetric : public JacobiPrecond<TM,TV,TV>
   {
+  protected:
+    virtual void CalcGSSets (bool levels);
+
+    /// y = b - (D+L^T) x, using the independent sets if available
+    void CalcPartialResidual (FlatVector<TV> x, FlatVector<TV> b, FlatVector<TV> y) const;
+    /// Gauss-Seidel sweep over the independent sets with partial residual y
+    void SmoothSets (FlatVector<TV> x, FlatVector<TV> y, bool backward) const;
   public:
     typedef TV TVX;
 
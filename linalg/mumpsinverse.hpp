@@ -87,6 +87,7 @@ namespace ngla
     int VWidth() const { return height; }
     ///
     virtual bool IsComplex() const { return iscomplex; }
+    using BaseMatrix::Mult;
     ///
     virtual void Mult (const BaseVector & x, BaseVector & y) const;
 
@@ -138,6 +139,7 @@ namespace ngla
     int VWidth() const { return height; }
     ///
     virtual bool IsComplex() const { return iscomplex; }
+    using BaseMatrix::Mult;
     ///
     virtual void Mult (const BaseVector & x, BaseVector & y) const;
 
@@ -574,9 +574,10 @@ namespace ngla
     static Timer reorder_timer("MinimumDegreeOrdering::Order");
     RegionTimer reg(reorder_timer);
 
-    cout << IM(4) << "start order" << endl;
+    if (stop_workers)
+      cout << IM(4) << "start order" << endl;
 
-    if (task_manager) task_manager -> StopWorkers();
+    if (task_manager && stop_workers) task_manager -> StopWorkers();
 
     for (int j = 0; j < n; j++)
       {
@@ -586,6 +587,7 @@ namespace ngla
 
     int minj = -1;
     int lastel = -1;
+    size_t elimpos = 0;
 
     if (n > 5000)
       cout << IM(4) << "order " << flush;
@@ -621,6 +623,20 @@ namespace ngla
 	    EliminateSlaveVertex (minj);
 	  }
 
+	else if (elimorder.Size())
+	  {
+	    // next master vertex in prescribed order,
+	    // slaves are eliminated together with their master
+	    while (vertices[elimorder[elimpos]].Eliminated() ||
+		   !IsMaster (elimorder[elimpos]))
+	      elimpos++;
+	    minj = elimorder[elimpos++];
+	    priqueue.Invalidate(minj);
+
+	    blocknr[i] = i;
+	    EliminateMasterVertex (minj);
+	  }
+
 	else
 	  {
 	    // find new master vertex
@@ -643,7 +659,7 @@ namespace ngla
       }
     // PrintCliques();
     // NgProfiler::Print (cout);
-    if (task_manager) task_manager -> StartWorkers();
+    if (task_manager && stop_workers) task_manager -> StartWorkers();
   }
 
 
@@ -796,4 +812,351 @@ namespace ngla
     list[nr].degree = 0;
   }
 
+
+
+  /*
+    Nested dissection ordering
+
+    Recursive vertex-separator bisection. Each subgraph is bisected by
+    the multilevel scheme: coarsening by heavy-edge matching, greedy
+    graph growing on the coarsest graph, and boundary refinement
+    (greedy Kernighan-Lin) on every level while projecting back.
+    The boundary of the side with fewer boundary vertices becomes the
+    separator, it is eliminated after both halves.
+
+    See: G. Karypis and V. Kumar, A fast and high quality multilevel
+    scheme for partitioning irregular graphs, SIAM J. Sci. Comput. 20, 1998
+  */
+
+  namespace
+  {
+    // vertex and edge weighted graph in compressed row storage
+    struct NDGraph
+    {
+      Array<int> firsti, adj, ewgt, vwgt;
+
+      int Size() const { return vwgt.Size(); }
+      FlatArray<int> Neighbours (int v) const { return adj.Range(firsti[v], firsti[v+1]); }
+      FlatArray<int> EdgeWeights (int v) const { return ewgt.Range(firsti[v], firsti[v+1]); }
+      int TotalWeight() const
+      {
+        int sum = 0;
+        for (int w : vwgt) sum += w;
+        return sum;
+      }
+    };
+
+
+    // heavy edge matching, cmap maps fine to coarse vertices
+    void CoarsenGraph (const NDGraph & g, Array<int> & cmap, NDGraph & cg)
+    {
+      int n = g.Size();
+      Array<int> match(n), rep;
+      cmap.SetSize(n);
+      cmap = -1;
+
+      for (int v = 0; v < n; v++)
+        {
+          if (cmap[v] != -1) continue;
+          int best = v, bestw = 0;
+          auto nbs = g.Neighbours(v);
+          auto wts = g.EdgeWeights(v);
+          for (auto j : Range(nbs))
+            if (cmap[nbs[j]] == -1 && wts[j] > bestw)
+              {
+                best = nbs[j];
+                bestw = wts[j];
+              }
+          match[v] = best;
+          match[best] = v;
+          cmap[v] = cmap[best] = rep.Size();
+          rep.Append (v);
+        }
+
+      int nc = rep.Size();
+      Array<int> pos(nc);
+      pos = -1;
+      cg.firsti.SetSize (nc+1);
+      cg.vwgt.SetSize (nc);
+      cg.adj.SetSize0();
+      cg.ewgt.SetSize0();
+
+      for (int c = 0; c < nc; c++)
+        {
+          int v1 = rep[c], v2 = match[v1];
+          cg.firsti[c] = cg.adj.Size();
+          cg.vwgt[c] = g.vwgt[v1] + ( (v2 != v1) ? g.vwgt[v2] : 0);
+
+          for (int v : { v1, v2 })
+            {
+              auto nbs = g.Neighbours(v);
+              auto wts = g.EdgeWeights(v);
+              for (auto j : Range(nbs))
+                {
+                  int cu = cmap[nbs[j]];
+                  if (cu == c) continue;
+                  if (pos[cu] == -1)
+                    {
+                      pos[cu] = cg.adj.Size();
+                      cg.adj.Append (cu);
+                      cg.ewgt.Append (wts[j]);
+                    }
+                  else
+                    cg.ewgt[pos[cu]] += wts[j];
+                }
+              if (v2 == v1) break;
+            }
+
+          for (size_t j = cg.firsti[c]; j < cg.adj.Size(); j++)
+            pos[cg.adj[j]] = -1;
+        }
+      cg.firsti[nc] = cg.adj.Size();
+    }
+
+
+    int CutWeight (const NDGraph & g, FlatArray<int> part)
+    {
+      int cut = 0;
+      for (int v = 0; v < g.Size(); v++)
+        if (part[v] == 0)
+          {
+            auto nbs = g.Neighbours(v);
+            auto wts = g.EdgeWeights(v);
+            for (auto j : Range(nbs))
+              if (part[nbs[j]] == 1)
+                cut += wts[j];
+          }
+      return cut;
+    }
+
+
+    // greedy refinement: move boundary vertices with positive gain,
+    // or with zero gain if it improves the balance
+    void RefineBisection (const NDGraph & g, FlatArray<int> part)
+    {
+      int n = g.Size();
+      int total = g.TotalWeight();
+      int maxvw = 0;
+      for (int w : g.vwgt) maxvw = max2 (maxvw, w);
+      int maxpart = max2 (int(0.52*total), total/2 + maxvw);
+
+      int w[2] = { 0, 0 };
+      for (int v = 0; v < n; v++)
+        w[part[v]] += g.vwgt[v];
+
+      for (int pass = 0; pass < 8; pass++)
+        {
+          int moves = 0;
+          for (int v = 0; v < n; v++)
+            {
+              int p = part[v];
+              int ext = 0, inner = 0;
+              auto nbs = g.Neighbours(v);
+              auto wts = g.EdgeWeights(v);
+              for (auto j : Range(nbs))
+                {
+                  if (part[nbs[j]] == p)
+                    inner += wts[j];
+                  else
+                    ext += wts[j];
+                }
+              if (ext == 0) continue;
+
+              int gain = ext-inner;
+              int wv = g.vwgt[v];
+              if ( (gain > 0 && w[1-p] + wv <= maxpart) ||
+                   (gain == 0 && w[p] - w[1-p] > wv) )
+                {
+                  part[v] = 1-p;
+                  w[p] -= wv;
+                  w[1-p] += wv;
+                  moves++;
+                }
+            }
+          if (!moves) break;
+        }
+    }
+
+
+    // graph growing from (pseudo-peripheral) seeds, keep the best cut
+    void GrowBisection (const NDGraph & g, Array<int> & part)
+    {
+      int n = g.Size();
+      int total = g.TotalWeight();
+      part.SetSize(n);
+
+      Array<int> queue(n), visited(n), trialpart(n);
+      visited = -1;
+      int bestcut = numeric_limits<int>::max();
+      int seed = 0;
+
+      for (int trial = 0; trial < 4; trial++)
+        {
+          trialpart = 1;
+          int w0 = 0, qfirst = 0, qlast = 0, next = 0;
+          visited[seed] = trial;
+          queue[qlast++] = seed;
+
+          while (w0 < total/2)
+            {
+              if (qfirst == qlast)
+                {
+                  // disconnected graph: continue with any unvisited vertex
+                  while (visited[next] == trial) next++;
+                  visited[next] = trial;
+                  queue[qlast++] = next;
+                }
+              int v = queue[qfirst++];
+              trialpart[v] = 0;
+              w0 += g.vwgt[v];
+              for (int u : g.Neighbours(v))
+                if (visited[u] != trial)
+                  {
+                    visited[u] = trial;
+                    queue[qlast++] = u;
+                  }
+            }
+
+          RefineBisection (g, trialpart);
+          int cut = CutWeight (g, trialpart);
+          if (cut < bestcut)
+            {
+              bestcut = cut;
+              part = trialpart;
+            }
+          // start next trial from the far end of the front
+          seed = queue[qlast-1];
+        }
+    }
+
+
+    void MultilevelBisection (const NDGraph & g, Array<int> & part)
+    {
+      if (g.Size() > 80)
+        {
+          NDGraph cg;
+          Array<int> cmap;
+          CoarsenGraph (g, cmap, cg);
+
+          if (cg.Size() < 0.9 * g.Size())
+            {
+              Array<int> cpart;
+              MultilevelBisection (cg, cpart);
+              part.SetSize (g.Size());
+              for (int v = 0; v < g.Size(); v++)
+                part[v] = cpart[cmap[v]];
+              RefineBisection (g, part);
+              return;
+            }
+        }
+      GrowBisection (g, part);
+    }
+
+
+    void NestedDissection (const Table<int> & graph, FlatArray<int> verts,
+                           FlatArray<int> local, int leafsize, Array<int> & order)
+    {
+      int nv = verts.Size();
+      if (nv <= leafsize)
+        {
+          // minimum degree within the leaf
+          for (int i = 0; i < nv; i++)
+            local[verts[i]] = i;
+
+          MinimumDegreeOrdering mdo(nv);
+          mdo.stop_workers = false;
+          for (int i = 0; i < nv; i++)
+            for (int u : graph[verts[i]])
+              if (local[u] > i)
+                mdo.AddEdge (i, local[u]);
+
+          for (int v : verts)
+            local[v] = -1;
+
+          mdo.Order();
+          for (int i = 0; i < nv; i++)
+            order.Append (verts[mdo.order[i]]);
+          return;
+        }
+
+      // subgraph in local numbering
+      for (int i = 0; i < nv; i++)
+        local[verts[i]] = i;
+
+      NDGraph g;
+      g.firsti.SetSize (nv+1);
+      g.vwgt.SetSize (nv);
+      g.vwgt = 1;
+      for (int i = 0; i < nv; i++)
+        {
+          g.firsti[i] = g.adj.Size();
+          for (int u : graph[verts[i]])
+            if (local[u] != -1)
+              {
+                g.adj.Append (local[u]);
+                g.ewgt.Append (1);
+              }
+        }
+      g.firsti[nv] = g.adj.Size();
+
+      for (int v : verts)
+        local[v] = -1;
+
+      Array<int> part;
+      MultilevelBisection (g, part);
+
+      // vertex separator from edge separator
+      int nbnd[2] = { 0, 0 };
+      Array<bool> boundary(nv);
+      for (int i = 0; i < nv; i++)
+        {
+          boundary[i] = false;
+          for (int u : g.Neighbours(i))
+            if (part[u] != part[i])
+              boundary[i] = true;
+          if (boundary[i]) nbnd[part[i]]++;
+        }
+
+      int sepside = (nbnd[0] <= nbnd[1]) ? 0 : 1;
+      for (int i = 0; i < nv; i++)
+        if (boundary[i] && part[i] == sepside)
+          part[i] = 2;
+
+      Array<int> sub[3];
+      for (int i = 0; i < nv; i++)
+        sub[part[i]].Append (verts[i]);
+
+      if (sub[0].Size() == 0 || sub[1].Size() == 0)
+        {
+          // no separator found (e.g. dense subgraph)
+          for (int v : verts)
+            order.Append (v);
+          return;
+        }
+
+      NestedDissection (graph, sub[0], local, leafsize, order);
+      NestedDissection (graph, sub[1], local, leafsize, order);
+      for (int v : sub[2])
+        order.Append (v);
+    }
+  }
+
+
+  Array<int> NestedDissectionOrdering (const Table<int> & graph, int leafsize)
+  {
+    static Timer t("NestedDissectionOrdering"); RegionTimer reg(t);
+
+    int n = graph.Size();
+    Array<int> order;
+    order.SetAllocSize (n);
+
+    Array<int> verts(n), local(n);
+    for (int i = 0; i < n; i++)
+      verts[i] = i;
+    local = -1;
+
+    NestedDissection (graph, verts, local, leafsize, order);
+    return order;
+  }
+
 }
@@ -137,6 +137,10 @@ namespace ngla
     MDOPriorityQueue priqueue;
     ///
     ngstd::BlockAllocator ball;
+    /// prescribed elimination order of master vertices (empty: minimum degree)
+    Array<int> elimorder;
+    /// stop the task-manager workers during Order (not for small sub-graphs)
+    bool stop_workers = true;
   public:
     ///
     MinimumDegreeOrdering (int an);
@@ -155,6 +159,9 @@ namespace ngla
     /// 
     ~MinimumDegreeOrdering();
 
+    /// eliminate masters in this order instead of minimum degree (e.g. nested dissection)
+    void SetEliminationOrder (Array<int> && aorder) { elimorder = move(aorder); }
+
     ///
     int NumCliques (int v) const
     {
@@ -199,6 +206,20 @@ namespace ngla
   };
 
 
+
+  /**
+     Nested dissection ordering by multilevel graph bisection.
+     graph is the symmetric adjacency (without diagonal) of the n vertices.
+     Subgraphs are coarsened by heavy-edge matching, bisected on the
+     coarsest level, and refined while projecting back.
+     The edge cut is turned into a vertex separator, which is
+     eliminated after both halves. Leaves are ordered by minimum degree.
+     Returns the elimination order of all vertices.
+  */
+  NGS_DLL_HEADER Array<int> NestedDissectionOrdering (const Table<int> & graph,
+                                                      int leafsize = 100);
+
+
 }
 
 
@@ -115,6 +115,82 @@ namespace ngla
 	MPI_Type_free(&mpi_t[dest]);
   }
 
+  ExchangePlan & ParallelDofs :: GetExchangePlan (int dpd) const
+  {
+    if (dpd >= exchange_plans.Size())
+      exchange_plans.SetSize (dpd+1);
+    if (!exchange_plans[dpd])
+      exchange_plans[dpd] = make_shared<ExchangePlan> (*this, dpd);
+    return *exchange_plans[dpd];
+  }
+
+
+  ExchangePlan :: ExchangePlan (const ParallelDofs & apardofs, int adpd)
+    : pardofs(apardofs), dpd(adpd)
+  {
+    procs = pardofs.GetDistantProcs();
+    int n = procs.Size();
+
+    Array<int> bufsize(n);
+    for (int i = 0; i < n; i++)
+      bufsize[i] = dpd * pardofs.GetExchangeDofs(procs[i]).Size();
+    sendbuf = Table<double> (bufsize);
+    recvbuf = Table<double> (bufsize);
+
+    auto comm = pardofs.GetCommunicator();
+    requests.SetSize (2*n);
+    for (int i = 0; i < n; i++)
+      {
+        MPI_Send_init (sendbuf[i], bufsize[i], MPI_DOUBLE, procs[i],
+                       MPI_TAG_SOLVE, comm, &requests[i]);
+        MPI_Recv_init (recvbuf[i], bufsize[i], MPI_DOUBLE, procs[i],
+                       MPI_TAG_SOLVE, comm, &requests[n+i]);
+      }
+  }
+
+  ExchangePlan :: ~ExchangePlan ()
+  {
+    for (auto & r : requests)
+      MPI_Request_free (&r);
+  }
+
+  void ExchangePlan :: Start (FlatVector<double> vec)
+  {
+    static Timer t("ExchangePlan::Start"); RegionTimer reg(t);
+    busy = true;
+    for (int i = 0; i < procs.Size(); i++)
+      {
+        FlatArray<int> exdofs = pardofs.GetExchangeDofs(procs[i]);
+        double * buf = sendbuf[i];
+        for (int dof : exdofs)
+          for (int k = 0; k < dpd; k++)
+            *buf++ = vec(dof*dpd+k);
+      }
+    if (requests.Size())
+      MPI_Startall (requests.Size(), requests);
+  }
+
+  void ExchangePlan :: FinishAdd (FlatVector<double> vec)
+  {
+    static Timer t("ExchangePlan::FinishAdd"); RegionTimer reg(t);
+    int n = procs.Size();
+    FlatArray<MPI_Request> sendrequests = requests.Range(0, n);
+    FlatArray<MPI_Request> recvrequests = requests.Range(n, 2*n);
+    // completed persistent requests become inactive and are skipped by MPI_Waitany
+    for (int cnt = 0; cnt < n; cnt++)
+      {
+        int i;
+        MPI_Waitany (n, recvrequests, &i, MPI_STATUS_IGNORE);
+        FlatArray<int> exdofs = pardofs.GetExchangeDofs(procs[i]);
+        double * buf = recvbuf[i];
+        for (int dof : exdofs)
+          for (int k = 0; k < dpd; k++)
+            vec(dof*dpd+k) += *buf++;
+      }
+    MPI_Waitall (n, sendrequests, MPI_STATUSES_IGNORE);
+    busy = false;
+  }
+
   shared_ptr<ParallelDofs> ParallelDofs :: SubSet (shared_ptr<BitArray> take_dofs) const
   {
     auto ndloc = this->GetNDofLocal();
@@ -14,6 +14,8 @@ namespace ngla
 
 #ifdef PARALLEL
 
+  class ExchangePlan;
+
   /**
      Handles the distribution of degrees of freedom for vectors and matrices
    */
@@ -47,6 +49,9 @@ namespace ngla
     /// entry-size
     int es;
     bool complex;
+
+    /// persistent exchanges for vectors, indexed by doubles per dof, created on first use
+    mutable Array<shared_ptr<ExchangePlan>> exchange_plans;
     
   public:
     /**
@@ -116,6 +121,42 @@ namespace ngla
       ScatterDofData (data);
     }
 
+    /// the exchange plan for vectors with dpd doubles per dof
+    ExchangePlan & GetExchangePlan (int dpd) const;
+  };
+
+
+  /**
+     Precomputed communication for cumulating vectors: 
+     the neighbour processes, packed send and receive buffers per
+     neighbour, and persistent requests (MPI_Send_init/MPI_Recv_init)
+     started with MPI_Startall. Shared by all vectors of the
+     ParallelDofs with the same entry size, only one exchange per
+     plan can be in flight at a time.
+   */
+  class ExchangePlan
+  {
+    const ParallelDofs & pardofs;
+    /// doubles per dof
+    int dpd;
+    /// neighbour processes
+    Array<int> procs;
+    Table<double> sendbuf, recvbuf;
+    /// send requests, followed by receive requests
+    Array<MPI_Request> requests;
+    bool busy = false;
+
+  public:
+    ExchangePlan (const ParallelDofs & apardofs, int adpd);
+    ~ExchangePlan ();
+
+    int DoublesPerDof () const { return dpd; }
+    bool Busy () const { return busy; }
+
+    /// packs the values at exchange dofs and starts all messages
+    void Start (FlatVector<double> vec);
+    /// waits for the messages and adds the received values
+    void FinishAdd (FlatVector<double> vec);
   };
 
 #else
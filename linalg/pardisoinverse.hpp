@@ -174,6 +174,7 @@ namespace ngla
       : PardisoInverseTM<TM> (a, ainner, acluster, symmetric) { ; }
 
     virtual ~PardisoInverse () { ; }
+    using BaseMatrix::Mult;
     ///
     virtual void Mult (const BaseVector & x, BaseVector & y) const;
     ///
@@ -58,6 +58,23 @@ namespace pybind11::detail {
   struct is_holder_type<BaseMatrix, std::shared_ptr<BaseMatrix>> : std::true_type {};
 }
 
+template<typename T>
+void ExportSparseCholesky(py::module m, string name)
+{
+  py::class_<SparseCholesky<T>, shared_ptr<SparseCholesky<T>>, SparseFactorization> (m, name.c_str())
+    .def_property_readonly("ordering", &SparseCholesky<T>::GetOrdering,
+                           "fill-reducing ordering ('minimum degree' or 'nested dissection')")
+    .def_property_readonly("nze", [] (SparseCholesky<T> & self) { return self.NZE(); },
+                           "number of non-zero entries of the factor")
+    .def_property_readonly("flops", &SparseCholesky<T>::GetFlops,
+                           "floating point operations of the factorization")
+    .def_property_readonly("orderingtime", &SparseCholesky<T>::GetOrderingTime,
+                           "wall time of the ordering in seconds")
+    .def_property_readonly("factortime", &SparseCholesky<T>::GetFactorTime,
+                           "wall time of the numerical factorization in seconds")
+    ;
+}
+
 template<typename T>
 void ExportSparseMatrix(py::module m)
 {
@@ -208,21 +225,19 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
           "size"_a, "complex"_a=false, "entrysize"_a=1);
 
     m.def("CreateParallelVector",
-          [] (shared_ptr<ParallelDofs> pardofs) -> shared_ptr<BaseVector>
+          [] (shared_ptr<ParallelDofs> pardofs, int es) -> shared_ptr<BaseVector>
           {
+            if (es == -1) es = pardofs->GetEntrySize();
 #ifdef PARALLEL
 	    if(pardofs->IsComplex())
-	      return make_shared<S_ParallelBaseVectorPtr<Complex>> (pardofs->GetNDofLocal(), pardofs->GetEntrySize(), pardofs, DISTRIBUTED);
+	      return make_shared<S_ParallelBaseVectorPtr<Complex>> (pardofs->GetNDofLocal(), es, pardofs, DISTRIBUTED);
 	    else
-	      return make_shared<S_ParallelBaseVectorPtr<double>> (pardofs->GetNDofLocal(), pardofs->GetEntrySize(), pardofs, DISTRIBUTED);
+	      return make_shared<S_ParallelBaseVectorPtr<double>> (pardofs->GetNDofLocal(), es, pardofs, DISTRIBUTED);
 #else
-	    if(pardofs->IsComplex())
-	      return make_shared<VVector<Complex>>(pardofs->GetNDofLocal());
-	    else
-	      return make_shared<VVector<double>>(pardofs->GetNDofLocal());
+	    return CreateBaseVector(pardofs->GetNDofLocal(), pardofs->IsComplex(), es);
 #endif
 	  },
-          py::arg("pardofs"));
+          py::arg("pardofs"), py::arg("entrysize")=-1);
     
   py::class_<BaseVector, shared_ptr<BaseVector>>(m, "BaseVector",
         py::dynamic_attr() // add dynamic attributes
@@ -468,6 +483,34 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
                             "number of blocks in BlockVector")
     ;
 
+  py::class_<MultiVector, shared_ptr<MultiVector>> (m, "MultiVector")
+    .def(py::init<shared_ptr<BaseVector>, size_t>(), py::arg("vector"), py::arg("n"),
+         "Makes MultiVector of n new vectors of the same type as given vector")
+    .def(py::init<> ([] (vector<shared_ptr<BaseVector>> vecs)
+                     {
+                       Array<shared_ptr<BaseVector>> v2;
+                       for (auto v : vecs) v2 += v;
+                       return make_shared<MultiVector> (v2);
+                     }), py::arg("vecs"), "Makes MultiVector from given list of vectors")
+    .def("__len__", &MultiVector::Size)
+    .def("__getitem__", [](MultiVector & self, size_t ind)
+         {
+           if (ind >= self.Size())
+             throw py::index_error();
+           return self[ind];
+         }, py::arg("ind"), "Return vector at given position")
+    .def("Append", &MultiVector::Append, py::arg("vec"), "Append vector to MultiVector")
+    .def("Extend", &MultiVector::Extend, py::arg("n")=1, "Append n new vectors")
+    .def("CreateVector", &MultiVector::CreateVector)
+    .def("InnerProduct", [](MultiVector & self, MultiVector & other, bool conjugate) -> py::object
+         {
+           if (self.IsComplex())
+             return py::cast (self.InnerProductC (other, conjugate));
+           return py::cast (self.InnerProductD (other));
+         }, py::arg("other"), py::arg("conjugate")=py::cast(true),
+         "Matrix of all pairwise inner products, computed in one sweep")
+    ;
+
 
 
 
@@ -663,6 +706,8 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
 
     .def("Mult",         [](BaseMatrix &m, BaseVector &x, BaseVector &y) { m.Mult(x, y); }, py::call_guard<py::gil_scoped_release>(), py::arg("x"), py::arg("y"))
     .def("MultAdd",      [](BaseMatrix &m, double s, BaseVector &x, BaseVector &y) { m.MultAdd (s, x, y); }, py::arg("value"), py::arg("x"), py::arg("y"), py::call_guard<py::gil_scoped_release>())
+    .def("Mult",         [](BaseMatrix &m, MultiVector &x, MultiVector &y) { m.Mult(x, y); }, py::call_guard<py::gil_scoped_release>(), py::arg("x"), py::arg("y"))
+    .def("MultAdd",      [](BaseMatrix &m, double s, MultiVector &x, MultiVector &y) { m.MultAdd (s, x, y); }, py::arg("value"), py::arg("x"), py::arg("y"), py::call_guard<py::gil_scoped_release>())
     .def("MultTrans",    [](BaseMatrix &m, double s, BaseVector &x, BaseVector &y) { y=0; m.MultTransAdd (1.0, x, y); }, py::arg("value"), py::arg("x"), py::arg("y"), py::call_guard<py::gil_scoped_release>())
     .def("MultTransAdd",  [](BaseMatrix &m, double s, BaseVector &x, BaseVector &y) { m.MultTransAdd (s, x, y); }, py::arg("value"), py::arg("x"), py::arg("y"), py::call_guard<py::gil_scoped_release>())
     .def("MultScale",    [](BaseMatrix &m, double s, BaseVector &x, BaseVector &y)
@@ -705,6 +750,8 @@ freedofs : BitArray
 inverse : string
   Solver to use, allowed values are:
     sparsecholesky - internal solver of NGSolve for symmetric matrices
+    sparsecholesky_nd - internal solver with nested dissection ordering (less fill on 3D meshes)
+    sparsecholesky_mixed - internal solver with single precision factor and iterative refinement
     umfpack        - solver by Suitesparse/UMFPACK (if NGSolve was configured with USE_UMFPACK=ON)
     pardiso        - PARDISO, either provided by libpardiso (USE_PARDISO=ON) or Intel MKL (USE_MKL=ON).
                      If neither Pardiso nor Intel MKL was linked at compile-time, NGSolve will look
@@ -732,9 +779,19 @@ inverse : string
   py::class_<BaseSparseMatrix, shared_ptr<BaseSparseMatrix>, BaseMatrix>
     (m, "BaseSparseMatrix", "sparse matrix of any type")
     
-    .def("CreateSmoother", [](BaseSparseMatrix & m, shared_ptr<BitArray> ba) 
-         { return m.CreateJacobiPrecond(ba); }, py::call_guard<py::gil_scoped_release>(),
-         py::arg("freedofs") = shared_ptr<BitArray>())
+    .def("Restrict", [](BaseSparseMatrix & m, const SparseMatrix<double> & prol)
+         { return m.Restrict(prol); }, py::call_guard<py::gil_scoped_release>(),
+         py::arg("prol"), "Return Galerkin product prol^T * mat * prol")
+
+    .def("CreateSmoother", [](BaseSparseMatrix & m, shared_ptr<BitArray> ba, string ordering) 
+         {
+           auto jac = m.CreateJacobiPrecond(ba);
+           jac->SetGSOrdering (ordering);
+           return jac;
+         }, py::call_guard<py::gil_scoped_release>(),
+         py::arg("freedofs") = shared_ptr<BitArray>(), py::arg("ordering") = "natural",
+         "Create Jacobi/Gauss-Seidel smoother. ordering = 'natural' (sequential Gauss-Seidel),\n"
+         "'coloring' (parallel, multicolor) or 'levels' (parallel, same result as 'natural')")
     
     .def("CreateBlockSmoother", [](BaseSparseMatrix & m, py::object blocks)
          {
@@ -760,8 +817,68 @@ inverse : string
            }
            return m.CreateBlockJacobiPrecond (blocktable);
          }, py::call_guard<py::gil_scoped_release>(), py::arg("blocks"))
+
+    .def("CompressIndices", [](BaseSparseMatrix & m, bool compress)
+         {
+           if (compress) m.CompressIndices();
+           else m.UncompressIndices();
+         }, py::call_guard<py::gil_scoped_release>(), py::arg("compress") = true,
+         "Use 16 bit compressed column indices in matrix-vector products and assembling")
+    .def_property_readonly("indices_compressed", &BaseSparseMatrix::IndicesCompressed)
+    .def_property_readonly("__memory__",
+                           [] (const BaseSparseMatrix & self)
+                           {
+                             std::vector<tuple<string,size_t, size_t>> ret;
+                             for (auto mui : static_cast<const BaseMatrix&>(self).GetMemoryUsage())
+                               ret.push_back ( make_tuple(mui.Name(), mui.NBytes(), mui.NBlocks()));
+                             return ret;
+                           })
+    
+    .def("SameGraph", [](BaseSparseMatrix & m, BaseSparseMatrix & m2)
+         { return m.SameGraph(m2); }, py::arg("mat"),
+         "Same sparsity pattern as mat ?")
+    .def("SharesGraph", [](BaseSparseMatrix & m, BaseSparseMatrix & m2)
+         { return m.GetSharedGraph() && m.GetSharedGraph() == m2.GetSharedGraph(); }, py::arg("mat"),
+         "Uses the same MatrixGraph object as mat ?")
+    
+    .def("CreateLinearCombination", [](BaseSparseMatrix & m, BaseSparseMatrix & m2, double a, double b)
+         { return m.CreateLinearCombination (a, b, m2); }, py::call_guard<py::gil_scoped_release>(),
+         py::arg("mat"), py::arg("a") = 1, py::arg("b") = 1,
+         "Create the sparse matrix a*self + b*mat. Both matrices must have the same graph,\n"
+         "as matrices of BilinearForms on the same spaces do, the graph is shared.")
+
+    .def("__timing__", [] (BaseSparseMatrix & self) { return py::cast(self.Timing()); })
      ;
 
+  py::class_<SparseMatrixSELL, shared_ptr<SparseMatrixSELL>, BaseMatrix>
+    (m, "SparseMatrixSELL", "real sparse matrix in sliced ELLPACK (SELL-C-sigma) format for SIMD matrix-vector products")
+    .def(py::init<> ([] (shared_ptr<BaseMatrix> mat, int sigma)
+                     {
+                       auto spmat = dynamic_pointer_cast<SparseMatrixTM<double>> (mat);
+                       if (!spmat)
+                         throw Exception ("SparseMatrixSELL: need a real SparseMatrix");
+                       return make_shared<SparseMatrixSELL> (spmat, sigma);
+                     }), py::arg("mat"), py::arg("sigma")=256,
+         "copy of sparse matrix mat, rows are sorted by length within windows of sigma rows")
+    .def("SetValues", [] (SparseMatrixSELL & self, shared_ptr<BaseMatrix> mat)
+         {
+           auto spmat = dynamic_pointer_cast<SparseMatrixTM<double>> (mat);
+           if (!spmat)
+             throw Exception ("SparseMatrixSELL::SetValues: need a real SparseMatrix");
+           self.SetValues (*spmat);
+         }, py::arg("mat"), "copy values of a sparse matrix with the same graph")
+    .def_property_readonly("padding", &SparseMatrixSELL::PaddingFactor,
+                           "stored entries including padding, relative to the non-zero entries")
+    .def("CreateSmoother", [](SparseMatrixSELL & m, shared_ptr<BitArray> ba, string ordering)
+         {
+           auto jac = m.CreateJacobiPrecond(ba);
+           jac->SetGSOrdering (ordering);
+           return jac;
+         }, py::call_guard<py::gil_scoped_release>(),
+         py::arg("freedofs") = shared_ptr<BitArray>(), py::arg("ordering") = "natural",
+         "Jacobi/Gauss-Seidel smoother of the original sparse matrix")
+    ;
+
   py::class_<S_BaseMatrix<double>, shared_ptr<S_BaseMatrix<double>>, BaseMatrix>
     (m, "S_BaseMatrixD", "base sparse matrix");
   py::class_<S_BaseMatrix<Complex>, shared_ptr<S_BaseMatrix<Complex>>, BaseMatrix>
@@ -858,6 +975,8 @@ inverse : string
     .def_property_readonly("col_pardofs", [](ParallelMatrix & mat) { return mat.GetColParallelDofs(); })
     .def_property_readonly("local_mat", [](ParallelMatrix & mat) { return mat.GetMatrix(); })
     .def_property_readonly("op_type", [](ParallelMatrix & mat) { return mat.GetOpType(); })
+    .def_property("overlap", &ParallelMatrix::GetOverlap, &ParallelMatrix::SetOverlap,
+                  "overlap the vector exchange with the product of interior rows")
     ;
 
 
@@ -913,8 +1032,20 @@ inverse : string
          "perform smoothing step (needs non-symmetric storage so symmetric sparse matrix)")
     ;
 
-  py::class_<SparseCholesky<double>, shared_ptr<SparseCholesky<double>>, SparseFactorization> (m, "SparseCholesky_d");
-  py::class_<SparseCholesky<Complex>, shared_ptr<SparseCholesky<Complex>>, SparseFactorization> (m, "SparseCholesky_c");
+  ExportSparseCholesky<double>(m, "SparseCholesky_d");
+  ExportSparseCholesky<Complex>(m, "SparseCholesky_c");
+
+  py::class_<MixedPrecisionCholesky, shared_ptr<MixedPrecisionCholesky>, SparseFactorization>
+    (m, "MixedPrecisionCholesky",
+     "sparse Cholesky factor in single precision with iterative refinement in double precision")
+    .def_property_readonly("steps", &MixedPrecisionCholesky::GetSteps,
+                           "refinement steps of the last solve")
+    .def_property_readonly("nze", [] (MixedPrecisionCholesky & self) { return self.NZE(); },
+                           "number of non-zero entries of the factor")
+    .def("SetTolerance", &MixedPrecisionCholesky::SetTolerance, py::arg("tol"),
+         "stop refinement if correction is below tol * |x|")
+    .def("SetMaxSteps", &MixedPrecisionCholesky::SetMaxSteps, py::arg("maxsteps"))
+    ;
   
   py::class_<Projector, shared_ptr<Projector>, BaseMatrix> (m, "Projector")
     .def(py::init<shared_ptr<BitArray>,bool>(),
@@ -959,6 +1090,13 @@ inverse : string
     
   py::class_<KrylovSpaceSolver, shared_ptr<KrylovSpaceSolver>, BaseMatrix> (m, "KrylovSpaceSolver")
     .def("GetSteps", &KrylovSpaceSolver::GetSteps)
+    .def_property_readonly("residuals", [](KrylovSpaceSolver & self)
+                           {
+                             py::list res;
+                             for (double r : self.GetResiduals())
+                               res.append (r);
+                             return res;
+                           }, "error estimates of the iterations of the last solve")
     ;
 
   m.def("CGSolver", [](shared_ptr<BaseMatrix> mat, shared_ptr<BaseMatrix> pre,
@@ -1001,6 +1139,108 @@ precision : float
 maxsteps : int
   input maximal steps. CGSolver stops after this steps.
 
+)raw_string"))
+    ;
+
+
+  m.def("BlockCGSolver", [](shared_ptr<BaseMatrix> mat, shared_ptr<BaseMatrix> pre,
+                            bool iscomplex, bool conjugate, bool printrates,
+                            double precision, int maxsteps)
+        {
+          shared_ptr<KrylovSpaceSolver> solver;
+          if(mat->IsComplex()) iscomplex = true;
+
+          if (iscomplex && conjugate)
+            solver = make_shared<BlockCGSolver<ComplexConjugate>> (mat, pre);
+          else if (iscomplex)
+            solver = make_shared<BlockCGSolver<Complex>> (mat, pre);
+          else
+            solver = make_shared<BlockCGSolver<double>> (mat, pre);
+          solver->SetPrecision(precision);
+          solver->SetMaxSteps(maxsteps);
+          solver->SetPrintRates (printrates);
+          return solver;
+        },
+        py::arg("mat"), py::arg("pre"), py::arg("complex") = false, py::arg("conjugate") = false,
+        py::arg("printrates")=true, py::arg("precision")=1e-8, py::arg("maxsteps")=200, docu_string(R"raw_string(
+A block CG Solver for several right hand sides. Use Mult with MultiVectors
+to solve all systems at once, every vector is iterated to the given
+relative precision.
+
+Parameters:
+
+mat : ngsolve.la.BaseMatrix
+  input matrix 
+
+pre : ngsolve.la.BaseMatrix
+  input preconditioner matrix
+
+complex : bool
+  input complex, if not set it is deduced from matrix type
+
+conjugate : bool
+  use the Hermitian inner product for complex systems
+
+printrates : bool
+  input printrates
+
+precision : float
+  input requested precision. BlockCGSolver stops if precision is reached.
+
+maxsteps : int
+  input maximal steps. BlockCGSolver stops after this steps.
+
+)raw_string"))
+    ;
+
+  m.def("PipelinedCGSolver", [](shared_ptr<BaseMatrix> mat, shared_ptr<BaseMatrix> pre,
+                                bool iscomplex, bool conjugate, bool printrates,
+                                double precision, int maxsteps)
+        {
+          shared_ptr<KrylovSpaceSolver> solver;
+          if(mat->IsComplex()) iscomplex = true;
+
+          if (iscomplex && conjugate)
+            solver = make_shared<PipelinedCGSolver<ComplexConjugate>> (mat, pre);
+          else if (iscomplex)
+            solver = make_shared<PipelinedCGSolver<Complex>> (mat, pre);
+          else
+            solver = make_shared<PipelinedCGSolver<double>> (mat, pre);
+          solver->SetPrecision(precision);
+          solver->SetMaxSteps(maxsteps);
+          solver->SetPrintRates (printrates);
+          return solver;
+        },
+        py::arg("mat"), py::arg("pre"), py::arg("complex") = false, py::arg("conjugate") = false,
+        py::arg("printrates")=true, py::arg("precision")=1e-8, py::arg("maxsteps")=200, docu_string(R"raw_string(
+A pipelined CG Solver (Ghysels-Vanroose). Both inner products of an
+iteration are computed in one sweep over the vectors and reduced by one
+non-blocking MPI reduction, which overlaps with the preconditioner and
+the matrix-vector product.
+
+Parameters:
+
+mat : ngsolve.la.BaseMatrix
+  input matrix 
+
+pre : ngsolve.la.BaseMatrix
+  input preconditioner matrix
+
+complex : bool
+  input complex, if not set it is deduced from matrix type
+
+conjugate : bool
+  use the Hermitian inner product for complex systems
+
+printrates : bool
+  input printrates
+
+precision : float
+  input requested precision. PipelinedCGSolver stops if precision is reached.
+
+maxsteps : int
+  input maximal steps. PipelinedCGSolver stops after this steps.
+
 )raw_string"))
     ;
 
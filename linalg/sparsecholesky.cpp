@@ -8,106 +8,10 @@
 
 #include <la.hpp>
 
-#include "concurrentqueue.h" 
 
 
-typedef moodycamel::ConcurrentQueue<int> TQueue; 
-typedef moodycamel::ProducerToken TPToken; 
-typedef moodycamel::ConsumerToken TCToken; 
-
-
-namespace ngstd
-{
-  bool ProcessTask();
-}
-
 namespace ngla
 {
-  
-  static TQueue queue;
-
-
-  template <typename TFUNC>
-  void RunParallelDependency (const Table<int> & dag,
-                              const Table<int> & trans_dag, // transposed dag
-                              TFUNC func)
-  {
-    Array<atomic<int>> cnt_dep(dag.Size());
-    for (auto i : Range(cnt_dep))
-      cnt_dep[i].store (trans_dag[i].Size(), memory_order_relaxed);
-    
-    Array<int> ready(dag.Size());
-    ready.SetSize0();
-    int num_final = 0;
-
-    for (int j : Range(cnt_dep))
-      {
-        if (cnt_dep[j] == 0) ready.Append(j);
-        if (dag[j].Size() == 0) num_final++;
-      }
-
-
-    if (!task_manager)
-      {
-        while (ready.Size())
-          {
-            int size = ready.Size();
-            int nr = ready[size-1];
-            ready.SetSize(size-1);
-            
-            func(nr);
-            
-            for (int j : dag[nr])
-              {
-                cnt_dep[j]--;
-                if (cnt_dep[j] == 0)
-                  ready.Append(j);
-              }
-          }
-        return;
-      }
-
-    atomic<int> cnt_final(0);
-    SharedLoop sl(Range(ready));
-
-    task_manager -> CreateJob 
-      ([&] (const TaskInfo & ti)
-       {
-        TPToken ptoken(queue); 
-        TCToken ctoken(queue); 
-        
-        for (int i : sl)
-          queue.enqueue (ptoken, ready[i]);
-
-        while (1)
-           {
-             if (cnt_final >= num_final) break;
-
-             while (ProcessTask()); // do the nested tasks
-             
-             int nr;
-             if(!queue.try_dequeue_from_producer(ptoken, nr)) 
-               if(!queue.try_dequeue(ctoken, nr))  
-                 continue; 
-             
-             func(nr);
-
-             if (dag[nr].Size() == 0)
-               cnt_final++;
-
-             for (int j : dag[nr])
-               {
-                 if (--cnt_dep[j] == 0)
-                   queue.enqueue (ptoken, j);
-               }
-           }
-       });
-  }
-
-
-
-
-
 
   template <class TM>
   void SetIdentity( TM &identity )
@@ -120,8 +24,8 @@ namespace ngla
 
 
 
-  template <class TM>
-  SparseCholeskyTM<TM> :: 
+  template <class TM, class TMS>
+  SparseCholeskyTM<TM,TMS> :: 
   SparseCholeskyTM (const SparseMatrixTM<TM> & a, 
                     shared_ptr<BitArray> ainner,
                     shared_ptr<const Array<int>> acluster,
@@ -212,12 +116,37 @@ namespace ngla
 	}
     */
 
+    double wt_start = WallTime();
+    if (a.GetInverseType() == SPARSECHOLESKY_ND)
+      {
+        // same couplings as passed to the minimum degree ordering
+        auto coupled = [&] (int i, int j)
+          {
+            if (inner) return inner->Test(i) && inner->Test(j);
+            if (cluster) return (*cluster)[i] && (*cluster)[i] == (*cluster)[j];
+            return true;
+          };
+
+        TableCreator<int> creator(n);
+        for ( ; !creator.Done(); creator++)
+          for (int i = 0; i < n; i++)
+            for (auto col : a.GetRowIndices(i))
+              if (col < i && coupled (i, col))
+                {
+                  creator.Add (i, col);
+                  creator.Add (col, i);
+                }
+        mdo->SetEliminationOrder (NestedDissectionOrdering (creator.MoveTable()));
+        ordering = "nested dissection";
+      }
+
     if (printstat)
       cout << IM(4) << "start ordering" << endl;
     
     // mdo -> PrintCliques ();
     mdo->Order();
     nused = mdo->nused;
+    ordering_time = WallTime()-wt_start;
     endtime = clock();
     if (printstat)
       cout << IM(4) << "ordering time = "
@@ -237,12 +166,12 @@ namespace ngla
 
     diag.SetSize(nused);
     // lfact.SetSize (nze);
-    lfact = NumaInterleavedArray<TM> (nze);
+    lfact = NumaInterleavedArray<TMS> (nze);
 
     // lfact = TM(0.0);     // first touch
     ParallelForRange (nze, [&] (IntRange r)
                       {
-                        lfact.Range(r) = TM(0.0);
+                        lfact.Range(r) = TMS(0.0);
                       });
     
     endtime = clock();
@@ -251,7 +180,12 @@ namespace ngla
 	     << double (endtime - starttime) / CLOCKS_PER_SEC << " secs" << endl;
     
     starttime = endtime;
+    wt_start = WallTime();
     FactorNew(a);
+    factor_time = WallTime()-wt_start;
+    cout << IM(4) << "SparseCholesky, " << ordering << " ordering: nze = " << nze
+         << ", flops = " << flops << ", ordering time = " << ordering_time
+         << " sec, factor time = " << factor_time << " sec" << endl;
     /*
 #ifdef LAPACK
     if (a.IsSPD())
@@ -292,8 +226,8 @@ namespace ngla
   
 
   
-  template <class TM>
-  void SparseCholeskyTM<TM> :: 
+  template <class TM, class TMS>
+  void SparseCholeskyTM<TM,TMS> :: 
   Allocate (const Array<int> & aorder, 
 	    // const Array<CliqueEl*> & cliques,
 	    const Array<MDOVertex> & vertices,
@@ -331,12 +265,12 @@ namespace ngla
     nze = cnt;
 
     if (n > 2000)
-      cout << IM(4) << " " << cnt*sizeof(TM)+cnt_master*sizeof(int) << " Bytes " << flush;
+      cout << IM(4) << " " << cnt*sizeof(TMS)+cnt_master*sizeof(int) << " Bytes " << flush;
     //cout << IM(4) <<"(cnt="<<cnt<<", sizeof(TM)="<<sizeof(TM)<< ", cnt_master=" << cnt_master << ", sizeof(int)=" << sizeof(int) <<") " << flush;
 
 
     /* 
-     *testout << " Sparse Cholesky mem needed " << double(cnt*sizeof(TM)+cnt_master*sizeof(int))*1e-6 << " MBytes " << endl; 
+     *testout << " Sparse Cholesky mem needed " << double(cnt*sizeof(TMS)+cnt_master*sizeof(int))*1e-6 << " MBytes " << endl; 
      */  
 
     firstinrow.SetSize(nused+1);
@@ -376,6 +310,14 @@ namespace ngla
 
     firstinrow[nused] = cnt;
     firstinrow_ri[nused] = cnt_master;
+
+    // column i of L has c non-zeros below the diagonal: c divisions and c(c+1)/2 multiply-adds
+    flops = 0;
+    for (int i = 0; i < nused; i++)
+      {
+        double c = firstinrow[i+1]-firstinrow[i];
+        flops += c*(c+2);
+      }
     
     
     for (int i = 1; i < blocknrs.Size(); i++)
@@ -427,6 +369,18 @@ namespace ngla
 
     block_dependency = creator.MoveTable();
 
+    // analyzed once, re-run by every (re-)factorization
+    {
+      Array<double> costs(block_dependency.Size());
+      for (int i : Range(costs))
+        {
+          double mi = BlockDofs(i).Size();
+          double nk = mi ? firstinrow[blocks[i]+1] - firstinrow[blocks[i]] + 1 : 0;
+          costs[i] = 1 + mi*nk*nk;
+        }
+      block_dag = TaskDAG (block_dependency, costs);
+    }
+
     // genare micro-tasks:
     Array<int> first_microtask;
     for (int i = 0; i < blocks.Size()-1; i++)
@@ -511,14 +465,31 @@ namespace ngla
       micro_dependency = creator.MoveTable();
       micro_dependency_trans = creator_trans.MoveTable();
     }
+
+    // the solves run these for every right hand side
+    Array<double> costs(microtasks.Size());
+    for (int i : Range(microtasks))
+      {
+        auto & task = microtasks[i];
+        double nd = BlockDofs(task.blocknr).Size();
+        double next = nd ? BlockExtDofs(task.blocknr).Size() : 0;
+        if (task.type == MicroTask::B_BLOCK) 
+          costs[i] = 1 + nd * next / task.nbblocks;
+        else if (task.type == MicroTask::L_BLOCK)
+          costs[i] = 1 + nd * nd;
+        else
+          costs[i] = 1 + nd * (nd + next);
+      }
+    micro_dag = TaskDAG (micro_dependency, costs);
+    micro_dag_trans = TaskDAG (micro_dependency_trans, costs);
   }
   
 
 
 
 
-  template <class TM>
-  void SparseCholeskyTM<TM> :: 
+  template <class TM, class TMS>
+  void SparseCholeskyTM<TM,TMS> :: 
   FactorNew (const SparseMatrix<TM> & a)
   {
     static Timer tf("SparseCholesky - fill factor");
@@ -528,7 +499,7 @@ namespace ngla
 	cout << IM(4) << "SparseCholesky::FactorNew called with matrix of different size." << endl;
 	return;
       }
-    lfact = TM(0.0);
+    lfact = TMS(0.0);
 
     if (!inner && !cluster)
       ParallelFor 
@@ -575,8 +546,8 @@ namespace ngla
 
 
 
-  template <class TM>
-  void SparseCholeskyTM<TM> :: Factor () 
+  template <class TM, class TMS>
+  void SparseCholeskyTM<TM,TMS> :: Factor () 
   {
     static Timer factor_timer("SparseCholesky::Factor");
 
@@ -595,7 +566,7 @@ namespace ngla
     size_t * hfirstinrow = firstinrow.Addr(0);
     size_t * hfirstinrow_ri = firstinrow_ri.Addr(0);
     int * hrowindex2 = rowindex2.Addr(0);
-    TM * hlfact = lfact.Addr(0);
+    TMS * hlfact = lfact.Addr(0);
     
     // enum { BS = 4 };
     constexpr int BS=4;
@@ -636,7 +607,7 @@ namespace ngla
             for (int i2 = 0; i2 < jj; i2++)
               {
                 int firsti = hfirstinrow[i1+i2] + jj-i2;
-                TM * hli = hlfact+firsti;
+                TMS * hli = hlfact+firsti;
                 
                 TM q1 = - diag[i1+i2] * hli[-1];
                 TM qtrans1 = Trans (q1);  
@@ -894,16 +865,16 @@ namespace ngla
 
   
   /*
-  template <class TM>
-  void SparseCholeskyTM<TM> :: FactorSPD () 
+  template <class TM, class TMS>
+  void SparseCholeskyTM<TM,TMS> :: FactorSPD () 
   {
     throw Exception ("FactorSPD called for non-double matrix");
   }
   */
 
   // template <>
-  template <class TM>
-  void SparseCholeskyTM<TM> :: FactorSPD ()
+  template <class TM, class TMS>
+  void SparseCholeskyTM<TM,TMS> :: FactorSPD ()
   {
     Factor();
   }
@@ -919,9 +890,15 @@ namespace ngla
   {
     FactorSPD1(5.2);
   }
+
+  template <>
+  void SparseCholeskyTM<double,float> :: FactorSPD ()
+  {
+    FactorSPD1(5.3);
+  }
   
-  template <class TM> template<typename T>
-  void SparseCholeskyTM<TM> :: FactorSPD1 (T dummy) 
+  template <class TM, class TMS> template<typename T>
+  void SparseCholeskyTM<TM,TMS> :: FactorSPD1 (T dummy) 
   {
     if (!task_manager)
       {
@@ -953,7 +930,7 @@ namespace ngla
     size_t * hfirstinrow = firstinrow.Addr(0);
     size_t * hfirstinrow_ri = firstinrow_ri.Addr(0);
     int * hrowindex2 = rowindex2.Addr(0);
-    TM * hlfact = lfact.Addr(0);
+    TMS * hlfact = lfact.Addr(0);
     int percent = 0;
 
     // #define CHOLESKY_ORIGINAL
@@ -1016,7 +993,7 @@ namespace ngla
 	for (size_t j = 0; j < mi; j++)
 	  {
             tmp(j,j) = diag[i1+j];
-            tmp.Col(j).Range(j+1,nk) = FlatVector<TM>(nk-j-1, hlfact+hfirstinrow[i1+j]);
+            tmp.Col(j).Range(j+1,nk) = FlatVector<TMS>(nk-j-1, hlfact+hfirstinrow[i1+j]);
           }
 
         // factor_dense1.Stop();
@@ -1037,7 +1014,7 @@ namespace ngla
         auto write_back_row = [&](size_t j)
           {
             diag[i1+j] = A11(j,j);
-            FlatVector<TM>(nk-j-1, hlfact+hfirstinrow[i1+j]) = tmp.Col(j).Range(j+1,nk);
+            FlatVector<TMS>(nk-j-1, hlfact+hfirstinrow[i1+j]) = tmp.Col(j).Range(j+1,nk);
           };
 
         if (mi < 10)
@@ -1130,7 +1107,7 @@ namespace ngla
 	for (size_t j = 0; j < mi; j++)
 	  {
             tmp(j,j) = diag[i1+j];
-            tmp.Col(j).Range(j+1,nk) = FlatVector<TM>(nk-j-1, hlfact+hfirstinrow[i1+j]);
+            tmp.Col(j).Range(j+1,nk) = FlatVector<TMS>(nk-j-1, hlfact+hfirstinrow[i1+j]);
           }
 
         auto A11 = tmp.Rows(0,mi).Cols(0,mi);
@@ -1147,7 +1124,7 @@ namespace ngla
         for (size_t j = 0; j < mi; j++)
           {
             diag[i1+j] = A11(j,j);
-            FlatVector<TM>(nk-j-1, hlfact+hfirstinrow[i1+j]) = tmp.Col(j).Range(j+1,nk);
+            FlatVector<TMS>(nk-j-1, hlfact+hfirstinrow[i1+j]) = tmp.Col(j).Range(j+1,nk);
           };
 
 	// merge rows
@@ -1226,19 +1203,13 @@ namespace ngla
           }
     auto dep_transitive = creator_transitive.MoveTable();
     
-    TableCreator<int> creator_trans2(block_dependency.Size());
-    for ( ; !creator_trans2.Done(); creator_trans2++)
-      for (int i : Range(dep_transitive))
-        for (int j : dep_transitive[i])
-          creator_trans2.Add(j, i);
-    auto dep_transitive_trans = creator_trans2.MoveTable();
 
     static Timer tdep("paralleldep");
     static Timer tdep1("paralleldep1");
     static Timer tdep2("paralleldep2");
     
-    RunParallelDependency
-      (dep_transitive, dep_transitive_trans, [&] (int blocknr)
+    TaskDAG (dep_transitive).Run
+      ([&] (int blocknr)
        {
          // for (size_t blocknr : Range(blocks.Size()-1))
         IntRange block = BlockDofs(blocknr);
@@ -1259,7 +1230,7 @@ namespace ngla
 	for (size_t j = 0; j < mi; j++)
 	  {
             tmp(j,j) = diag[i1+j];
-            tmp.Col(j).Range(j+1,nk) = FlatVector<TM>(nk-j-1, hlfact+hfirstinrow[i1+j]);
+            tmp.Col(j).Range(j+1,nk) = FlatVector<TMS>(nk-j-1, hlfact+hfirstinrow[i1+j]);
           }
 
         auto A11 = tmp.Rows(0,mi).Cols(0,mi);
@@ -1279,7 +1250,7 @@ namespace ngla
         for (size_t j = 0; j < mi; j++)
           {
             diag[i1+j] = A11(j,j);
-            FlatVector<TM>(nk-j-1, hlfact+hfirstinrow[i1+j]) = tmp.Col(j).Range(j+1,nk);
+            FlatVector<TMS>(nk-j-1, hlfact+hfirstinrow[i1+j]) = tmp.Col(j).Range(j+1,nk);
           };
 
 	// merge rows
@@ -1335,18 +1306,6 @@ namespace ngla
 #ifdef CHOLESKY_PARALLEL_ATOMIC
     
     
-    // first, find the transposed graph
-    
-    TableCreator<int> creator_trans(block_dependency.Size());
-    for ( ; !creator_trans.Done(); creator_trans++)
-      // for (int i : Range(block_dependency))
-      ParallelFor (block_dependency.Size(), [&] (int i)
-                   {
-                     for (int j : block_dependency[i])
-                       creator_trans.Add(j, i);
-                   });
-    auto block_dep_trans = creator_trans.MoveTable();
-
     /*
     static Timer tdep("paralleldep");
     static Timer tdep0("paralleldep0");
@@ -1356,8 +1315,8 @@ namespace ngla
     */
     Array<MyMutex> locks(n);
     
-    RunParallelDependency
-      (block_dependency, block_dep_trans, [&] (int blocknr)
+    block_dag.Run
+      ([&] (int blocknr)
        {
         IntRange block = BlockDofs(blocknr);
         // RegionTracer reg(TaskManager::GetThreadId(), tdep, block.Size());
@@ -1379,7 +1338,7 @@ namespace ngla
 	for (size_t j = 0; j < mi; j++)
 	  {
             tmp(j,j) = diag[i1+j];
-            tmp.Col(j).Range(j+1,nk) = FlatVector<TM>(nk-j-1, hlfact+hfirstinrow[i1+j]);
+            tmp.Col(j).Range(j+1,nk) = FlatVector<TMS>(nk-j-1, hlfact+hfirstinrow[i1+j]);
           }
 
         auto A11 = tmp.Rows(0,mi).Cols(0,mi);
@@ -1399,7 +1358,7 @@ namespace ngla
         for (size_t j = 0; j < mi; j++)
           {
             diag[i1+j] = A11(j,j);
-            FlatVector<TM>(nk-j-1, hlfact+hfirstinrow[i1+j]) = tmp.Col(j).Range(j+1,nk);
+            FlatVector<TMS>(nk-j-1, hlfact+hfirstinrow[i1+j]) = tmp.Col(j).Range(j+1,nk);
           };
 
 	// merge rows
@@ -1504,8 +1463,8 @@ namespace ngla
   
 
 
-  template <class TM, class TV_ROW, class TV_COL>
-  void SparseCholesky<TM, TV_ROW, TV_COL> :: 
+  template <class TM, class TV_ROW, class TV_COL, class TMS>
+  void SparseCholesky<TM, TV_ROW, TV_COL, TMS> :: 
   Mult (const BaseVector & x, BaseVector & y) const
   {
     y = 0.0;
@@ -1518,8 +1477,8 @@ namespace ngla
   // template <>
   // void SparseCholesky<double, double, double> :: 
 
-  template <class TM, class TV_ROW, class TV_COL>
-  void SparseCholesky<TM, TV_ROW, TV_COL> :: 
+  template <class TM, class TV_ROW, class TV_COL, class TMS>
+  void SparseCholesky<TM, TV_ROW, TV_COL, TMS> :: 
   SolveBlock (int bnr, FlatVector<TV> hy) const
   {
     cerr << "general form of solveblock not implemented" << endl;
@@ -1561,8 +1520,8 @@ namespace ngla
   }
 
 
-  template <class TM, class TV_ROW, class TV_COL>
-  void SparseCholesky<TM, TV_ROW, TV_COL> :: 
+  template <class TM, class TV_ROW, class TV_COL, class TMS>
+  void SparseCholesky<TM, TV_ROW, TV_COL, TMS> :: 
   SolveBlockT (int bnr, FlatVector<TV> hy) const
   {
     cerr << "general form of solveblock not implemented" << endl;
@@ -1640,9 +1599,9 @@ namespace ngla
 
 
 
-  template <class TM, class TV_ROW, class TV_COL>
-  void SparseCholesky<TM, TV_ROW, TV_COL> :: 
-  SolveReordered (FlatVector<TVX> hy) const
+  template <class TM, class TV_ROW, class TV_COL, class TMS> template <typename TVXB>
+  void SparseCholesky<TM, TV_ROW, TV_COL, TMS> :: 
+  SolveReordered (FlatVector<TVXB> hy) const
   {
     static Timer timer1("SparseCholesky<d,d,d>::MultAdd fac1");
     static Timer timer2("SparseCholesky<d,d,d>::MultAdd fac2");
@@ -1718,8 +1677,7 @@ namespace ngla
     */
     timer1.Start();
 
-    RunParallelDependency (micro_dependency, micro_dependency_trans,
-                           [&,hy] (int nr) 
+    micro_dag.Run ([&,hy] (int nr) 
                            {
                              auto task = microtasks[nr];
                              size_t blocknr = task.blocknr;
@@ -1731,17 +1689,17 @@ namespace ngla
                                { // first L, then B
 
                                  auto extdofs = BlockExtDofs (blocknr);
-                                 VectorMem<520,TVX> temp(extdofs.Size());
+                                 VectorMem<520,TVXB> temp(extdofs.Size());
                                  temp = 0;
 
                                  for (auto i : range)
                                    {
-                                     TVX hyi = hy(i);
+                                     TVXB hyi = hy(i);
                                      
                                      size_t size = range.end()-i-1;
                                      if (size > 0)
                                        {
-                                         FlatVector<TM> vlfact(size, &lfact[firstinrow[i]]);
+                                         FlatVector<TMS> vlfact(size, &lfact[firstinrow[i]]);
                                          
                                          auto hyr = hy.Range(i+1, range.end());
                                          for (size_t j = 0; j < size; j++)
@@ -1753,7 +1711,7 @@ namespace ngla
                                          continue;
                                        }
                                      size_t first = firstinrow[i] + range.end()-i-1;
-                                     FlatVector<TM> ext_lfact (extdofs.Size(), &lfact[first]);
+                                     FlatVector<TMS> ext_lfact (extdofs.Size(), &lfact[first]);
                                      for (size_t j = 0; j < temp.Size(); j++)
                                        temp(j) += Trans(ext_lfact(j)) * hyi;
                                    }
@@ -1769,9 +1727,9 @@ namespace ngla
                                    {
                                      size_t size = range.end()-i-1;
                                      if (size == 0) continue;
-                                     FlatVector<TM> vlfact(size, &lfact[firstinrow[i]]);
+                                     FlatVector<TMS> vlfact(size, &lfact[firstinrow[i]]);
 
-                                     TVX hyi = hy(i);
+                                     TVXB hyi = hy(i);
                                      auto hyr = hy.Range(i+1, range.end());
                                      for (size_t j = 0; j < hyr.Size(); j++)
                                        hyr(j) -= Trans(vlfact(j)) * hyi;
@@ -1788,16 +1746,16 @@ namespace ngla
                                      auto myr = Range(all_extdofs).Split (task.bblock, task.nbblocks);
                                      auto extdofs = all_extdofs.Range(myr);
  
-                                     VectorMem<520,TVX> temp(extdofs.Size());
+                                     VectorMem<520,TVXB> temp(extdofs.Size());
                                      temp = 0;
                                      
                                      for (auto i : range)
                                        {
                                          size_t first = firstinrow[i] + range.end()-i-1;
                                          
-                                         FlatVector<TM> ext_lfact (all_extdofs.Size(), &lfact[first]);
+                                         FlatVector<TMS> ext_lfact (all_extdofs.Size(), &lfact[first]);
  
-                                         TVX hyi = hy(i);
+                                         TVXB hyi = hy(i);
                                          for (size_t j = 0; j < temp.Size(); j++)
                                            temp(j) += Trans(ext_lfact(myr.begin()+j)) * hyi;
                                        }
@@ -1816,7 +1774,7 @@ namespace ngla
     const TM * hdiag = &diag[0];
     ParallelFor (hy.Size(), [&] (int i)
                  {
-                   TVX tmp = hdiag[i] * hy[i];
+                   TVXB tmp = hdiag[i] * hy[i];
                    hy[i] = tmp;
                  });
 
@@ -1830,8 +1788,7 @@ namespace ngla
     */
 
     // advanced parallel version 
-    RunParallelDependency (micro_dependency_trans, micro_dependency,
-                           [&,hy] (int nr) 
+    micro_dag_trans.Run ([&,hy] (int nr) 
                            {
                              auto task = microtasks[nr];
                              int blocknr = task.blocknr;
@@ -1843,7 +1800,7 @@ namespace ngla
 
                                  auto extdofs = BlockExtDofs (blocknr);
                                  
-                                 VectorMem<520,TVX> temp(extdofs.Size());
+                                 VectorMem<520,TVXB> temp(extdofs.Size());
                                  for (auto j : Range(extdofs))
                                    temp(j) = hy(extdofs[j]);
 
@@ -1851,9 +1808,9 @@ namespace ngla
                                    for (auto i : range)
                                      {
                                        size_t first = firstinrow[i] + range.end()-i-1;
-                                       FlatVector<TM> ext_lfact (extdofs.Size(), &lfact[first]);
+                                       FlatVector<TMS> ext_lfact (extdofs.Size(), &lfact[first]);
                                        
-                                       TVX val(0.0);
+                                       TVXB val(0.0);
                                        for (auto j : Range(extdofs))
                                          val += ext_lfact(j) * temp(j);
                                        hy(i) -= val;
@@ -1862,10 +1819,10 @@ namespace ngla
                                    {
                                      size_t size = range.end()-i-1;
                                      if (size == 0) continue;
-                                     FlatVector<TM> vlfact(size, &lfact[firstinrow[i]]);
+                                     FlatVector<TMS> vlfact(size, &lfact[firstinrow[i]]);
                                      auto hyr = hy.Range(i+1, range.end());
 
-                                     TVX hyi = hy(i);
+                                     TVXB hyi = hy(i);
                                      for (size_t j = 0; j < vlfact.Size(); j++)
                                        hyi -= vlfact(j) * hyr(j);
                                      hy(i) = hyi;
@@ -1880,10 +1837,10 @@ namespace ngla
                                    {
                                      size_t size = range.end()-i-1;
                                      if (size == 0) continue;
-                                     FlatVector<TM> vlfact(size, &lfact[firstinrow[i]]);
+                                     FlatVector<TMS> vlfact(size, &lfact[firstinrow[i]]);
                                      auto hyr = hy.Range(i+1, range.end());
 
-                                     TVX hyi = hy(i);
+                                     TVXB hyi = hy(i);
                                      for (size_t j = 0; j < vlfact.Size(); j++)
                                        hyi -= vlfact(j) * hyr(j);
                                      hy(i) = hyi;
@@ -1900,16 +1857,16 @@ namespace ngla
                                      auto myr = Range(all_extdofs).Split (task.bblock, task.nbblocks);
                                      auto extdofs = all_extdofs.Range(myr);
                                      
-                                     VectorMem<520,TVX> temp(extdofs.Size());
+                                     VectorMem<520,TVXB> temp(extdofs.Size());
                                      for (auto j : Range(extdofs))
                                        temp(j) = hy(extdofs[j]);
     
                                      for (auto i : range)
                                        {
                                          size_t first = firstinrow[i] + range.end()-i-1;
-                                         FlatVector<TM> ext_lfact (all_extdofs.Size(), &lfact[first]);
+                                         FlatVector<TMS> ext_lfact (all_extdofs.Size(), &lfact[first]);
     
-                                         TVX val(0.0);
+                                         TVXB val(0.0);
                                          for (auto j : Range(extdofs))
                                            val += ext_lfact(myr.begin()+j) * temp(j);
                                          MyAtomicAdd (hy(i), -val);
@@ -1923,8 +1880,8 @@ namespace ngla
     
   }
 
-  template <class TM, class TV_ROW, class TV_COL>
-  void SparseCholesky<TM, TV_ROW, TV_COL> :: 
+  template <class TM, class TV_ROW, class TV_COL, class TMS>
+  void SparseCholesky<TM, TV_ROW, TV_COL, TMS> :: 
   MultAdd (TSCAL_VEC s, const BaseVector & x, BaseVector & y) const
   {
     static Timer timer("SparseCholesky<d,d,d>::MultAdd");
@@ -1984,8 +1941,66 @@ namespace ngla
   
 
 
-  template <class TM, class TV_ROW, class TV_COL>
-  void SparseCholesky<TM, TV_ROW, TV_COL> :: 
+  template <class TM, class TV_ROW, class TV_COL, class TMS>
+  void SparseCholesky<TM, TV_ROW, TV_COL, TMS> :: 
+  MultAdd (double s, const MultiVector & x, MultiVector & y) const
+  {
+    if constexpr (is_same<TVX, TSCAL_VEC>::value)
+      {
+        static Timer timer("SparseCholesky::MultAdd (MultiVector)");
+        RegionTimer reg (timer);
+        timer.AddFlops (2.0*lfact.Size()*x.Size());
+
+        // W vectors are interleaved, such that one sweep over the factor
+        // updates all of them with vector operations
+        IterateMultiVectorBlocks (x.Size(), [&] (size_t first, auto W)
+                                  {
+                                    constexpr int w = decltype(W)::value;
+                                    MultAddInterleaved<w> (s, x, y, first);
+                                  });
+      }
+    else
+      BaseMatrix::MultAdd (s, x, y);
+  }
+
+
+  template <class TM, class TV_ROW, class TV_COL, class TMS> template <int W>
+  void SparseCholesky<TM, TV_ROW, TV_COL, TMS> :: 
+  MultAddInterleaved (double s, const MultiVector & x, MultiVector & y, size_t first) const
+  {
+    typedef Vec<W,TVX> TVW;
+
+    Vector<TVW> hx(height);
+    x.GetInterleaved<W,TVX> (first, hx);
+
+    Vector<TVW> hy(this->nused);
+    ParallelFor (Range(height), [&] (int i)
+                 {
+                   if (order[i] != -1)
+                     hy(order[i]) = hx(i);
+                 });
+
+    SolveReordered<TVW> (hy);
+
+    ParallelFor (Range(height), [&] (int i)
+                 {
+                   bool use;
+                   if (inner)
+                     use = inner->Test(i);
+                   else if (cluster)
+                     use = (*cluster)[i] != 0;
+                   else
+                     use = order[i] != -1;
+                   hx(i) = use ? hy(order[i]) : TVW(0.0);
+                 });
+
+    y.AddInterleaved<W,TVX> (first, TVX(s), hx);
+  }
+
+
+
+  template <class TM, class TV_ROW, class TV_COL, class TMS>
+  void SparseCholesky<TM, TV_ROW, TV_COL, TMS> :: 
   Smooth (BaseVector & u, const BaseVector & f, BaseVector & y) const
   {
     static Timer t("SparseCholesky::Smooth");
@@ -2009,7 +2024,7 @@ namespace ngla
                    hy(i) = fy(inv_order[i]) - hmat.RowTimesVector(inv_order[i], fu);
                  });
     
-    SolveReordered(hy);
+    SolveReordered<TVX> (hy);
 
     ParallelFor (this->nused, [&] (int i)
                  {
@@ -2067,6 +2082,57 @@ namespace ngla
     matrix.lock()->MultAdd2 (-1, hvec2, y, inner.get(), cluster.get());
     }
   }
+
+
+
+  MixedPrecisionCholesky ::
+  MixedPrecisionCholesky (const SparseMatrixTM<double> & a, 
+                          shared_ptr<BitArray> ainner,
+                          shared_ptr<const Array<int>> acluster,
+                          double atol, int amaxsteps)
+    : SparseFactorization (a, ainner, acluster), mat(a),
+      tol(atol), maxsteps(amaxsteps)
+  {
+    factor = make_shared<SparseCholesky<double,double,double,float>> (a, ainner, acluster);
+  }
+
+  void MixedPrecisionCholesky ::
+  Mult (const BaseVector & f, BaseVector & x) const
+  {
+    static Timer t("MixedPrecisionCholesky::Mult");
+    RegionTimer reg(t);
+
+    auto r = f.CreateVector();
+    auto w = f.CreateVector();
+
+    factor->Mult (f, x);
+
+    // refine until the correction is below tol, or does not contract anymore
+    // since the residual reached the rounding level of the double precision matrix
+    double oldnorm = numeric_limits<double>::max();
+    int k = 0;
+    while (k < maxsteps)
+      {
+        r = f - mat * x;
+        factor->Mult (r, w);
+        x += w;
+        k++;
+
+        double normw = L2Norm (w);
+        if (normw <= tol * L2Norm (x) || normw > 0.5 * oldnorm)
+          break;
+        oldnorm = normw;
+      }
+    steps = k;
+  }
+
+  void MixedPrecisionCholesky ::
+  MultAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    auto hy = y.CreateVector();
+    Mult (x, hy);
+    y.Add (s, hy);
+  }
   
 
 
@@ -2086,8 +2152,8 @@ namespace ngla
 
 
 
-  template <class TM>
-  void SparseCholeskyTM<TM> :: Set (int i, int j, const TM & val)
+  template <class TM, class TMS>
+  void SparseCholeskyTM<TM,TMS> :: Set (int i, int j, const TM & val)
   {
     // *testout << "sparse cholesky, set (" << i << ", " << j << ") = " << val << endl;
     if (i == j)
@@ -2127,8 +2193,8 @@ namespace ngla
   }
 
 
-  template <class TM>
-  const TM & SparseCholeskyTM<TM> :: Get (int i, int j) const
+  template <class TM, class TMS>
+  TM SparseCholeskyTM<TM,TMS> :: Get (int i, int j) const
   {
     if (i == j)
       {
@@ -2149,17 +2215,17 @@ namespace ngla
       {
 	if (rowindex2[first_ri] == j)
 	  {
-	    return lfact[first];
+	    return TM(lfact[first]);
 	  }
 	first++;
 	first_ri++;
       }
     cerr << "Position " << i << ", " << j << " not found" << endl;
-    return *new TM;
+    return TM(0.0);
   }
 
-  template <class TM>
-  ostream & SparseCholeskyTM<TM> :: Print (ostream & ost) const
+  template <class TM, class TMS>
+  ostream & SparseCholeskyTM<TM,TMS> :: Print (ostream & ost) const
   {
     int n = Height();
 
@@ -2188,8 +2254,8 @@ namespace ngla
   }
 
 
-  template <class TM>
-  SparseCholeskyTM<TM> :: ~SparseCholeskyTM()
+  template <class TM, class TMS>
+  SparseCholeskyTM<TM,TMS> :: ~SparseCholeskyTM()
   {
     delete mdo;
   }
@@ -2204,6 +2270,8 @@ namespace ngla
 
   template class SparseCholeskyTM<double>;
   template class SparseCholeskyTM<Complex>;
+  template class SparseCholeskyTM<double,float>;
+  template class SparseCholesky<double,double,double,float>;
 
 #if MAX_SYS_DIM >= 1
   template class SparseCholesky<Mat<1,1,double> >;
@@ -50,13 +50,20 @@ namespace ngla
   /**
      A sparse cholesky factorization.
      The unknowns are reordered by the minimum degree
-     ordering algorithm
+     ordering algorithm, or by nested dissection for
+     inverse type 'sparsecholesky_nd'
 
      computs A = L D L^t
      L is stored column-wise
+
+     The entries of L are stored as TMS, which may be of lower
+     precision than the matrix (TMS = float, see MixedPrecisionCholesky).
+     Dense frontal matrices are factored in the precision of TM, but
+     their Schur-complement updates are added to the stored entries of
+     later rows, so with TMS = float they are rounded at every update.
   */
 
-  template<class TM>
+  template<class TM, class TMS = TM>
 	   // class TV_ROW = typename mat_traits<TM>::TV_ROW, 
 	   // class TV_COL = typename mat_traits<TM>::TV_COL>
   class NGS_DLL_HEADER SparseCholeskyTM : public SparseFactorization
@@ -75,7 +82,7 @@ namespace ngla
     
     // L-factor in compressed storage
     // Array<TM, size_t> lfact;
-    NumaInterleavedArray<TM> lfact;
+    NumaInterleavedArray<TMS> lfact;
 
     // index-array to lfact
     Array<size_t> firstinrow;
@@ -98,6 +105,7 @@ namespace ngla
 
     // dependency graph for elimination
     Table<int> block_dependency; 
+    TaskDAG block_dag;
 
   public:      // needed for gcc 4.9, why  ??? 
     class MicroTask
@@ -114,6 +122,7 @@ namespace ngla
     Array<MicroTask> microtasks;
     Table<int> micro_dependency;     
     Table<int> micro_dependency_trans;     
+    TaskDAG micro_dag, micro_dag_trans;
 
 
     //
@@ -122,6 +131,12 @@ namespace ngla
     // maximal non-zero entries in a column
     int maxrow;
 
+    // statistics: ordering algorithm, flop count of the factorization, wall times
+    string ordering = "minimum degree";
+    double flops = 0;
+    double ordering_time = 0;
+    double factor_time = 0;
+
     // the original matrix
     const SparseMatrixTM<TM> & mat;
 
@@ -174,14 +189,22 @@ namespace ngla
 
     virtual Array<MemoryUsage> GetMemoryUsage () const
     {
-      return { MemoryUsage ("SparseChol", nze*sizeof(TM), 1) };
+      return { MemoryUsage ("SparseChol", nze*sizeof(TMS), 1) };
     }
 
     virtual size_t NZE () const { return nze; }
+    /// name of the fill-reducing ordering
+    const string & GetOrdering () const { return ordering; }
+    /// floating point operations of the numerical factorization
+    double GetFlops () const { return flops; }
+    ///
+    double GetOrderingTime () const { return ordering_time; }
+    ///
+    double GetFactorTime () const { return factor_time; }
     ///
     void Set (int i, int j, const TM & val);
     ///
-    const TM & Get (int i, int j) const;
+    TM Get (int i, int j) const;
     ///
     void SetOrig (int i, int j, const TM & val)
     { Set (order[i], order[j], val); }
@@ -206,10 +229,11 @@ namespace ngla
 
   template<class TM, 
 	   class TV_ROW = typename mat_traits<TM>::TV_ROW, 
-	   class TV_COL = typename mat_traits<TM>::TV_COL>
-  class NGS_DLL_HEADER SparseCholesky : public SparseCholeskyTM<TM>
+	   class TV_COL = typename mat_traits<TM>::TV_COL,
+           class TMS = TM>
+  class NGS_DLL_HEADER SparseCholesky : public SparseCholeskyTM<TM,TMS>
   {
-    typedef SparseCholeskyTM<TM> BASE;
+    typedef SparseCholeskyTM<TM,TMS> BASE;
     using BASE::height;
     using BASE::Height;
     using BASE::inner;
@@ -227,6 +251,9 @@ namespace ngla
     using BASE::micro_dependency;
     using BASE::micro_dependency_trans;
     using BASE::block_dependency;
+    using BASE::block_dag;
+    using BASE::micro_dag;
+    using BASE::micro_dag_trans;
     using BASE::BlockDofs;
     using BASE::BlockExtDofs;
   public:
@@ -239,11 +266,13 @@ namespace ngla
 		    shared_ptr<BitArray> ainner = nullptr,
 		    shared_ptr<const Array<int>> acluster = nullptr,
 		    bool allow_refactor = 0)
-      : SparseCholeskyTM<TM> (a, ainner, acluster, allow_refactor) { ; }
+      : SparseCholeskyTM<TM,TMS> (a, ainner, acluster, allow_refactor) { ; }
 
     ///
     virtual ~SparseCholesky () { ; }
     
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     virtual void Mult (const BaseVector & x, BaseVector & y) const;
 
     virtual void MultAdd (TSCAL_VEC s, const BaseVector & x, BaseVector & y) const;
@@ -252,6 +281,9 @@ namespace ngla
       MultAdd (s, x, y);
     }
 
+    /// forward/backward substitution for blocks of vectors, the factor is read once per block
+    virtual void MultAdd (double s, const MultiVector & x, MultiVector & y) const override;
+
     virtual AutoVector CreateVector () const
     {
       return make_shared<VVector<TV>> (height);
@@ -262,7 +294,65 @@ namespace ngla
     void SolveBlock (int i, FlatVector<TV> hy) const;
     void SolveBlockT (int i, FlatVector<TV> hy) const;
   private:
-    void SolveReordered(FlatVector<TVX> hy) const;
+    template <typename TVXB>
+    void SolveReordered(FlatVector<TVXB> hy) const;
+    template <int W>
+    void MultAddInterleaved (double s, const MultiVector & x, MultiVector & y, size_t first) const;
+  };
+
+
+
+  /**
+     Mixed precision direct solver.
+     The sparse Cholesky factor C is stored in single precision,
+     the solution is improved by iterative refinement in double precision:
+     
+       x += C^{-1} (f - A x)
+       
+     until the correction is below tol * |x|. This needs half of the memory
+     and memory bandwidth of the double precision factor.
+     Factor entries are accumulated in single precision (rounded at every
+     Schur-complement update), only the dense frontal factorizations run
+     in double. The refinement recovers double precision accuracy as long
+     as the single precision factor is a good enough preconditioner.
+  */
+  class NGS_DLL_HEADER MixedPrecisionCholesky : public SparseFactorization
+  {
+    const SparseMatrixTM<double> & mat;
+    shared_ptr<SparseCholesky<double,double,double,float>> factor;
+    double tol;
+    int maxsteps;
+    mutable int steps = 0;
+  public:
+    MixedPrecisionCholesky (const SparseMatrixTM<double> & a, 
+                            shared_ptr<BitArray> ainner = nullptr,
+                            shared_ptr<const Array<int>> acluster = nullptr,
+                            double atol = 1e-14, int amaxsteps = 20);
+
+    virtual int VHeight() const { return mat.Height(); }
+    virtual int VWidth() const { return mat.Height(); }
+    virtual bool IsComplex() const { return false; }
+
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
+    virtual void Mult (const BaseVector & x, BaseVector & y) const;
+    virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const;
+    virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
+    {
+      MultAdd (s, x, y);
+    }
+
+    virtual AutoVector CreateVector () const { return factor->CreateVector(); }
+
+    virtual Array<MemoryUsage> GetMemoryUsage () const { return factor->GetMemoryUsage(); }
+    virtual size_t NZE () const { return factor->NZE(); }
+
+    /// the single precision factorization
+    shared_ptr<SparseCholesky<double,double,double,float>> GetFactor () const { return factor; }
+    /// refinement steps of the last solve
+    int GetSteps () const { return steps; }
+    void SetTolerance (double atol) { tol = atol; }
+    void SetMaxSteps (int amaxsteps) { maxsteps = amaxsteps; }
   };
 
 
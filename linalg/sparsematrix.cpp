@@ -112,6 +112,18 @@ namespace ngla
       {
 	firsti.Swap (graph.firsti);
 	colnr.Swap (graph.colnr);
+        shared_graph = graph.shared_graph;
+        ccolnr.Swap (graph.ccolnr);
+        cfirsti.Swap (graph.cfirsti);
+        compressed = graph.compressed;
+        graph.compressed = false;
+      }
+    else if (graph.shared_graph)
+      {
+        // the index arrays are immutable, no need for a copy
+        shared_graph = graph.shared_graph;
+        static_cast<Array<size_t>&> (firsti) = Array<size_t> (size+1, shared_graph->firsti, false);
+        static_cast<Array<int>&> (colnr) = Array<int> (shared_graph->colnr.Size(), shared_graph->colnr, false);
       }
     else
       {
@@ -128,6 +140,19 @@ namespace ngla
     CalcBalancing ();
   }
 
+  MatrixGraph :: MatrixGraph (shared_ptr<const MatrixGraph> graph)
+  {
+    shared_graph = graph->shared_graph ? graph->shared_graph : graph;
+    size = graph->size;
+    width = graph->width;
+    nze = graph->nze;
+    owner = false;
+
+    static_cast<Array<size_t>&> (firsti) = Array<size_t> (size+1, shared_graph->firsti, false);
+    static_cast<Array<int>&> (colnr) = Array<int> (shared_graph->colnr.Size(), shared_graph->colnr, false);
+    CalcBalancing ();
+  }
+
 
 
   /*
@@ -999,6 +1024,63 @@ namespace ngla
   {
     cout << "compress not implemented" << endl; 
   }
+
+  void MatrixGraph :: CompressIndices ()
+  {
+    static Timer timer ("MatrixGraph::CompressIndices");
+    RegionTimer reg (timer);
+
+    auto words = [this] (int row)
+      {
+        auto cols = GetRowIndices(row);
+        if (cols.Size() == 0) return size_t(0);
+        size_t cnt = 2;
+        for (size_t j = 1; j < cols.Size(); j++)
+          {
+            int64_t d = int64_t(cols[j]) - cols[0];
+            cnt += (d >= 0 && d < cescape) ? 1 : 3;
+          }
+        return cnt;
+      };
+    
+    cfirsti.SetSize (size+1);
+    ParallelFor (size, [&] (int row) { cfirsti[row+1] = words(row); });
+    cfirsti[0] = 0;
+    for (int i = 0; i < size; i++)
+      cfirsti[i+1] += cfirsti[i];
+
+    ccolnr.SetSize (cfirsti[size]);
+    ParallelFor (size, [&] (int row)
+                 {
+                   auto cols = GetRowIndices(row);
+                   if (cols.Size() == 0) return;
+                   uint16_t * p = ccolnr.Addr(cfirsti[row]);
+                   unsigned col0 = unsigned(cols[0]);
+                   *p++ = col0 & 0xFFFF;
+                   *p++ = col0 >> 16;
+                   for (size_t j = 1; j < cols.Size(); j++)
+                     {
+                       int64_t d = int64_t(cols[j]) - cols[0];
+                       if (d >= 0 && d < cescape)
+                         *p++ = uint16_t(d);
+                       else
+                         {
+                           unsigned col = unsigned(cols[j]);
+                           *p++ = cescape;
+                           *p++ = col & 0xFFFF;
+                           *p++ = col >> 16;
+                         }
+                     }
+                 });
+    compressed = true;
+  }
+
+  void MatrixGraph :: UncompressIndices ()
+  {
+    compressed = false;
+    ccolnr.DeleteAll();
+    cfirsti.DeleteAll();
+  }
   
 
   /// returns position of Element (i, j), exception for unused
@@ -1089,6 +1171,7 @@ namespace ngla
       {
 	if (colnr[k] == -1)
 	  {
+            if (compressed) UncompressIndices();
 	    colnr[k] = j;
 	    return k;
 	  }
@@ -1100,6 +1183,7 @@ namespace ngla
 	    if (colnr[firsti[i+1]-1] != -1)
 	      throw Exception ("sparse matrix row full 1 !");
 	    
+            if (compressed) UncompressIndices();
 	    for (size_t l = firsti[i+1]-1; l > k; l--)
 	      colnr[l] = colnr[l-1];
 
@@ -1166,6 +1250,29 @@ namespace ngla
 
   
   
+  void MatrixGraph :: 
+  GetPositionsSorted (int row, FlatArray<int> cols, FlatArray<size_t> pos) const
+  {
+    size_t n = cols.Size();
+    if (n == 0) return;
+
+    size_t i = 0;
+    auto match = [&] (size_t k, int col)
+      {
+        while (i < n && cols[i] == col)
+          pos[i++] = k;
+      };
+    
+    if (compressed)
+      IterateCompressedRow (row, match);
+    else
+      for (size_t k = firsti[row]; k < firsti[row+1] && i < n; k++)
+        match (k, colnr[k]);
+
+    if (i < n)
+      throw Exception ("GetPositionSorted: not matching");
+  }
+
   template <typename Tarray>
   int BinSearch(const Tarray & v, size_t i) {
     int n = v.Size();
@@ -1186,6 +1293,21 @@ namespace ngla
   }
   
 
+  bool MatrixGraph :: SameGraph (const MatrixGraph & graph2) const
+  {
+    if (size != graph2.size || width != graph2.width || nze != graph2.nze)
+      return false;
+    if ((const int*)colnr == (const int*)graph2.colnr &&
+        (const size_t*)firsti == (const size_t*)graph2.firsti)
+      return true;
+
+    for (int i = 0; i <= size; i++)
+      if (firsti[i] != graph2.firsti[i]) return false;
+    for (size_t i = 0; i < nze; i++)
+      if (colnr[i] != graph2.colnr[i]) return false;
+    return true;
+  }
+
   void MatrixGraph :: CalcBalancing ()
   {
     static Timer timer ("MatrixGraph - CalcBalancing");
@@ -1231,7 +1353,18 @@ namespace ngla
 
   Array<MemoryUsage> MatrixGraph :: GetMemoryUsage () const
   {
-    return { { "MatrixGraph", (nze+size)*sizeof(int), 1 } };
+    Array<MemoryUsage> mu;
+    mu += { shared_graph ? "MatrixGraph (shared)" : "MatrixGraph",
+        nze*sizeof(int) + (size+1)*sizeof(size_t), 2 };
+    if (compressed)
+      mu += { "MatrixGraph compressed", ccolnr.Size()*sizeof(uint16_t) + cfirsti.Size()*sizeof(size_t), 2 };
+    // index bytes streamed by one matrix-vector product (no allocation, 0 blocks),
+    // also for symmetric matrices, which use each row for both triangles
+    size_t traffic = compressed ?
+      ccolnr.Size()*sizeof(uint16_t) + 2*(size+1)*sizeof(size_t) :
+      nze*sizeof(int) + (size+1)*sizeof(size_t);
+    mu += { "MatrixGraph index traffic per SpMV", traffic, 0 };
+    return mu;
   }
 
 
@@ -1247,6 +1380,22 @@ namespace ngla
     ;
   }
 
+  shared_ptr<BaseSparseMatrix> BaseSparseMatrix ::
+  CreateLinearCombination (double a, double b, const BaseSparseMatrix & m2) const
+  {
+    static Timer t("BaseSparseMatrix::CreateLinearCombination"); RegionTimer reg(t);
+    
+    const BaseVector & v1 = AsVector();
+    const BaseVector & v2 = m2.AsVector();
+    if (v1.Size() != v2.Size() || v1.IsComplex() != v2.IsComplex() || !SameGraph(m2))
+      throw Exception ("BaseSparseMatrix::CreateLinearCombination: matrices differ in graph or type");
+
+    // copies share the graph, only the values are allocated
+    auto sum = dynamic_pointer_cast<BaseSparseMatrix> (CreateMatrix());
+    sum->AsVector() = a * v1 + b * v2;
+    return sum;
+  }
+
   INVERSETYPE BaseSparseMatrix ::
   SetInverseType (string ainversetype) const
   {
@@ -1259,11 +1408,13 @@ namespace ngla
     else if (ainversetype == "mumps")         SetInverseType ( MUMPS );
     else if (ainversetype == "masterinverse") SetInverseType ( MASTERINVERSE );
     else if (ainversetype == "sparsecholesky") SetInverseType ( SPARSECHOLESKY );
+    else if (ainversetype == "sparsecholesky_nd") SetInverseType ( SPARSECHOLESKY_ND );
+    else if (ainversetype == "sparsecholesky_mixed") SetInverseType ( SPARSECHOLESKY_MIXED );
     else if (ainversetype == "umfpack")       SetInverseType ( UMFPACK );
     else
       {
         throw Exception (ToString("undefined inverse ")+ainversetype+
-                         "\nallowed is: 'sparsecholesky', 'pardiso', 'pardisospd', 'mumps', 'masterinverse', 'umfpack'");
+                         "\nallowed is: 'sparsecholesky', 'sparsecholesky_nd', 'sparsecholesky_mixed', 'pardiso', 'pardisospd', 'mumps', 'masterinverse', 'umfpack'");
       }
     return old_invtype;
   }
@@ -1334,6 +1485,35 @@ namespace ngla
       // .AddSize(mat_traits<TM>::HEIGHT*dnums1.Size(),
       // mat_traits<TM>::WIDTH*dnums2.Size()));
 
+    if (this->compressed)
+      {
+        STACK_ARRAY(int, hcols, dnums2.Size());
+        STACK_ARRAY(int, hjs, dnums2.Size());
+        STACK_ARRAY(size_t, hpos, dnums2.Size());
+        int nc = 0;
+        for (int j1 = 0; j1 < dnums2.Size(); j1++)
+          if (IsRegularIndex(dnums2[map[j1]]))
+            {
+              hjs[nc] = map[j1];
+              hcols[nc] = dnums2[map[j1]];
+              nc++;
+            }
+        FlatArray<int> cols(nc, hcols);
+        FlatArray<size_t> pos(nc, hpos);
+        
+        for (int i = 0; i < dnums1.Size(); i++)
+          if (IsRegularIndex(dnums1[i]))
+            {
+              this->GetPositionsSorted (dnums1[i], cols, pos);
+              for (int l = 0; l < nc; l++)
+                if (use_atomic)
+                  MyAtomicAdd (data[pos[l]], elmat(i,hjs[l]));
+                else
+                  data[pos[l]] += elmat(i,hjs[l]);
+            }
+        return;
+      }
+    
     for (int i = 0; i < dnums1.Size(); i++)
       if (IsRegularIndex(dnums1[i]))
 	{
@@ -1424,6 +1604,42 @@ namespace ngla
 
   }
 
+  template <class TM, class TV_ROW, class TV_COL>
+  void SparseMatrix<TM,TV_ROW,TV_COL> ::
+  MultAdd (double s, const MultiVector & x, MultiVector & y) const
+  {
+    if constexpr (is_same<TVX,TM>::value && is_same<TVY,TM>::value)
+      {
+        static Timer t("SparseMatrix::MultAdd (MultiVector)"); RegionTimer reg(t);
+        t.AddFlops (this->NZE()*x.Size());
+
+        IterateMultiVectorBlocks
+          (x.Size(), [&] (size_t first, auto W)
+           {
+             constexpr int w = decltype(W)::value;
+             typedef Vec<w,TM> TVW;
+
+             Vector<TVW> hx(this->Width()), hy(this->Height());
+             x.GetInterleaved<w,TM> (first, hx);
+
+             ParallelForRange (balance, [&] (IntRange rows)
+                               {
+                                 for (auto row : rows)
+                                   {
+                                     TVW sum(0.0);
+                                     for (size_t j = firsti[row]; j < firsti[row+1]; j++)
+                                       sum += data[j] * hx(colnr[j]);
+                                     hy(row) = sum;
+                                   }
+                               });
+
+             y.AddInterleaved<w,TM> (first, TM(s), hy);
+           });
+      }
+    else
+      BaseMatrix::MultAdd (s, x, y);
+  }
+
   template <class TM, class TV_ROW, class TV_COL>
   void SparseMatrix<TM,TV_ROW,TV_COL> ::
   MultAdd1 (double s, const BaseVector & x, BaseVector & y,
@@ -1448,6 +1664,24 @@ namespace ngla
               fy(row) += s * RowTimesVector (row, fx);
         });
   }
+
+  template <class TM, class TV_ROW, class TV_COL>
+  bool SparseMatrix<TM,TV_ROW,TV_COL> ::
+  MultAddRows (double s, const BaseVector & x, BaseVector & y,
+               FlatArray<int> rows) const
+  {
+    static Timer t("SparseMatrix::MultAddRows"); RegionTimer reg(t);
+
+    FlatVector<TVX> fx = x.FV<TVX>(); 
+    FlatVector<TVY> fy = y.FV<TVY>(); 
+
+    ParallelForRange (rows.Size(), [&] (IntRange r)
+                      {
+                        for (auto row : rows.Range(r))
+                          fy(row) += s * RowTimesVector (row, fx);
+                      });
+    return true;
+  }
   
   
 
@@ -1570,6 +1804,13 @@ namespace ngla
 	throw Exception ("SparseMatrix::InverseMatrix: MumpsInverse not available");
 #endif
       }
+    else if (  BaseSparseMatrix :: GetInverseType()  == SPARSECHOLESKY_MIXED)
+      {
+        if constexpr (is_same<TM,double>::value && is_same<TV_ROW,double>::value && is_same<TV_COL,double>::value)
+          return make_shared<MixedPrecisionCholesky> (*this, subset);
+        else
+          throw Exception ("SparseMatrix::InverseMatrix:  sparsecholesky_mixed is available for real matrices only");
+      }
     else
       return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, subset);
     //#endif
@@ -1630,6 +1871,13 @@ namespace ngla
 	throw Exception ("SparseMatrix::InverseMatrix:  MumpsInverse not available");
 #endif
       }
+    else if (  BaseSparseMatrix :: GetInverseType()  == SPARSECHOLESKY_MIXED)
+      {
+        if constexpr (is_same<TM,double>::value && is_same<TV_ROW,double>::value && is_same<TV_COL,double>::value)
+          return make_shared<MixedPrecisionCholesky> (*this, nullptr, clusters);
+        else
+          throw Exception ("SparseMatrix::InverseMatrix:  sparsecholesky_mixed is available for real matrices only");
+      }
     else
       {
         return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, nullptr, clusters);
@@ -1660,7 +1908,7 @@ namespace ngla
   {
     Array<MemoryUsage> mu;
     mu += { "SparseMatrix", nze*sizeof(TM), 1 };
-    if (owner) mu += MatrixGraph::GetMemoryUsage ();
+    if (owner || compressed) mu += MatrixGraph::GetMemoryUsage ();
     return mu;
   }
 
@@ -1707,6 +1955,11 @@ namespace ngla
     static Timer tbuild ("sparsematrix - restrict, build matrix");
     static Timer tcomp ("sparsematrix - restrict, compute matrix");
     RegionTimer reg(t);
+
+    // no graph to re-use: fused parallel triple product
+    if constexpr (is_same<SparseMatrix<TM>, SparseMatrix<TM,TV_ROW,TV_COL>>::value)
+      if (!acmat)
+        return MatRAP (*TransposeMatrix(prol), *this, prol);
     
     int n = this->Height();
 
@@ -1864,6 +2117,24 @@ namespace ngla
 
     int first_used = 0;
     while (first_used < dnums.Size() && !IsRegularIndex(dnums[map[first_used]]) ) first_used++;
+
+    if (this->compressed)
+      {
+        STACK_ARRAY(size_t, hpos, dnums.Size());
+        for (int i1 = first_used; i1 < dnums.Size(); i1++)
+          {
+            FlatArray<int> cols(i1+1-first_used, &dnumsmap[first_used]);
+            FlatArray<size_t> pos(cols.Size(), hpos);
+            this->GetPositionsSorted (dnumsmap[i1], cols, pos);
+            auto elmat_row = elmat.Rows(map[i1], map[i1]+1);
+            for (int j1 = first_used; j1 <= i1; j1++)
+              if (use_atomic)
+                MyAtomicAdd (data[pos[j1-first_used]], elmat_row(0, map[j1]));
+              else
+                data[pos[j1-first_used]] += elmat_row(0, map[j1]);
+          }
+        return;
+      }
     
     if (use_atomic)
       for (int i1 = first_used; i1 < dnums.Size(); i1++)
@@ -1949,13 +2220,226 @@ namespace ngla
     const FlatVector<TV_ROW> fx = x.FV<TV_ROW>();
     FlatVector<TV_COL> fy = y.FV<TV_COL>();
 
+    if (task_manager && this->balance.Size() > 1)
+      {
+        // buffers are shared, concurrent calls fall back to the sequential version
+        unique_lock<mutex> guard(buffer_mutex, try_to_lock);
+        if (guard.owns_lock())
+          {
+            SetupParallelBuffers();
+            buffer.SetSize (buffer_cols.Size());
+            MultAddParallel<TV> (s, fx, fy, buffer);
+            return;
+          }
+      }
+    
+    // lower triangle and its transpose from one pass over the (compressed) indices
     for (int i = 0; i < this->Height(); i++)
       {
-	fy(i) += s * RowTimesVector (i, fx);
-	AddRowTransToVectorNoDiag (i, s * fx(i), fy);
+        TV_COL sum(0.0);
+        TV_COL el = s * fx(i);
+        this->IterateRow (i, [&] (size_t j, int col)
+                          {
+                            sum += data[j] * fx(col);
+                            if (col != i)
+                              fy(col) += Trans(data[j]) * el;
+                          });
+	fy(i) += s * sum;
+      }
+  }
+
+
+  // first position in the sorted array a with a[pos] >= val
+  INLINE size_t LowerBound (FlatArray<int> a, int val)
+  {
+    size_t lo = 0, hi = a.Size();
+    while (lo < hi)
+      {
+        size_t mid = (lo+hi)/2;
+        if (a[mid] < val) lo = mid+1; else hi = mid;
+      }
+    return lo;
+  }
+
+  /*
+    Rows are distributed according to the balancing of the graph. Part p
+    adds the transposed lower triangle directly into y for columns within
+    its own rows, columns before its first row go to a part-private buffer.
+    The buffer has one slot per distinct such column, so it only covers the
+    coupling to earlier parts, and not the whole range before the part.
+    In a second sweep every part collects the buffered contributions to
+    its own rows, so no atomics are needed.
+   */
+  template <class TM, class TV>
+  void SparseMatrixSymmetric<TM,TV> :: SetupParallelBuffers () const
+  {
+    static Timer tsetup("SparseMatrixSymmetric::MultAdd - setup buffers");
+
+    const Partitioning & part = this->balance;
+    size_t nparts = part.Size();
+
+    if (buffer_offset.Size() != nparts+1)
+      {
+        RegionTimer reg(tsetup);
+        buffer_offset.SetSize (nparts+1);
+        slot_offset.SetSize (nparts+1);
+        Array<Array<int>> partcols(nparts);
+
+        ParallelFor (nparts, [&] (size_t p)
+                     {
+                       size_t first_row = part[p].First();
+                       Array<int> & cols = partcols[p];
+                       for (auto row : part[p])
+                         for (auto col : this->GetRowIndices(row))
+                           if (size_t(col) < first_row)
+                             cols.Append (col);
+                       slot_offset[p+1] = cols.Size();
+
+                       QuickSort (cols);
+                       size_t n = 0;
+                       for (size_t i = 0; i < cols.Size(); i++)
+                         if (n == 0 || cols[i] != cols[n-1])
+                           cols[n++] = cols[i];
+                       cols.SetSize (n);
+                       buffer_offset[p+1] = n;
+                     });
+
+        buffer_offset[0] = 0;
+        slot_offset[0] = 0;
+        for (size_t p = 0; p < nparts; p++)
+          {
+            buffer_offset[p+1] += buffer_offset[p];
+            slot_offset[p+1] += slot_offset[p];
+          }
+        buffer_cols.SetSize (buffer_offset[nparts]);
+        buffer_slot.SetSize (slot_offset[nparts]);
+
+        ParallelFor (nparts, [&] (size_t p)
+                     {
+                       FlatArray<int> pcols = buffer_cols.Range (buffer_offset[p], buffer_offset[p+1]);
+                       pcols = partcols[p];
+                       size_t first_row = part[p].First();
+                       size_t k = slot_offset[p];
+                       for (auto row : part[p])
+                         for (auto col : this->GetRowIndices(row))
+                           if (size_t(col) < first_row)
+                             buffer_slot[k++] = LowerBound (pcols, col);
+                     });
       }
   }
 
+  // buf holds the part-private values, one per buffered column
+  template <class TM, class TV> template <typename TVEC>
+  void SparseMatrixSymmetric<TM,TV> :: 
+  MultAddParallel (double s, FlatVector<TVEC> fx, FlatVector<TVEC> fy, FlatArray<TVEC> buf) const
+  {
+    static Timer tmult("SparseMatrixSymmetric::MultAdd - rows");
+    static Timer tsum("SparseMatrixSymmetric::MultAdd - sum buffers");
+
+    const Partitioning & part = this->balance;
+    size_t nparts = part.Size();
+
+    tmult.Start();
+    task_manager -> CreateJob
+      ([&] (TaskInfo & ti)
+       {
+         size_t p = ti.task_nr;
+         size_t first_row = part[p].First();
+         FlatArray<TVEC> mybuffer = buf.Range (buffer_offset[p], buffer_offset[p+1]);
+         const int * slot = buffer_slot.Addr (slot_offset[p]);
+         mybuffer = TVEC(0.0);
+
+         for (auto row : part[p])
+           {
+             // both halves from one pass, compressed indices are decoded once
+             TVEC sum(0.0);
+             TVEC el = s * fx(row);
+             this->IterateRow (row, [&] (size_t j, int col)
+                               {
+                                 sum += data[j] * fx(col);
+                                 if (size_t(col) == row) return;
+                                 if (size_t(col) >= first_row)
+                                   fy(col) += Trans(data[j]) * el;
+                                 else
+                                   mybuffer[*slot++] += Trans(data[j]) * el;
+                               });
+             fy(row) += s * sum;
+           }
+       }, nparts);
+    tmult.Stop();
+
+    RegionTimer reg(tsum);
+    task_manager -> CreateJob
+      ([&] (TaskInfo & ti)
+       {
+         IntRange myrows = part[ti.task_nr];
+         for (size_t p = ti.task_nr+1; p < nparts; p++)
+           {
+             FlatArray<int> pcols = buffer_cols.Range (buffer_offset[p], buffer_offset[p+1]);
+             FlatArray<TVEC> pbuffer = buf.Range (buffer_offset[p], buffer_offset[p+1]);
+             for (size_t i = LowerBound (pcols, int(myrows.First()));
+                  i < pcols.Size() && size_t(pcols[i]) < myrows.Next(); i++)
+               fy(pcols[i]) += pbuffer[i];
+           }
+       }, nparts);
+  }
+
+  template <class TM, class TV>
+  void SparseMatrixSymmetric<TM,TV> :: 
+  MultAdd (double s, const MultiVector & x, MultiVector & y) const
+  {
+    if constexpr (is_same<TV,TM>::value)
+      {
+        static Timer t("SparseMatrixSymmetric::MultAdd (MultiVector)"); RegionTimer reg(t);
+        t.AddFlops (2*this->NZE()*x.Size());
+
+        bool parallel = task_manager && this->balance.Size() > 1;
+        if (parallel)
+          {
+            // the index buffers are shared, the value buffers are per call
+            lock_guard<mutex> guard(buffer_mutex);
+            SetupParallelBuffers();
+          }
+
+        IterateMultiVectorBlocks
+          (x.Size(), [&] (size_t first, auto W)
+           {
+             constexpr int w = decltype(W)::value;
+             typedef Vec<w,TM> TVW;
+
+             Vector<TVW> hx(this->Width()), hy(this->Height());
+             x.GetInterleaved<w,TM> (first, hx);
+             hy = TVW(0.0);
+
+             if (parallel)
+               {
+                 Array<TVW> buf(buffer_cols.Size());
+                 MultAddParallel<TVW> (1, hx, hy, buf);
+                 y.AddInterleaved<w,TM> (first, TM(s), hy);
+                 return;
+               }
+
+             // lower triangle and its transpose in the same sweep
+             for (size_t i = 0; i < this->Height(); i++)
+               {
+                 TVW sum(0.0);
+                 TVW xi = hx(i);
+                 this->IterateRow (i, [&] (size_t j, int col)
+                                   {
+                                     sum += data[j] * hx(col);
+                                     if (size_t(col) != i)
+                                       hy(col) += data[j] * xi;
+                                   });
+                 hy(i) += sum;
+               }
+
+             y.AddInterleaved<w,TM> (first, TM(s), hy);
+           });
+      }
+    else
+      BaseMatrix::MultAdd (s, x, y);
+  }
+
   template <class TM, class TV>
   void SparseMatrixSymmetric<TM,TV> :: 
   MultAdd1 (double s, const BaseVector & x, BaseVector & y,
@@ -2038,9 +2522,42 @@ namespace ngla
   }
 
 
+  template <class TM, class TV>
+  list<tuple<string,double>> SparseMatrixSymmetric<TM,TV> :: Timing () const
+  {
+    list<tuple<string,double>> results;
+    auto x = this->CreateColVector();
+    auto y = this->CreateRowVector();
+    x = 1.0;
+    y = 0.0;
+    double time;
+
+    time = RunTiming ([&] () { this->MultAdd (1, x, y); });
+    results.push_back (make_tuple (string("MultAdd"), 1e9 * time / this->NZE()));
+
+    time = RunTiming ([&] ()
+                      {
+                        const FlatVector<TV_ROW> fx = x.FV<TV_ROW>();
+                        FlatVector<TV_COL> fy = y.FV<TV_COL>();
+                        for (int i = 0; i < this->Height(); i++)
+                          {
+                            fy(i) += RowTimesVector (i, fx);
+                            AddRowTransToVectorNoDiag (i, fx(i), fy);
+                          }
+                      });
+    results.push_back (make_tuple (string("MultAdd sequential"), 1e9 * time / this->NZE()));
+
+    // the non-symmetric kernel on the stored lower triangle, as reference
+    time = RunTiming ([&] () { SparseMatrix<TM,TV,TV>::MultAdd (1, x, y); });
+    results.push_back (make_tuple (string("MultAdd non-symmetric kernel"), 1e9 * time / this->NZE()));
+    return results;
+  }
 
-  shared_ptr<SparseMatrixTM<double>>
-  TransposeMatrix (const SparseMatrixTM<double> & mat)
+
+
+  template <typename TM>
+  shared_ptr<SparseMatrixTM<TM>>
+  TransposeMatrix (const SparseMatrixTM<TM> & mat)
   {
     static Timer t1("TransposeMatrix 1");
     static Timer t2("TransposeMatrix 2");
@@ -2054,7 +2571,7 @@ namespace ngla
                  });
     t1.Stop();
     t2.Start();
-    auto trans = make_shared<SparseMatrix<double>>(cnt, mat.Height());
+    auto trans = make_shared<SparseMatrix<TM>>(cnt, mat.Height());
 
     cnt = 0;
     ParallelFor (mat.Height(), [&] (int i)
@@ -2064,7 +2581,7 @@ namespace ngla
                        int c = mat.GetRowIndices(i)[ci];
                        int pos = AsAtomic(cnt[c])++;
                        trans -> GetRowIndices(c)[pos] = i;
-                       trans -> GetRowValues(c)[pos] = mat.GetRowValues(i)[ci];
+                       trans -> GetRowValues(c)[pos] = Trans (mat.GetRowValues(i)[ci]);
                      }
                  });
 
@@ -2072,7 +2589,7 @@ namespace ngla
                  {
                    auto rowvals = trans->GetRowValues(r);
                    BubbleSort (trans->GetRowIndices(r),
-                               FlatArray<double> (rowvals.Size(), &rowvals(0)));
+                               FlatArray<TM> (rowvals.Size(), &rowvals(0)));
                  });
 
     t2.Stop();
@@ -2141,149 +2658,303 @@ namespace ngla
   }
 
 
+  /*
+    Accumulator for one row of a sparse product.
+    Open addressing with linear probing on the column index; the table
+    is only grown, and reset via the list of occupied slots, so one
+    accumulator per task serves all rows of its range.
+  */
+  template <typename TM>
+  class SparseRowAccumulator
+  {
+    Array<int> keys;       // column of slot, -1 if empty
+    Array<TM> vals;
+    Array<int> used;       // occupied slots
+    size_t mask = 0;
+  public:
+    // rowbound ... upper bound for the number of entries of the next row
+    void Reserve (size_t rowbound)
+    {
+      size_t n = 256;
+      while (n < 2*rowbound) n *= 2;
+      if (n <= keys.Size()) return;
+      keys.SetSize(n);
+      keys = -1;
+      vals.SetSize(n);
+      used.SetSize(0);
+      mask = n-1;
+    }
+
+    size_t Size() const { return used.Size(); }
+
+    INLINE size_t Find (int col)
+    {
+      size_t slot = size_t(col) & mask;
+      while (keys[slot] != col)
+        {
+          if (keys[slot] == -1)
+            {
+              keys[slot] = col;
+              vals[slot] = TM(0.0);
+              used.Append (slot);
+              return slot;
+            }
+          slot = (slot+1) & mask;
+        }
+      return slot;
+    }
+
+    INLINE void Insert (int col) { Find (col); }
+    INLINE TM & operator[] (int col) { return vals[Find(col)]; }
+
+    void Reset ()
+    {
+      for (int slot : used)
+        keys[slot] = -1;
+      used.SetSize0();
+    }
+
+    // write row sorted by column, and reset
+    void Extract (FlatArray<int> cols, FlatVector<TM> values)
+    {
+      QuickSort (used, [&] (int a, int b) { return keys[a] < keys[b]; });
+      for (size_t j = 0; j < used.Size(); j++)
+        {
+          cols[j] = keys[used[j]];
+          values(j) = vals[used[j]];
+        }
+      Reset();
+    }
+  };
+
+
   template <typename TM_Res, typename TM1, typename TM2>
   shared_ptr<SparseMatrixTM<TM_Res>>
   MatMult (const SparseMatrixTM<TM1> & mata, const SparseMatrixTM<TM2> & matb)
   {
     static Timer t ("sparse matrix multiplication");
-    static Timer t1a ("sparse matrix multiplication - setup a");
-    static Timer t1b ("sparse matrix multiplication - setup b");
-    static Timer t1b1 ("sparse matrix multiplication - setup b1");
-    static Timer t2 ("sparse matrix multiplication - mult"); 
+    static Timer t1 ("sparse matrix multiplication - symbolic");
+    static Timer t2 ("sparse matrix multiplication - numeric");
     RegionTimer reg(t);
 
-    t1a.Start();
+    // upper bound of entries in row i, used to size the accumulator
+    auto rowbound = [&] (size_t i)
+      {
+        size_t bound = 0;
+        for (int k : mata.GetRowIndices(i))
+          bound += matb.GetRowIndices(k).Size();
+        return min2 (bound, size_t(matb.Width()));
+      };
 
-    // find graph of product
+    // symbolic phase: graph of the product, numeric phase reserves exact row sizes
+    t1.Start();
     Array<int> cnt(mata.Height());
-    cnt = 0;
-
     ParallelForRange
       (mata.Height(), [&] (IntRange r)
        {
-         Array<int*> ptrs;
-         Array<int> sizes;
-         for (int i : r)
+         SparseRowAccumulator<TM_Res> acc;
+         for (auto i : r)
            {
-             auto mata_ci = mata.GetRowIndices(i);
-             ptrs.SetSize(mata_ci.Size());
-             sizes.SetSize(mata_ci.Size());
-             for (int j : Range(mata_ci))
-               {
-                 ptrs[j] = matb.GetRowIndices(mata_ci[j]).Addr(0);
-                 sizes[j] = matb.GetRowIndices(mata_ci[j]).Size();
-               }
-             int cnti = 0;
-             MergeArrays(ptrs, sizes, [&cnti] (int col) { cnti++; } );
-             cnt[i] = cnti;
+             acc.Reserve (rowbound(i));
+             for (int k : mata.GetRowIndices(i))
+               for (int col : matb.GetRowIndices(k))
+                 acc.Insert (col);
+             cnt[i] = acc.Size();
+             acc.Reset();
            }
        },
        TasksPerThread(10));
-
-    t1a.Stop();
-    t1b.Start();
-    t1b1.Start();
     auto prod = make_shared<SparseMatrix<TM_Res>>(cnt, matb.Width());
-    prod->AsVector() = 0.0;
-    t1b1.Stop();
-    // fill col-indices
+    t1.Stop();
+
+    // numeric phase: accumulate rows, and write them sorted
+    t2.Start();
     ParallelForRange
       (mata.Height(), [&] (IntRange r)
        {
-         Array<int*> ptrs;
-         Array<int> sizes;
-         for (int i : r)
+         SparseRowAccumulator<TM_Res> acc;
+         for (auto i : r)
            {
+             acc.Reserve (prod->GetRowIndices(i).Size());
              auto mata_ci = mata.GetRowIndices(i);
-             ptrs.SetSize(mata_ci.Size());
-             sizes.SetSize(mata_ci.Size());
+             auto mata_vals = mata.GetRowValues(i);
              for (int j : Range(mata_ci))
                {
-                 ptrs[j] = matb.GetRowIndices(mata_ci[j]).Addr(0);
-                 sizes[j] = matb.GetRowIndices(mata_ci[j]).Size();
+                 auto vala = mata_vals(j);
+                 auto matb_ci = matb.GetRowIndices(mata_ci[j]);
+                 auto matb_vals = matb.GetRowValues(mata_ci[j]);
+                 for (int k : Range(matb_ci))
+                   acc[matb_ci[k]] += vala * matb_vals(k);
                }
-             int * ptr = prod->GetRowIndices(i).Addr(0);
-             MergeArrays(ptrs, sizes, [&ptr] (int col)
-                         {
-                           *ptr = col;
-                           ptr++;
-                         } );
+             acc.Extract (prod->GetRowIndices(i), prod->GetRowValues(i));
            }
        },
        TasksPerThread(10));
+    t2.Stop();
+    return prod;
+  }
 
+  shared_ptr<SparseMatrixTM<double>> MatMult (const SparseMatrixTM<double> & mata,
+                                              const SparseMatrixTM<double> & matb)
+  {
+    return MatMult<double, double, double>(mata, matb);
+  }
 
-    t1b.Stop();
-    t2.Start();
-    
+
+  template <typename TM>
+  shared_ptr<SparseMatrixTM<TM>>
+  MatRAP (const SparseMatrixTM<double> & matr, const SparseMatrixTM<TM> & mata,
+          const SparseMatrixTM<double> & matp)
+  {
+    static Timer t ("sparse matrix RAP");
+    static Timer t1 ("sparse matrix RAP - symbolic");
+    static Timer t2 ("sparse matrix RAP - numeric");
+    RegionTimer reg(t);
+
+    /*
+      C[I,:] = sum_i R[I,i] sum_k A[i,k] P[k,:], one coarse row at a time.
+      The product A*P is never stored, the fine rows i are visited
+      once per coarse row they contribute to.
+    */
+    auto rowbound = [&] (size_t I)
+      {
+        size_t bound = 0;
+        for (int i : matr.GetRowIndices(I))
+          for (int k : mata.GetRowIndices(i))
+            bound += matp.GetRowIndices(k).Size();
+        return min2 (bound, size_t(matp.Width()));
+      };
+
+    t1.Start();
+    Array<int> cnt(matr.Height());
     ParallelForRange
-      (mata.Height(), [&] (IntRange r)
+      (matr.Height(), [&] (IntRange r)
        {
-         struct thash { int idx; int pos; };
+         SparseRowAccumulator<TM> acc;
+         for (auto I : r)
+           {
+             acc.Reserve (rowbound(I));
+             for (int i : matr.GetRowIndices(I))
+               for (int k : mata.GetRowIndices(i))
+                 for (int col : matp.GetRowIndices(k))
+                   acc.Insert (col);
+             cnt[I] = acc.Size();
+             acc.Reset();
+           }
+       },
+       TasksPerThread(10));
+    auto prod = make_shared<SparseMatrix<TM>>(cnt, matp.Width());
+    t1.Stop();
 
-         size_t maxci = 0;
-         for (auto i : r)
-           maxci = max2(maxci, size_t (prod->GetRowIndices(i).Size()));
-
-         size_t nhash = 2048;
-         while (nhash < 2*maxci) nhash *= 2;
-         ArrayMem<thash,2048> hash(nhash);
-         size_t nhashm1 = nhash-1;
-
-         /*
-         // constexpr unsigned int nhash = 1024; // power of 2, fits well onto stack and cash ..
-         // constexpr unsigned int nhash = 16384;
-         size_t nhash = 16384;
-         thash hash[nhash];
-         */
-         
-         for (auto i : r)
+    t2.Start();
+    ParallelForRange
+      (matr.Height(), [&] (IntRange r)
+       {
+         SparseRowAccumulator<TM> acc;
+         for (auto I : r)
            {
-             auto mata_ci = mata.GetRowIndices(i);
-             auto matc_ci = prod->GetRowIndices(i);
-             auto matc_vals = prod->GetRowValues(i);
-             
-             for (int k = 0; k < matc_ci.Size(); k++)
-               {
-                 size_t hashval = size_t(matc_ci[k]) & nhashm1; // % nhash;
-                 hash[hashval].pos = k;
-                 hash[hashval].idx = matc_ci[k];
-               }
-             
-             for (int j : Range(mata_ci))
+             acc.Reserve (prod->GetRowIndices(I).Size());
+             auto matr_ci = matr.GetRowIndices(I);
+             auto matr_vals = matr.GetRowValues(I);
+             for (int j : Range(matr_ci))
                {
-                 auto vala = mata.GetRowValues(i)[j];
-                 int rowb = mata.GetRowIndices(i)[j];
-                 
-                 auto matb_ci = matb.GetRowIndices(rowb);
-                 auto matb_vals = matb.GetRowValues(rowb);
-                 for (int k = 0; k < matb_ci.Size(); k++)
+                 double valr = matr_vals(j);
+                 auto mata_ci = mata.GetRowIndices(matr_ci[j]);
+                 auto mata_vals = mata.GetRowValues(matr_ci[j]);
+                 for (int k : Range(mata_ci))
                    {
-                     auto colb = matb_ci[k];
-                     unsigned hashval = unsigned(colb) & nhashm1; // % nhash;
-                     if (hash[hashval].idx == colb)
-                       { // lucky fast branch
-                        matc_vals[hash[hashval].pos] += vala * matb_vals[k]; 
-                       }
-                     else
-                      { // do the binary search
-                        (*prod)(i,colb) += vala * matb_vals[k];
-                      }
+                     TM vala = valr * mata_vals(k);
+                     auto matp_ci = matp.GetRowIndices(mata_ci[k]);
+                     auto matp_vals = matp.GetRowValues(mata_ci[k]);
+                     for (int l : Range(matp_ci))
+                       acc[matp_ci[l]] += matp_vals(l) * vala;
                    }
                }
+             acc.Extract (prod->GetRowIndices(I), prod->GetRowValues(I));
            }
        },
        TasksPerThread(10));
-
     t2.Stop();
     return prod;
   }
 
-  shared_ptr<SparseMatrixTM<double>> MatMult (const SparseMatrix<double, double, double> & mata,
-                const SparseMatrix<double, double, double> & matb)
-  {
-    return MatMult<double, double, double>(mata, matb);
-  }
+  template shared_ptr<SparseMatrixTM<Complex>>
+  MatMult<Complex, Complex, double> (const SparseMatrixTM<Complex> &, const SparseMatrixTM<double> &);
+  template shared_ptr<SparseMatrixTM<Complex>>
+  MatMult<Complex, double, Complex> (const SparseMatrixTM<double> &, const SparseMatrixTM<Complex> &);
+  template shared_ptr<SparseMatrixTM<Complex>>
+  MatMult<Complex, Complex, Complex> (const SparseMatrixTM<Complex> &, const SparseMatrixTM<Complex> &);
+
+  template shared_ptr<SparseMatrixTM<double>> TransposeMatrix (const SparseMatrixTM<double> &);
+  template shared_ptr<SparseMatrixTM<double>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<double> &,
+                                                    const SparseMatrixTM<double> &);
+  template shared_ptr<SparseMatrixTM<Complex>> TransposeMatrix (const SparseMatrixTM<Complex> &);
+  template shared_ptr<SparseMatrixTM<Complex>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Complex> &,
+                                                    const SparseMatrixTM<double> &);
+#if MAX_SYS_DIM >= 1
+  template shared_ptr<SparseMatrixTM<Mat<1,1,double>>> TransposeMatrix (const SparseMatrixTM<Mat<1,1,double>> &);
+  template shared_ptr<SparseMatrixTM<Mat<1,1,double>>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Mat<1,1,double>> &,
+                                                    const SparseMatrixTM<double> &);
+  template shared_ptr<SparseMatrixTM<Mat<1,1,Complex>>> TransposeMatrix (const SparseMatrixTM<Mat<1,1,Complex>> &);
+  template shared_ptr<SparseMatrixTM<Mat<1,1,Complex>>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Mat<1,1,Complex>> &,
+                                                    const SparseMatrixTM<double> &);
+#endif
+#if MAX_SYS_DIM >= 2
+  template shared_ptr<SparseMatrixTM<Mat<2,2,double>>> TransposeMatrix (const SparseMatrixTM<Mat<2,2,double>> &);
+  template shared_ptr<SparseMatrixTM<Mat<2,2,double>>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Mat<2,2,double>> &,
+                                                    const SparseMatrixTM<double> &);
+  template shared_ptr<SparseMatrixTM<Mat<2,2,Complex>>> TransposeMatrix (const SparseMatrixTM<Mat<2,2,Complex>> &);
+  template shared_ptr<SparseMatrixTM<Mat<2,2,Complex>>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Mat<2,2,Complex>> &,
+                                                    const SparseMatrixTM<double> &);
+#endif
+#if MAX_SYS_DIM >= 3
+  template shared_ptr<SparseMatrixTM<Mat<3,3,double>>> TransposeMatrix (const SparseMatrixTM<Mat<3,3,double>> &);
+  template shared_ptr<SparseMatrixTM<Mat<3,3,double>>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Mat<3,3,double>> &,
+                                                    const SparseMatrixTM<double> &);
+  template shared_ptr<SparseMatrixTM<Mat<3,3,Complex>>> TransposeMatrix (const SparseMatrixTM<Mat<3,3,Complex>> &);
+  template shared_ptr<SparseMatrixTM<Mat<3,3,Complex>>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Mat<3,3,Complex>> &,
+                                                    const SparseMatrixTM<double> &);
+#endif
+#if MAX_SYS_DIM >= 4
+  template shared_ptr<SparseMatrixTM<Mat<4,4,double>>> TransposeMatrix (const SparseMatrixTM<Mat<4,4,double>> &);
+  template shared_ptr<SparseMatrixTM<Mat<4,4,double>>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Mat<4,4,double>> &,
+                                                    const SparseMatrixTM<double> &);
+  template shared_ptr<SparseMatrixTM<Mat<4,4,Complex>>> TransposeMatrix (const SparseMatrixTM<Mat<4,4,Complex>> &);
+  template shared_ptr<SparseMatrixTM<Mat<4,4,Complex>>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Mat<4,4,Complex>> &,
+                                                    const SparseMatrixTM<double> &);
+#endif
+#if MAX_SYS_DIM >= 5
+  template shared_ptr<SparseMatrixTM<Mat<5,5,double>>> TransposeMatrix (const SparseMatrixTM<Mat<5,5,double>> &);
+  template shared_ptr<SparseMatrixTM<Mat<5,5,double>>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Mat<5,5,double>> &,
+                                                    const SparseMatrixTM<double> &);
+  template shared_ptr<SparseMatrixTM<Mat<5,5,Complex>>> TransposeMatrix (const SparseMatrixTM<Mat<5,5,Complex>> &);
+  template shared_ptr<SparseMatrixTM<Mat<5,5,Complex>>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Mat<5,5,Complex>> &,
+                                                    const SparseMatrixTM<double> &);
+#endif
+#if MAX_SYS_DIM >= 6
+  template shared_ptr<SparseMatrixTM<Mat<6,6,double>>> TransposeMatrix (const SparseMatrixTM<Mat<6,6,double>> &);
+  template shared_ptr<SparseMatrixTM<Mat<6,6,double>>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Mat<6,6,double>> &,
+                                                    const SparseMatrixTM<double> &);
+  template shared_ptr<SparseMatrixTM<Mat<6,6,Complex>>> TransposeMatrix (const SparseMatrixTM<Mat<6,6,Complex>> &);
+  template shared_ptr<SparseMatrixTM<Mat<6,6,Complex>>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Mat<6,6,Complex>> &,
+                                                    const SparseMatrixTM<double> &);
+#endif
+#if MAX_SYS_DIM >= 7
+  template shared_ptr<SparseMatrixTM<Mat<7,7,double>>> TransposeMatrix (const SparseMatrixTM<Mat<7,7,double>> &);
+  template shared_ptr<SparseMatrixTM<Mat<7,7,double>>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Mat<7,7,double>> &,
+                                                    const SparseMatrixTM<double> &);
+  template shared_ptr<SparseMatrixTM<Mat<7,7,Complex>>> TransposeMatrix (const SparseMatrixTM<Mat<7,7,Complex>> &);
+  template shared_ptr<SparseMatrixTM<Mat<7,7,Complex>>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Mat<7,7,Complex>> &,
+                                                    const SparseMatrixTM<double> &);
+#endif
+#if MAX_SYS_DIM >= 8
+  template shared_ptr<SparseMatrixTM<Mat<8,8,double>>> TransposeMatrix (const SparseMatrixTM<Mat<8,8,double>> &);
+  template shared_ptr<SparseMatrixTM<Mat<8,8,double>>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Mat<8,8,double>> &,
+                                                    const SparseMatrixTM<double> &);
+  template shared_ptr<SparseMatrixTM<Mat<8,8,Complex>>> TransposeMatrix (const SparseMatrixTM<Mat<8,8,Complex>> &);
+  template shared_ptr<SparseMatrixTM<Mat<8,8,Complex>>> MatRAP (const SparseMatrixTM<double> &, const SparseMatrixTM<Mat<8,8,Complex>> &,
+                                                    const SparseMatrixTM<double> &);
+#endif
 
   template <class TM, class TV>
   shared_ptr<BaseSparseMatrix>
@@ -2429,11 +3100,7 @@ namespace ngla
     static Timer t ("sparsematrix - restrict");
     RegionTimer reg(t);
 
-    auto prolT = TransposeMatrix(prol);
-
-    auto prod1 = MatMult<double, double, double>(*this, prol);
-    auto prod = MatMult<double, double, double>(*prolT, *prod1);
-    return prod;
+    return MatRAP (*TransposeMatrix(prol), *this, prol);
   }
 
   template <> shared_ptr<BaseSparseMatrix>
@@ -2442,12 +3109,7 @@ namespace ngla
   {
     static Timer t ("sparsematrix - restrict");
     RegionTimer reg(t);
-    // new version
-    auto prolT = TransposeMatrix(prol);
-
-    auto prod1 = MatMult<std::complex<double>, std::complex<double>, double>(*this, prol);
-    auto prod = MatMult<std::complex<double>, double, std::complex<double>>(*prolT, *prod1);
-    return prod;
+    return MatRAP (*TransposeMatrix(prol), *this, prol);
   }
 
 
@@ -2460,12 +3122,8 @@ namespace ngla
   {
     static Timer t ("sparsematrixsymmetric - restrict");
     RegionTimer reg(t);
-    // new version
-    auto prolT = TransposeMatrix(prol);
     auto full = MakeFullMatrix(*this);
-
-    auto prod1 = MatMult<double, double, double>(*full, prol);
-    auto prod = MatMult<double, double, double>(*prolT, *prod1);
+    auto prod = MatRAP (*TransposeMatrix(prol), *full, prol);
 
     auto prodhalf = GetSymmetricMatrix (*prod);
     return prodhalf;
@@ -2665,6 +3323,13 @@ namespace ngla
 	throw Exception ("SparseMatrix::InverseMatrix:  MumpsInverse not available");
 #endif
       }
+    else if (  BaseSparseMatrix :: GetInverseType()  == SPARSECHOLESKY_MIXED)
+      {
+        if constexpr (is_same<TM,double>::value && is_same<TV_ROW,double>::value && is_same<TV_COL,double>::value)
+          return make_shared<MixedPrecisionCholesky> (*this, subset);
+        else
+          throw Exception ("SparseMatrix::InverseMatrix:  sparsecholesky_mixed is available for real matrices only");
+      }
     else
       return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, subset);
   }
@@ -2706,6 +3371,13 @@ namespace ngla
 	throw Exception ("SparseMatrix::InverseMatrix:  MumpsInverse not available");
 #endif
       }
+    else if (  BaseSparseMatrix :: GetInverseType()  == SPARSECHOLESKY_MIXED)
+      {
+        if constexpr (is_same<TM,double>::value && is_same<TV_ROW,double>::value && is_same<TV_COL,double>::value)
+          return make_shared<MixedPrecisionCholesky> (*this, nullptr, clusters);
+        else
+          throw Exception ("SparseMatrix::InverseMatrix:  sparsecholesky_mixed is available for real matrices only");
+      }
     else
       return make_shared<SparseCholesky<TM,TV_ROW,TV_COL>> (*this, nullptr, clusters);
   }
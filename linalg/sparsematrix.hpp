@@ -99,6 +99,21 @@ namespace ngla
     /// owner of arrays ?
     bool owner;
 
+    /// graph providing firsti/colnr, if they are shared (kept alive here)
+    shared_ptr<const MatrixGraph> shared_graph;
+
+    /// use compressed column numbers in matrix-vector products and assembling ?
+    bool compressed = false;
+    /**
+       compressed column numbers: per row the first column (two words),
+       followed by 16 bit offsets of the other columns to the first one.
+       An offset cescape is followed by the column number (two words).
+    */
+    Array<uint16_t> ccolnr;
+    /// first word of row in ccolnr
+    Array<size_t> cfirsti;
+    static constexpr uint16_t cescape = 0xFFFF;
+
   public:
     /// arbitrary number of els/row
     MatrixGraph (const Array<int> & elsperrow, int awidth);
@@ -109,12 +124,56 @@ namespace ngla
     /// 
     MatrixGraph (int size, int width,
                  const Table<int> & rowelements, const Table<int> & colelements, bool symmetric);
+    /// share the index arrays of graph, which must not be changed anymore
+    MatrixGraph (shared_ptr<const MatrixGraph> graph);
     /// 
     // MatrixGraph (const Table<int> & dof2dof, bool symmetric);
     virtual ~MatrixGraph ();
 
     /// eliminate unused columne indices (was never implemented)
     void Compress();
+
+    /// build 16 bit compressed column numbers, used by products and assembling
+    void CompressIndices ();
+    /// go back to plain column numbers
+    void UncompressIndices ();
+    bool IndicesCompressed () const { return compressed; }
+
+    /// calls func(position, column) for all entries of a compressed row
+    template <typename FUNC>
+    INLINE void IterateCompressedRow (int row, FUNC func) const
+    {
+      size_t first = firsti[row];
+      size_t last = firsti[row+1];
+      if (first == last) return;
+      
+      const uint16_t * p = ccolnr.Addr(cfirsti[row]);
+      int col0 = int(unsigned(p[0]) | (unsigned(p[1]) << 16));
+      p += 2;
+      func (first, col0);
+      for (size_t j = first+1; j < last; j++)
+        {
+          uint16_t d = *p++;
+          if (d != cescape)
+            func (j, col0 + d);
+          else
+            {
+              func (j, int(unsigned(p[0]) | (unsigned(p[1]) << 16)));
+              p += 2;
+            }
+        }
+    }
+
+    /// calls func(position, column) for all entries of the row, compressed or not
+    template <typename FUNC>
+    INLINE void IterateRow (int row, FUNC func) const
+    {
+      if (compressed)
+        IterateCompressedRow (row, func);
+      else
+        for (size_t j = firsti[row]; j < firsti[row+1]; j++)
+          func (j, colnr[j]);
+    }
   
     /// returns position of Element (i, j), exception for unused
     size_t GetPosition (int i, int j) const;
@@ -124,6 +183,8 @@ namespace ngla
 
     /// find positions of n sorted elements, overwrite pos, exception for unused
     void GetPositionsSorted (int row, int n, int * pos) const;
+    /// positions of sorted columns cols in row, also for compressed rows, exception for unused
+    void GetPositionsSorted (int row, FlatArray<int> cols, FlatArray<size_t> pos) const;
 
     /// returns position of new element
     size_t CreatePosition (int i, int j);
@@ -140,6 +201,11 @@ namespace ngla
     size_t First (int i) const { return firsti[i]; }
     FlatArray<size_t> GetFirstArray () const  { return firsti; } 
 
+    /// the shared graph, or nullptr if this graph owns its index arrays
+    shared_ptr<const MatrixGraph> GetSharedGraph () const { return shared_graph; }
+    /// same sparsity pattern ?  (cheap if the index arrays are shared)
+    bool SameGraph (const MatrixGraph & graph2) const;
+
     void FindSameNZE();
     void CalcBalancing ();
     const Partitioning & GetBalancing() const { return balance; } 
@@ -183,6 +249,10 @@ namespace ngla
       : MatrixGraph (agraph, stealgraph)
     { ; }   
 
+    BaseSparseMatrix (shared_ptr<const MatrixGraph> agraph)
+      : MatrixGraph (agraph)
+    { ; }   
+
     BaseSparseMatrix (const BaseSparseMatrix & amat)
       : BaseMatrix(amat), MatrixGraph (amat, 0)
     { ; }   
@@ -201,6 +271,10 @@ namespace ngla
       return *this;
     }
 
+    /// a * this + b * m2 as a new matrix, both must have the same graph
+    shared_ptr<BaseSparseMatrix> CreateLinearCombination (double a, double b,
+                                                          const BaseSparseMatrix & m2) const;
+
     virtual shared_ptr<BaseJacobiPrecond> CreateJacobiPrecond (shared_ptr<BitArray> inner = nullptr) const 
     {
       throw Exception ("BaseSparseMatrix::CreateJacobiPrecond");
@@ -250,6 +324,9 @@ namespace ngla
     void SetSPD (bool aspd = true) { spd = aspd; }
     bool IsSPD () const { return spd; }
     virtual size_t NZE () const override { return nze; }
+
+    /// timings of performance critical functions (exported as __timing__)
+    virtual list<tuple<string,double>> Timing () const { return list<tuple<string,double>>(); }
   };
 
   /// A general, sparse matrix
@@ -295,6 +372,11 @@ namespace ngla
       FindSameNZE();
     }
 
+    SparseMatrixTM (shared_ptr<const MatrixGraph> agraph)
+      : BaseSparseMatrix (agraph), 
+	data(nze), nul(TSCAL(0))
+    { ; }
+
     SparseMatrixTM (const SparseMatrixTM & amat)
     : BaseSparseMatrix (amat), 
       data(nze), nul(TSCAL(0))
@@ -403,6 +485,9 @@ namespace ngla
     SparseMatrix (const MatrixGraph & agraph, bool stealgraph);
     // : SparseMatrixTM<TM> (agraph, stealgraph) { ; }
 
+    SparseMatrix (shared_ptr<const MatrixGraph> agraph)
+      : SparseMatrixTM<TM> (agraph) { ; }
+
     SparseMatrix (const SparseMatrix & amat)
       : SparseMatrixTM<TM> (amat) { ; }
 
@@ -442,6 +527,12 @@ namespace ngla
     {
       typedef typename mat_traits<TVY>::TSCAL TTSCAL;
       TVY sum = TTSCAL(0);
+      if (this->compressed)
+        {
+          this->IterateCompressedRow (row, [&] (size_t j, int col)
+                                      { sum += data[j] * vec(col); });
+          return sum;
+        }
       for (size_t j = firsti[row]; j < firsti[row+1]; j++)
 	sum += data[j] * vec(colnr[j]);
       return sum;
@@ -450,6 +541,13 @@ namespace ngla
     ///
     void AddRowTransToVector (int row, TVY el, FlatVector<TVX> vec) const
     {
+      if (this->compressed)
+        {
+          this->IterateCompressedRow (row, [&] (size_t j, int col)
+                                      { vec[col] += Trans(data[j]) * el; });
+          return;
+        }
+      
       size_t first = firsti[row];
       size_t last = firsti[row+1];
 
@@ -474,15 +572,21 @@ namespace ngla
     }
 
 
+    using BaseMatrix::MultAdd;
     virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
     virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
     virtual void MultAdd (Complex s, const BaseVector & x, BaseVector & y) const override;
     virtual void MultTransAdd (Complex s, const BaseVector & x, BaseVector & y) const override;
     virtual void MultConjTransAdd (Complex s, const BaseVector & x, BaseVector & y) const override;
+    /// all vectors in one sweep over the matrix
+    virtual void MultAdd (double s, const MultiVector & x, MultiVector & y) const override;
 
     virtual void MultAdd1 (double s, const BaseVector & x, BaseVector & y,
 			   const BitArray * ainner = NULL,
 			   const Array<int> * acluster = NULL) const override;
+
+    virtual bool MultAddRows (double s, const BaseVector & x, BaseVector & y,
+                              FlatArray<int> rows) const override;
     
     virtual void DoArchive (Archive & ar) override;
   };
@@ -524,7 +628,18 @@ namespace ngla
     // virtual public SparseMatrixSymmetricTM<TM>, 
     /* virtual */ public SparseMatrix<TM,TV,TV>
   {
-
+    /// part-private buffers for the transposed lower triangle in parallel MultAdd
+    mutable Array<size_t> buffer_offset;   // per part, into buffer_cols and buffer
+    mutable Array<int> buffer_cols;        // sorted columns before the first row of the part
+    mutable Array<TV> buffer;
+    mutable Array<size_t> slot_offset;     // per part, into buffer_slot
+    mutable Array<int> buffer_slot;        // buffer slot of such entries, in row order
+    mutable mutex buffer_mutex;
+
+    void SetupParallelBuffers () const;
+    template <typename TVEC>
+    void MultAddParallel (double s, FlatVector<TVEC> fx, FlatVector<TVEC> fy, FlatArray<TVEC> buf) const;
+    
   public:
     using SparseMatrixTM<TM>::firsti;
     using SparseMatrixTM<TM>::colnr;
@@ -555,6 +670,10 @@ namespace ngla
     { ; }
 
     SparseMatrixSymmetric (const MatrixGraph & agraph, bool stealgraph);
+
+    SparseMatrixSymmetric (shared_ptr<const MatrixGraph> agraph)
+      : SparseMatrix<TM,TV,TV> (agraph)
+    { ; }
     /*
       : SparseMatrixTM<TM> (agraph, stealgraph), 
 	SparseMatrixSymmetricTM<TM> (agraph, stealgraph),
@@ -631,6 +750,7 @@ namespace ngla
     virtual shared_ptr<BaseSparseMatrix> Restrict (const SparseMatrixTM<double> & prol,
 					 shared_ptr<BaseSparseMatrix> cmat = nullptr) const override;
 
+    using BaseMatrix::MultAdd;
     ///
     virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
 
@@ -639,6 +759,8 @@ namespace ngla
       MultAdd (s, x, y);
     }
 
+    /// all vectors in one sweep over the matrix
+    virtual void MultAdd (double s, const MultiVector & x, MultiVector & y) const override;
 
     /*
       y += s L * x
@@ -654,6 +776,11 @@ namespace ngla
     virtual void MultAdd2 (double s, const BaseVector & x, BaseVector & y,
 			   const BitArray * ainner = NULL,
 			   const Array<int> * acluster = NULL) const override;
+
+    /// only the lower triangle is stored, rows are not available
+    virtual bool MultAddRows (double s, const BaseVector & x, BaseVector & y,
+                              FlatArray<int> rows) const override
+    { return false; }
     
 
 
@@ -665,14 +792,20 @@ namespace ngla
 
     TV_COL RowTimesVectorNoDiag (int row, const FlatVector<TVX> vec) const
     {
+      typedef typename mat_traits<TVY>::TSCAL TTSCAL;
+      TVY sum = TTSCAL(0);
+      if (this->compressed)
+        {
+          this->IterateCompressedRow (row, [&] (size_t j, int col)
+                                      { if (col != row) sum += data[j] * vec(col); });
+          return sum;
+        }
+
       size_t last = firsti[row+1];
       size_t first = firsti[row];
       if (last == first) return TVY(0);
       if (colnr[last-1] == row) last--;
 
-      typedef typename mat_traits<TVY>::TSCAL TTSCAL;
-      TVY sum = TTSCAL(0);
-
       for (size_t j = first; j < last; j++)
 	sum += data[j] * vec(colnr[j]);
       return sum;
@@ -680,6 +813,13 @@ namespace ngla
 
     void AddRowTransToVectorNoDiag (int row, TVY el, FlatVector<TVX> vec) const
     {
+      if (this->compressed)
+        {
+          this->IterateCompressedRow (row, [&] (size_t j, int col)
+                                      { if (col != row) vec[col] += Trans(data[j]) * el; });
+          return;
+        }
+
       size_t first = firsti[row];
       size_t last = firsti[row+1];
 
@@ -692,14 +832,28 @@ namespace ngla
   
     BaseSparseMatrix & AddMerge (double s, const SparseMatrixSymmetric  & m2);
 
+    virtual list<tuple<string,double>> Timing () const override;
+
     virtual shared_ptr<BaseMatrix> InverseMatrix (shared_ptr<BitArray> subset = nullptr) const override;
     virtual shared_ptr<BaseMatrix> InverseMatrix (shared_ptr<const Array<int>> clusters) const override;
   };
 
-  shared_ptr<SparseMatrixTM<double>> TransposeMatrix (const SparseMatrixTM<double> & mat);
+  template <typename TM>
+  shared_ptr<SparseMatrixTM<TM>> TransposeMatrix (const SparseMatrixTM<TM> & mat);
+
+  // thread-parallel product mata*matb, symbolic and numeric phase with per-task hash accumulators
+  template <typename TM_Res, typename TM1, typename TM2>
+  shared_ptr<SparseMatrixTM<TM_Res>>
+  MatMult (const SparseMatrixTM<TM1> & mata, const SparseMatrixTM<TM2> & matb);
 
   shared_ptr<SparseMatrixTM<double>>
-  MatMult (const SparseMatrix<double, double, double> & mata, const SparseMatrix<double, double, double> & matb);
+  MatMult (const SparseMatrixTM<double> & mata, const SparseMatrixTM<double> & matb);
+
+  // Galerkin product R*A*P in one pass, without storing A*P
+  template <typename TM>
+  shared_ptr<SparseMatrixTM<TM>>
+  MatRAP (const SparseMatrixTM<double> & matr, const SparseMatrixTM<TM> & mata,
+          const SparseMatrixTM<double> & matp);
 
 #ifdef GOLD
 #include <sparsematrix_spec.hpp>
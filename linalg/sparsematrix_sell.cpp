@@ -0,0 +1,331 @@
+/**************************************************************************/
+/* File:   sparsematrix_sell.cpp                                          */
+/* Date:   16. Oct. 2026                                                  */
+/**************************************************************************/
+
+/*
+   sparse matrix in sliced ELLPACK format
+*/
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  constexpr size_t SELL_PADDING = size_t(-1);
+
+  /*
+    rows of the matrix graph as (column, position in graph) pairs.
+    symmetric: the graph stores the lower triangle, the transposed
+    entries are appended to the rows.
+  */
+  static void ExpandGraph (const MatrixGraph & graph, bool symmetric,
+                           Array<size_t> & firsti, Array<int> & cols, Array<size_t> & srcs)
+  {
+    size_t n = graph.Size();
+    Array<size_t> cnt(n);
+    for (size_t i = 0; i < n; i++)
+      cnt[i] = graph.GetRowIndices(i).Size();
+    if (symmetric)
+      for (size_t i = 0; i < n; i++)
+        for (int c : graph.GetRowIndices(i))
+          if (c != int(i)) cnt[c]++;
+
+    firsti.SetSize (n+1);
+    firsti[0] = 0;
+    for (size_t i = 0; i < n; i++)
+      firsti[i+1] = firsti[i] + cnt[i];
+    cols.SetSize (firsti[n]);
+    srcs.SetSize (firsti[n]);
+
+    for (size_t i = 0; i < n; i++)
+      {
+        auto rowind = graph.GetRowIndices(i);
+        for (size_t k = 0; k < rowind.Size(); k++)
+          {
+            cols[firsti[i]+k] = rowind[k];
+            srcs[firsti[i]+k] = graph.First(i)+k;
+          }
+        cnt[i] = rowind.Size();
+      }
+
+    if (symmetric)
+      for (size_t i = 0; i < n; i++)
+        {
+          auto rowind = graph.GetRowIndices(i);
+          for (size_t k = 0; k < rowind.Size(); k++)
+            {
+              int c = rowind[k];
+              if (c == int(i)) continue;
+              size_t pos = firsti[c] + cnt[c]++;
+              cols[pos] = i;
+              srcs[pos] = graph.First(i)+k;
+            }
+        }
+  }
+
+
+  SparseMatrixSELL :: SparseMatrixSELL (const MatrixGraph & graph, bool symmetric, int asigma)
+  {
+    Array<size_t> firsti, srcs;
+    Array<int> cols;
+    ExpandGraph (graph, symmetric, firsti, cols, srcs);
+
+    int w = graph.Size();
+    for (int c : cols)
+      w = max2 (w, c+1);
+    Build (graph.Size(), w, firsti, cols, srcs, asigma);
+    nsource = graph.NZE();
+  }
+
+  SparseMatrixSELL :: SparseMatrixSELL (shared_ptr<SparseMatrixTM<double>> amat, int asigma)
+    : mat(amat)
+  {
+    bool symmetric = dynamic_pointer_cast<SparseMatrixSymmetric<double>> (amat) != nullptr;
+    Array<size_t> firsti, srcs;
+    Array<int> cols;
+    ExpandGraph (*amat, symmetric, firsti, cols, srcs);
+    Build (amat->Height(), amat->Width(), firsti, cols, srcs, asigma);
+    nsource = amat->NZE();
+    CopyValues (amat->AsVector().FVDouble());
+  }
+
+  SparseMatrixSELL :: ~SparseMatrixSELL () { ; }
+
+
+  void SparseMatrixSELL :: Build (int aheight, int awidth, FlatArray<size_t> firsti,
+                                  FlatArray<int> cols, FlatArray<size_t> srcs, int asigma)
+  {
+    static Timer t("SparseMatrixSELL::Build"); RegionTimer reg(t);
+
+    height = aheight;
+    width = awidth;
+    sigma = asigma;
+    nze = cols.Size();
+
+    size_t nchunks = (height + C-1) / C;
+    size_t nrows = nchunks * C;
+    size_t window = max2 (size_t(C), size_t(sigma) / C * C);
+
+    auto rowlen = [&] (int row) -> size_t
+      { return (row >= 0) ? firsti[row+1]-firsti[row] : 0; };
+
+    // sort by decreasing length within every window, ties by row number
+    perm.SetSize (nrows);
+    for (size_t i = 0; i < nrows; i++)
+      perm[i] = (i < size_t(height)) ? int(i) : -1;
+    for (size_t first = 0; first < nrows; first += window)
+      QuickSort (perm.Range (first, min2(first+window, nrows)),
+                 [&] (int a, int b)
+                 {
+                   if (rowlen(a) != rowlen(b)) return rowlen(a) > rowlen(b);
+                   return unsigned(a) < unsigned(b);
+                 });
+
+    firstchunk.SetSize (nchunks+1);
+    firstchunk[0] = 0;
+    for (size_t c = 0; c < nchunks; c++)
+      {
+        size_t w = 0;
+        for (int r = 0; r < C; r++)
+          w = max2 (w, rowlen(perm[c*C+r]));
+        firstchunk[c+1] = firstchunk[c] + w*C;
+      }
+
+    size_t nstored = firstchunk[nchunks];
+    colnr.SetSize (nstored);
+    source.SetSize (nstored);
+    vals.SetSize (nstored);
+
+    ParallelFor (Range(nchunks), [&] (size_t c)
+                 {
+                   size_t first = firstchunk[c];
+                   size_t w = (firstchunk[c+1]-first) / C;
+                   for (int r = 0; r < C; r++)
+                     {
+                       int row = perm[c*C+r];
+                       size_t len = rowlen(row);
+                       int lastcol = 0;
+                       for (size_t j = 0; j < w; j++)
+                         {
+                           size_t k = first + j*C + r;
+                           if (j < len)
+                             {
+                               lastcol = cols[firsti[row]+j];
+                               source[k] = srcs[firsti[row]+j];
+                             }
+                           else
+                             source[k] = SELL_PADDING;
+                           // padding repeats the last column with value 0
+                           colnr[k] = lastcol;
+                           vals[k] = 0.0;
+                         }
+                     }
+                 });
+  }
+
+
+  void SparseMatrixSELL :: CopyValues (FlatVector<double> srcvals)
+  {
+    ParallelForRange (vals.Size(), [&] (IntRange r)
+                      {
+                        for (size_t k : r)
+                          vals[k] = (source[k] == SELL_PADDING) ? 0.0 : srcvals(source[k]);
+                      });
+    if (trans)
+      trans->CopyValues (FlatVector<double> (vals.Size(), vals));
+  }
+
+  void SparseMatrixSELL :: SetValues (const SparseMatrixTM<double> & amat)
+  {
+    if (amat.NZE() != nsource)
+      throw Exception ("SparseMatrixSELL::SetValues: matrix graph does not match");
+    CopyValues (amat.AsVector().FVDouble());
+  }
+
+
+  const Partitioning & SparseMatrixSELL :: GetBalancing () const
+  {
+    size_t nthreads = task_manager ? task_manager->GetNumThreads() : 1;
+    lock_guard<mutex> guard(build_mutex);
+    if (balance.Size() != nthreads)
+      balance.Calc (firstchunk.Size()-1,
+                    [&] (size_t c) { return firstchunk[c+1]-firstchunk[c] + C; },
+                    nthreads);
+    return balance;
+  }
+
+
+  shared_ptr<SparseMatrixSELL> SparseMatrixSELL :: CreateTranspose () const
+  {
+    static Timer t("SparseMatrixSELL::CreateTranspose"); RegionTimer reg(t);
+
+    // (row, position in vals) of all entries, sorted by column
+    Array<size_t> firsti(width+1), cnt(width);
+    cnt = 0;
+    for (size_t k = 0; k < colnr.Size(); k++)
+      if (source[k] != SELL_PADDING)
+        cnt[colnr[k]]++;
+    firsti[0] = 0;
+    for (int i = 0; i < width; i++)
+      firsti[i+1] = firsti[i] + cnt[i];
+
+    Array<int> cols(nze);
+    Array<size_t> srcs(nze);
+    cnt = 0;
+    for (size_t c = 0; c+1 < firstchunk.Size(); c++)
+      for (size_t k = firstchunk[c]; k < firstchunk[c+1]; k++)
+        if (source[k] != SELL_PADDING)
+          {
+            size_t pos = firsti[colnr[k]] + cnt[colnr[k]]++;
+            cols[pos] = perm[c*C + (k-firstchunk[c]) % C];
+            srcs[pos] = k;
+          }
+
+    shared_ptr<SparseMatrixSELL> t_mat (new SparseMatrixSELL());
+    t_mat->Build (width, height, firsti, cols, srcs, sigma);
+    t_mat->nsource = vals.Size();
+    t_mat->CopyValues (FlatVector<double> (vals.Size(), vals));
+    return t_mat;
+  }
+
+
+  AutoVector SparseMatrixSELL :: CreateRowVector () const
+  {
+    return make_shared<VVector<double>> (width);
+  }
+
+  AutoVector SparseMatrixSELL :: CreateColVector () const
+  {
+    return make_shared<VVector<double>> (height);
+  }
+
+  AutoVector SparseMatrixSELL :: CreateVector () const
+  {
+    return make_shared<VVector<double>> (height);
+  }
+
+
+  void SparseMatrixSELL :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SparseMatrixSELL::MultAdd"); RegionTimer reg(t);
+    t.AddFlops (nze);
+
+    FlatVector<double> fx = x.FV<double>();
+    FlatVector<double> fy = y.FV<double>();
+    const double * px = fx.Addr(0);
+    const double * pvals = vals;
+    const int * pcols = colnr;
+
+    ParallelForRange (GetBalancing(), [&] (IntRange chunks)
+                      {
+                        for (size_t c : chunks)
+                          {
+                            size_t first = firstchunk[c];
+                            size_t w = (firstchunk[c+1]-first) / C;
+                            const double * pv = pvals + first;
+                            const int * pc = pcols + first;
+
+                            SIMD<double> sum(0.0);
+                            for (size_t j = 0; j < w; j++, pv += C, pc += C)
+                              sum = FMA (SIMD<double> (pv), GatherSIMD<C> (px, pc), sum);
+
+                            for (int r = 0; r < C; r++)
+                              {
+                                int row = perm[c*C+r];
+                                if (row >= 0)
+                                  fy(row) += s * sum[r];
+                              }
+                          }
+                      });
+  }
+
+  void SparseMatrixSELL :: MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    shared_ptr<SparseMatrixSELL> t_mat;
+    {
+      lock_guard<mutex> guard(build_mutex);
+      if (!trans)
+        trans = CreateTranspose();
+      t_mat = trans;
+    }
+    t_mat->MultAdd (s, x, y);
+  }
+
+
+  shared_ptr<BaseJacobiPrecond> SparseMatrixSELL :: CreateJacobiPrecond (shared_ptr<BitArray> inner) const
+  {
+    if (!mat)
+      throw Exception ("SparseMatrixSELL::CreateJacobiPrecond: not built from a SparseMatrix");
+    return mat->CreateJacobiPrecond (inner);
+  }
+
+
+  ostream & SparseMatrixSELL :: Print (ostream & ost) const
+  {
+    ost << "SELL-" << C << "-" << sigma << " matrix, height = " << height
+        << ", width = " << width << ", nze = " << nze
+        << ", stored = " << vals.Size() << endl;
+    for (size_t c = 0; c+1 < firstchunk.Size(); c++)
+      for (int r = 0; r < C; r++)
+        {
+          int row = perm[c*C+r];
+          if (row < 0) continue;
+          ost << "Row " << row << ":";
+          for (size_t k = firstchunk[c]+r; k < firstchunk[c+1]; k += C)
+            if (source[k] != SELL_PADDING)
+              ost << "   " << colnr[k] << ": " << vals[k];
+          ost << "\n";
+        }
+    return ost;
+  }
+
+  Array<MemoryUsage> SparseMatrixSELL :: GetMemoryUsage () const
+  {
+    Array<MemoryUsage> mu;
+    mu += { "SparseMatrixSELL", vals.Size()*(sizeof(double)+sizeof(int)+sizeof(size_t)), 1 };
+    if (trans) mu += trans->GetMemoryUsage();
+    return mu;
+  }
+
+}
@@ -0,0 +1,102 @@
+#ifndef FILE_NGS_SPARSEMATRIX_SELL
+#define FILE_NGS_SPARSEMATRIX_SELL
+
+/**************************************************************************/
+/* File:   sparsematrix_sell.hpp                                          */
+/* Date:   16. Oct. 2026                                                  */
+/**************************************************************************/
+
+namespace ngla
+{
+
+  /**
+     A real sparse matrix in sliced ELLPACK format (SELL-C-sigma).
+
+     The rows are grouped into chunks of C = SIMD<double>::Size() rows.
+     A chunk is stored column by column and padded to its longest row,
+     such that MultAdd processes C rows at once with SIMD arithmetic and
+     gathers from x. Within windows of sigma rows, the rows are sorted
+     by decreasing length to keep the padding small.
+
+     The matrix is built from the graph of a SparseMatrix, a symmetric
+     matrix (storing the lower triangle) is expanded to both triangles.
+     The transposed matrix for MultTransAdd is built on first use.
+  */
+  class NGS_DLL_HEADER SparseMatrixSELL : public S_BaseMatrix<double>
+  {
+  public:
+    static constexpr int C = SIMD<double>::Size();
+
+  protected:
+    int height, width;
+    /// rows are sorted by length within windows of sigma rows
+    int sigma;
+    /// number of non-zero entries (without padding)
+    size_t nze;
+    /// original row at sorted position, -1 for padding rows
+    Array<int> perm;
+    /// first entry of every chunk, entry (row r, column j) of chunk c is at firstchunk[c]+j*C+r
+    Array<size_t> firstchunk;
+    Array<int> colnr;
+    Array<double> vals;
+    /// index of the value in the source array, for the padding -1
+    Array<size_t> source;
+    /// size of the source array (non-zero entries of the graph)
+    size_t nsource;
+    /// chunks balanced by number of stored entries, for the current number of threads
+    mutable Partitioning balance;
+
+    /// original matrix, for Jacobi/Gauss-Seidel smoothers
+    shared_ptr<BaseSparseMatrix> mat;
+
+    mutable shared_ptr<SparseMatrixSELL> trans;
+    mutable mutex build_mutex;
+
+    SparseMatrixSELL () { ; }
+
+    /// rows given by (colnr, index of value) pairs
+    void Build (int aheight, int awidth, FlatArray<size_t> firsti,
+                FlatArray<int> cols, FlatArray<size_t> srcs, int asigma);
+
+    /// vals[k] = srcvals[source[k]]
+    void CopyValues (FlatVector<double> srcvals);
+
+    const Partitioning & GetBalancing () const;
+    shared_ptr<SparseMatrixSELL> CreateTranspose () const;
+
+  public:
+    /// the graph, all values are zero. symmetric: graph stores the lower triangle
+    SparseMatrixSELL (const MatrixGraph & graph, bool symmetric = false, int asigma = 256);
+    /// graph and values of mat, for a SparseMatrixSymmetric the full matrix
+    SparseMatrixSELL (shared_ptr<SparseMatrixTM<double>> amat, int asigma = 256);
+
+    virtual ~SparseMatrixSELL ();
+
+    /// copies the values of a matrix with the same graph
+    void SetValues (const SparseMatrixTM<double> & amat);
+
+    virtual int VHeight() const override { return height; }
+    virtual int VWidth() const override { return width; }
+    virtual size_t NZE () const override { return nze; }
+
+    /// stored entries including padding, relative to the non-zero entries
+    double PaddingFactor () const { return nze ? double(vals.Size()) / nze : 1.0; }
+
+    virtual AutoVector CreateRowVector () const override;
+    virtual AutoVector CreateColVector () const override;
+    virtual AutoVector CreateVector () const override;
+
+    using BaseMatrix::MultAdd;
+    virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+    virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    /// Jacobi preconditioner of the original sparse matrix
+    shared_ptr<BaseJacobiPrecond> CreateJacobiPrecond (shared_ptr<BitArray> inner = nullptr) const;
+
+    virtual ostream & Print (ostream & ost) const override;
+    virtual Array<MemoryUsage> GetMemoryUsage () const override;
+  };
+
+}
+
+#endif
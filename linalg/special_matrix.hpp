@@ -25,6 +25,7 @@ namespace ngla
     virtual int VHeight() const { return bits->Size(); }
     virtual int VWidth() const { return bits->Size(); }
 
+    using BaseMatrix::MultAdd;
     virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const;    
     virtual void Project (BaseVector & x) const;    
   };
@@ -52,6 +53,8 @@ namespace ngla
       return CreateBaseVector(ind.Size(), false, 1);
     }
 
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     virtual void Mult (const BaseVector & x, BaseVector & y) const override;
     virtual void MultTrans (const BaseVector & x, BaseVector & y) const override;
 
@@ -85,6 +88,8 @@ namespace ngla
 
     auto GetRange() const { return range; }
     
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     virtual void Mult (const BaseVector & x, BaseVector & y) const override;
     virtual void MultTrans (const BaseVector & x, BaseVector & y) const override;
 
@@ -120,6 +125,8 @@ namespace ngla
       return CreateBaseVector(height, false, 1);      
     }
 
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     virtual void Mult (const BaseVector & x, BaseVector & y) const override;
     virtual void MultTrans (const BaseVector & x, BaseVector & y) const override;
 
@@ -151,6 +158,8 @@ namespace ngla
 
     auto GetRange() const { return range; }
     
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     virtual void Mult (const BaseVector & x, BaseVector & y) const override;
     virtual void MultTrans (const BaseVector & x, BaseVector & y) const override;
 
@@ -183,6 +192,8 @@ namespace ngla
       return mat->CreateColVector();
     }
 
+    using BaseMatrix::Mult;
+    using BaseMatrix::MultAdd;
     virtual void Mult (const BaseVector & x, BaseVector & y) const override;
     virtual void MultTrans (const BaseVector & x, BaseVector & y) const override;
 
@@ -204,6 +215,7 @@ namespace ngla
     virtual bool IsComplex() const { return true; }     
     void SetMatrix (const BaseMatrix * arealmatrix);
     const BaseMatrix & GetMatrix () const { return *realmatrix; }
+    using BaseMatrix::MultAdd;
     virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const;
     virtual void MultAdd (Complex s, const BaseVector & x, BaseVector & y) const;
   };
@@ -222,6 +234,7 @@ namespace ngla
     Sym2NonSymMatrix (const BaseMatrix * abasematrix = 0);
     void SetMatrix (const BaseMatrix * abasematrix);
     const BaseMatrix & GetMatrix () const { return *base; }
+    using BaseMatrix::MultAdd;
     virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const;
     //  virtual void MultAdd (Complex s, const BaseVector & x, BaseVector & y) const;
   };
@@ -240,6 +253,7 @@ namespace ngla
     void SetMatrix (const BaseMatrix * abasematrix);
     virtual bool IsComplex() const { return base->IsComplex(); }     
     const BaseMatrix & GetMatrix () const { return *base; }
+    using BaseMatrix::MultAdd;
     virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const;
     //  virtual void MultAdd (Complex s, const BaseVector & x, BaseVector & y) const;
     virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const;
@@ -257,6 +271,7 @@ namespace ngla
 
   public:
     BlockMatrix (const Array<Array<shared_ptr<BaseMatrix>>> & amats);
+    using BaseMatrix::MultAdd;
     virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
     virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
 
@@ -107,6 +107,7 @@ template<class TM,
     void Factor (const int * blocknr);
     ///
     void FactorNew (const SparseMatrix<TM> & a);
+    using BaseMatrix::Mult;
     ///
     virtual void Mult (const BaseVector & x, BaseVector & y) const;
 
@@ -106,6 +106,7 @@ namespace ngla
       : UmfpackInverseTM<TM> (a, ainner, acluster, symmetric) { ; }
 
     virtual ~UmfpackInverse () { ; }
+    using BaseMatrix::Mult;
     ///
     virtual void Mult (const BaseVector & x, BaseVector & y) const;
     virtual void MultTrans (const BaseVector & x, BaseVector & y) const;
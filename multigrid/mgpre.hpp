@@ -87,6 +87,7 @@ namespace ngmg
     ///
     virtual void Update () override;
 
+    using BaseMatrix::Mult;
     ///
     virtual void Mult (const BaseVector & x, BaseVector & y) const override;
 
@@ -158,6 +159,7 @@ namespace ngmg
 
     ///
 
+    using BaseMatrix::Mult;
     virtual void Mult (const BaseVector & x, BaseVector & y) const override;
     ///
     virtual AutoVector CreateVector () const override;
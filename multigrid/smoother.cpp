@@ -42,8 +42,8 @@ namespace ngmg
 
   GSSmoother :: 
   GSSmoother  (const MeshAccess & ama,
-	       const BilinearForm & abiform)
-    : /* ma(ama), */ biform(abiform)
+	       const BilinearForm & abiform, const Flags & aflags)
+    : Smoother(aflags), /* ma(ama), */ biform(abiform)
   {
     Update();
   }
@@ -60,8 +60,12 @@ namespace ngmg
     for (i = 0; i < biform.GetNLevels(); i++)
       {
 	if (biform.GetMatrixPtr(i))
-	  jac[i] = dynamic_cast<const BaseSparseMatrix&> (*biform.GetMatrixPtr(i))
-	    .CreateJacobiPrecond(biform.GetFESpace()->GetFreeDofs());
+          {
+            jac[i] = dynamic_cast<const BaseSparseMatrix&> (*biform.GetMatrixPtr(i))
+              .CreateJacobiPrecond(biform.GetFESpace()->GetFreeDofs());
+            // "coloring" or "levels" for parallel Gauss-Seidel
+            jac[i]->SetGSOrdering (flags.GetStringFlag ("gsordering", "natural"));
+          }
 	else
 	  jac[i] = NULL;
       }
@@ -151,6 +155,59 @@ namespace ngmg
 
 
 
+  ChebyshevSmoother :: 
+  ChebyshevSmoother  (const MeshAccess & ama,
+                      const BilinearForm & abiform, const Flags & aflags)
+    : Smoother(aflags), biform(abiform)
+  {
+    Update();
+  }
+
+  void ChebyshevSmoother :: Update (bool force_update)
+  {
+    int degree = int (flags.GetNumFlag ("chebyshevdegree", 3));
+    double ratio = flags.GetNumFlag ("chebyshevratio", 30);
+    
+    // levels keep their smoother (and its eigenvalue estimate), new levels are set up
+    cheb.SetSize (biform.GetNLevels());
+    for (int i = 0; i < biform.GetNLevels(); i++)
+      {
+        if (cheb[i] && !force_update) continue;
+        auto mat = dynamic_pointer_cast<BaseSparseMatrix> (biform.GetMatrixPtr(i));
+        if (mat)
+          cheb[i] = make_shared<ChebyshevJacobi> (mat, biform.GetFESpace()->GetFreeDofs(),
+                                                  degree, ratio);
+        else
+          cheb[i] = nullptr;
+      }
+  }
+
+  void ChebyshevSmoother :: PreSmooth (int level, BaseVector & u, 
+                                       const BaseVector & f, int steps) const
+  {
+    cheb[level]->Smooth (u, f, steps);
+  }
+
+  void ChebyshevSmoother :: PostSmooth (int level, BaseVector & u, 
+                                        const BaseVector & f, int steps) const
+  {
+    cheb[level]->SmoothBack (u, f, steps);
+  }
+
+  void ChebyshevSmoother :: 
+  Residuum (int level, BaseVector & u, 
+	    const BaseVector & f, BaseVector & d) const
+  {
+    d = f - biform.GetMatrix(level) * u;
+  }
+  
+  AutoVector ChebyshevSmoother :: CreateVector(int level) const
+  {
+    return biform.GetMatrix(level).CreateVector();
+  }
+
+
+
   AnisotropicSmoother :: 
   AnisotropicSmoother  (const MeshAccess & ama,
 			const BilinearForm & abiform)
@@ -93,7 +93,7 @@ namespace ngmg
   public:
     ///
     GSSmoother (const MeshAccess & ama,
-		const BilinearForm & abiform);
+		const BilinearForm & abiform, const Flags & aflags = Flags());
     ///
     virtual ~GSSmoother();
   
@@ -119,6 +119,39 @@ namespace ngmg
   };
 
 
+  /**
+     Chebyshev-Jacobi smoother.
+     Parallel polynomial smoother, lmax is estimated per level.
+     Flags: chebyshevdegree (3), chebyshevratio (30).
+  */
+  class ChebyshevSmoother : public Smoother
+  {
+    ///
+    const BilinearForm & biform;
+    ///
+    Array<shared_ptr<ChebyshevJacobi>> cheb;
+  
+  public:
+    ///
+    ChebyshevSmoother (const MeshAccess & ama,
+                       const BilinearForm & abiform, const Flags & aflags = Flags());
+  
+    ///
+    virtual void Update (bool force_update = 0);
+    ///
+    virtual void PreSmooth (int level, ngla::BaseVector & u, 
+			    const ngla::BaseVector & f, int steps) const;
+    ///
+    virtual void PostSmooth (int level, ngla::BaseVector & u, 
+			     const ngla::BaseVector & f, int steps) const;
+    ///
+    virtual void Residuum (int level, ngla::BaseVector & u, 
+			   const ngla::BaseVector & f, ngla::BaseVector & d) const;
+    ///
+    virtual AutoVector CreateVector(int level) const;
+  };
+
+
   /**
      Anisotropic smoother.
      Common relaxation of vertically aligned nodes.
@@ -233,6 +266,7 @@ namespace ngmg
     ///
     SmoothingPreconditioner (const Smoother & asmoother,
 			     int alevel = 0);
+    using ngla::BaseMatrix::Mult;
     ///
     virtual void Mult (const ngla::BaseVector & f, ngla::BaseVector & u) const;
     ///
@@ -497,7 +497,7 @@ lam : object
 )raw_string"))
           ;
 
-  m.def("SetNumThreads", &TaskManager::SetNumThreads, py::arg("threads"), docu_string(R"raw_string(
+  m.def("SetNumThreads", &TaskManager::SetNumThreads, py::arg("threads"), py::arg("affinity")="", docu_string(R"raw_string(
 Set number of threads
 
 Parameters:
@@ -505,8 +505,33 @@ Parameters:
 threads : int
   input number of threads
 
+affinity : str
+  optional placement of the threads, see SetAffinity
+
+)raw_string") );
+
+  m.def("SetAffinity", &TaskManager::SetAffinity, py::arg("policy"), docu_string(R"raw_string(
+Pin the threads of the TaskManager to cores (Linux), applied when the TaskManager is started.
+
+Parameters:
+
+policy : str
+  "none", "compact" (fill one NUMA node after the other),
+  "scatter" (round robin over the NUMA nodes, physical cores first),
+  or a list of cores like "0-7,16-23".
+  The default is taken from the environment variable NGS_AFFINITY.
+
 )raw_string") );
 
+  m.def("GetAffinity", &TaskManager::GetAffinity, "current affinity policy");
+  m.def("GetThreadCores", [] ()
+        {
+          py::list cores;
+          for (int i = 0; i < TaskManager::GetNumThreads(); i++)
+            cores.append (TaskManager::GetThreadCore(i));
+          return cores;
+        }, "cores of the running TaskManager threads, -1 if not pinned");
+
   // local TaskManager class to be used as context manager in Python
   class ParallelContextManager {
       int num_threads;
@@ -518,6 +543,8 @@ threads : int
       }
       void Enter() {num_threads = EnterTaskManager(); }
       void Exit(py::object exc_type, py::object exc_value, py::object traceback) {
+          // pending asynchronous Python jobs need the GIL
+          py::gil_scoped_release release;
           ExitTaskManager(num_threads);
       }
     };
@@ -530,6 +557,62 @@ threads : int
     .def("__timing__", &TaskManager::Timing)
     ;
 
+  // calls the Python function with the GIL held, also the last reference
+  // may be dropped by a worker thread. The job gets a private LocalHeap,
+  // used by Assemble and friends instead of the shared Python heap
+  auto AsyncPyFunction = [] (py::object func, size_t heapsize) -> function<void()>
+    {
+      shared_ptr<py::object> pyfunc (new py::object(func),
+                                     [] (py::object * f)
+                                     {
+                                       py::gil_scoped_acquire acquire;
+                                       delete f;
+                                     });
+      return [pyfunc, heapsize] ()
+        {
+          LocalHeap lh(heapsize, "python async", true);
+          AsyncHeapRegion reg(lh);
+          py::gil_scoped_acquire acquire;
+          (*pyfunc)();
+        };
+    };
+  
+  py::class_<TaskFuture>(m, "TaskFuture", "handle to an asynchronous job started by RunAsync")
+    .def_property_readonly("ready", &TaskFuture::IsReady)
+    .def("Wait", &TaskFuture::Wait, py::call_guard<py::gil_scoped_release>(),
+         "wait for the job, and raise its exception")
+    .def("Then", [AsyncPyFunction] (TaskFuture & self, py::object func, size_t heapsize)
+         {
+           return self.Then (AsyncPyFunction(func, heapsize));
+         }, py::arg("func"), py::arg("heapsize")=1000000,
+         "run func after the job has finished")
+    ;
+
+  m.def("RunAsync", [AsyncPyFunction] (py::object func, size_t heapsize)
+        {
+          return RunAsync (AsyncPyFunction(func, heapsize));
+        }, py::arg("func"), py::arg("heapsize")=1000000, docu_string(R"raw_string(
+Run func asynchronously on the TaskManager workers, and return a TaskFuture.
+Parallel loops inside func run concurrently to other jobs.
+
+Parameters:
+
+func : object
+  function without arguments
+
+heapsize : int
+  size of the private LocalHeap of the job, used by assembling inside func
+
+)raw_string"));
+
+  m.def("WhenAll", [] (py::list futures)
+        {
+          Array<TaskFuture> fa;
+          for (auto f : futures)
+            fa.Append (f.cast<TaskFuture>());
+          return WhenAll (fa);
+        }, py::arg("futures"), "future which is ready when all futures are ready");
+
   m.def("_PickleMemory", [](py::object pickler, MemoryView& view)
         {
           py::buffer_info bi((char*) view.Ptr(), view.Size());
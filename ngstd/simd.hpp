@@ -1102,6 +1102,28 @@ namespace ngstd
 #ifdef __SSE__
 #endif
 
+  /// (p[ind[0]], ..., p[ind[N-1]])
+  template <int N>
+  INLINE SIMD<double,N> GatherSIMD (const double * p, const int * ind)
+  {
+    return SIMD<double,N> ([p,ind] (int i) { return p[ind[i]]; });
+  }
+
+#ifdef __AVX512F__
+  template <>
+  INLINE SIMD<double,8> GatherSIMD<8> (const double * p, const int * ind)
+  {
+    return _mm512_i32gather_pd (_mm256_loadu_si256 ((__m256i const*)ind), p, 8);
+  }
+#endif
+#ifdef __AVX2__
+  template <>
+  INLINE SIMD<double,4> GatherSIMD<4> (const double * p, const int * ind)
+  {
+    return _mm256_i32gather_pd (p, _mm_loadu_si128 ((__m128i const*)ind), 8);
+  }
+#endif
+
   template <int i, typename T, int N>
   T get(SIMD<T,N> a) { return a[i]; }
   
@@ -6,6 +6,11 @@
 
 #include <ngstd.hpp>
 #include <thread>
+#include <algorithm>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
 
 #include "taskmanager.hpp"
 #include <core/paje_trace.hpp>
@@ -93,6 +98,7 @@ namespace ngstd
   {
     if(num_threads > 0)
       {
+        WaitAsync();
         task_manager->StopWorkers();
         delete task_manager;
         task_manager = nullptr;
@@ -109,7 +115,7 @@ namespace ngstd
 
 
 
-  void TaskManager :: SetNumThreads(int amax_threads)
+  void TaskManager :: SetNumThreads(int amax_threads, const string & affinity)
     { 
       if(task_manager && task_manager->active_workers>0)
         {
@@ -117,14 +123,252 @@ namespace ngstd
           return;
         }
       max_threads = amax_threads;
+      if (affinity != "")
+        SetAffinity (affinity);
     }
 
 
+
+  /////////////////////// placement of threads on cores
+
+  static string affinity = getenv("NGS_AFFINITY") ? getenv("NGS_AFFINITY") : "none";
+  // core of thread i, empty if threads are not pinned
+  static Array<int> thread_cores;
+  // node of thread i, the master thread is on node 0
+  static Array<int> thread_nodes;
+  // threads [first_node_thread[j], first_node_thread[j+1]) are counted for node j
+  static Array<int> first_node_thread;
+#ifdef __linux__
+  static cpu_set_t master_mask;
+#endif
+  
+  // parses lists like "0-7,16-23"
+  static Array<int> ParseCpuList (const string & str)
+  {
+    Array<int> list;
+    stringstream ist(str);
+    string item;
+    while (getline (ist, item, ','))
+      {
+        if (item.find_first_not_of (" \t\n") == string::npos) continue;
+        size_t pos;
+        int first = stoi (item, &pos);
+        int last = first;
+        if (pos < item.size() && item[pos] == '-')
+          last = stoi (item.substr(pos+1));
+        if (first < 0 || last < first)
+          throw Exception ("invalid cpu list '" + str + "'");
+        for (int i = first; i <= last; i++)
+          list.Append (i);
+      }
+    return list;
+  }
+
+  static string ReadSysFile (const string & filename)
+  {
+    ifstream in(filename);
+    string line;
+    if (in) getline (in, line);
+    return line;
+  }
+
+  struct CoreInfo
+  {
+    int cpu, node, package, core, smt;
+  };
+
+  // the cores the process may run on, from /sys
+  static Array<CoreInfo> ReadTopology ()
+  {
+    Array<CoreInfo> cores;
+#ifdef __linux__
+    string sys = "/sys/devices/system/";
+    Array<int> online = ParseCpuList (ReadSysFile (sys+"cpu/online"));
+    
+    for (int cpu : online)
+      {
+        if (cpu >= CPU_SETSIZE || !CPU_ISSET (cpu, &master_mask)) continue;
+        string topo = sys+"cpu/cpu"+ToString(cpu)+"/topology/";
+        string package = ReadSysFile (topo+"physical_package_id");
+        string core = ReadSysFile (topo+"core_id");
+        cores.Append (CoreInfo { cpu, 0,
+              package.size() ? stoi(package) : 0,
+              core.size() ? stoi(core) : cpu, 0 });
+      }
+
+    string nodes = ReadSysFile (sys+"node/online");
+    if (nodes.size())
+      for (int node : ParseCpuList (nodes))
+        for (int cpu : ParseCpuList (ReadSysFile (sys+"node/node"+ToString(node)+"/cpulist")))
+          for (auto & c : cores)
+            if (c.cpu == cpu) c.node = node;
+
+    // numbering of hyper-threads on the same physical core
+    for (auto & c : cores)
+      for (auto & c2 : cores)
+        if (c2.cpu < c.cpu && c2.package == c.package && c2.core == c.core)
+          c.smt++;
+#endif
+    return cores;
+  }
+
+  // sets thread_cores/nodes for the policy, returns false if not pinned
+  static bool PlaceThreads (int nthreads)
+  {
+    thread_cores.SetSize0();
+    thread_nodes.SetSize0();
+    first_node_thread.SetSize0();
+    
+#ifdef __linux__
+    if (affinity == "none") return false;
+    if (nthreads <= 1) return false;
+    
+    sched_getaffinity (0, sizeof(master_mask), &master_mask);
+    Array<CoreInfo> cores = ReadTopology();
+    if (cores.Size() == 0) return false;
+
+    Array<int> order;    // positions in cores
+    if (affinity == "compact")
+      {
+        for (int i : Range(cores)) order.Append(i);
+        // hyper-threads of a core next to each other
+        QuickSort (order, [&] (int a, int b)
+                   {
+                     auto & ca = cores[a], & cb = cores[b];
+                     return make_tuple (ca.node, ca.package, ca.core, ca.smt) <
+                       make_tuple (cb.node, cb.package, cb.core, cb.smt);
+                   });
+      }
+    else if (affinity == "scatter")
+      {
+        // physical cores first, round robin over the nodes
+        auto key = [] (const CoreInfo & c) 
+          { return make_tuple (c.node, c.smt, c.package, c.core, c.cpu); };
+        Array<int> sorted;
+        for (int i : Range(cores)) sorted.Append(i);
+        QuickSort (sorted, [&] (int a, int b)
+                   { return key(cores[a]) < key(cores[b]); });
+        
+        Array<int> nodes;
+        for (auto & c : cores)
+          if (!nodes.Contains(c.node)) nodes.Append(c.node);
+        Array<Array<int>> per_node(nodes.Size());
+        for (int i : sorted)
+          per_node[nodes.Pos(cores[i].node)].Append(i);
+        for (size_t k = 0; order.Size() < cores.Size(); k++)
+          for (auto & pn : per_node)
+            if (k < pn.Size()) order.Append (pn[k]);
+      }
+    else
+      {
+        for (int cpu : ParseCpuList (affinity))
+          {
+            bool found = false;
+            for (int i : Range(cores))
+              if (cores[i].cpu == cpu)
+                {
+                  order.Append(i);
+                  found = true;
+                }
+            if (!found)
+              cerr << "Warning: core " << cpu << " not available for pinning" << endl;
+          }
+        if (order.Size() == 0) return false;
+      }
+
+    // nodes numbered in order of appearance, at most 8
+    Array<int> phys_nodes;
+    thread_cores.SetSize (nthreads);
+    thread_nodes.SetSize (nthreads);
+    for (int i = 0; i < nthreads; i++)
+      {
+        auto & c = cores[order[i % order.Size()]];
+        thread_cores[i] = c.cpu;
+        if (!phys_nodes.Contains(c.node)) phys_nodes.Append(c.node);
+        thread_nodes[i] = min2 (int(phys_nodes.Pos(c.node)), 7);
+      }
+    
+    int num_nodes = min2 (int(phys_nodes.Size()), 8);
+    first_node_thread.SetSize (num_nodes+1);
+    first_node_thread = 0;
+    for (int n : thread_nodes)
+      first_node_thread[n+1]++;
+    for (int j = 0; j < num_nodes; j++)
+      first_node_thread[j+1] += first_node_thread[j];
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  static void PinThread (int thd)
+  {
+#ifdef __linux__
+    if (thread_cores.Size() == 0) return;
+    cpu_set_t mask;
+    CPU_ZERO (&mask);
+    CPU_SET (thread_cores[thd], &mask);
+    sched_setaffinity (0, sizeof(mask), &mask);
+#endif
+  }
+
+  static int NodeOfThread (int thd, int num_nodes, int nthreads)
+  {
+    if (thread_nodes.Size()) return thread_nodes[thd];
+    return num_nodes * thd / nthreads;
+  }
+
+  // tasks are shared by the nodes according to their number of threads
+  static IntRange TasksOfNode (int node, int num_nodes, int ntasks)
+  {
+    if (first_node_thread.Size())
+      {
+        size_t nthreads = first_node_thread.Last();
+        return IntRange (ntasks * first_node_thread[node] / nthreads,
+                         ntasks * first_node_thread[node+1] / nthreads);
+      }
+    return Range(ntasks).Split (node, num_nodes);
+  }
+
+  void TaskManager :: SetAffinity (const string & policy)
+  {
+    if (task_manager && task_manager->active_workers>0)
+      {
+        cerr << "Warning: can't change affinity while TaskManager active!" << endl;
+        return;
+      }
+    if (policy != "none" && policy != "compact" && policy != "scatter")
+      ParseCpuList (policy);   // throws for invalid lists
+    affinity = policy;
+  }
+
+  string TaskManager :: GetAffinity () { return affinity; }
+
+  bool TaskManager :: IsPinned () { return thread_cores.Size() > 0; }
+
+  int TaskManager :: GetThreadCore (int thd)
+  {
+    return size_t(thd) < thread_cores.Size() ? thread_cores[thd] : -1;
+  }
+
+
   TaskManager :: TaskManager()
     {
       num_threads = GetMaxThreads();
       // if (MyMPI_GetNTasks() > 1) num_threads = 1;
 
+      if (PlaceThreads (num_threads))
+        {
+          num_nodes = first_node_thread.Size()-1;
+          for (int j = 0; j < num_nodes; j++)
+            {
+              nodedata[j] = new NodeData;
+              complete[j] = -1;
+              workers_on_node[j] = 0;
+            }
+        }
+      else
+        {
 #ifdef USE_NUMA
       numa_available();
       num_nodes = numa_max_node() + 1;
@@ -143,6 +387,7 @@ namespace ngstd
       complete[0] = -1;
       workers_on_node[0] = 0;
 #endif
+        }
 
       jobnr = 0;
       done = 0;
@@ -175,6 +420,9 @@ namespace ngstd
     delete trace;
     trace = nullptr;
     num_threads = 1;
+    thread_cores.SetSize0();
+    thread_nodes.SetSize0();
+    first_node_thread.SetSize0();
   }
 
   /*
@@ -193,6 +441,7 @@ namespace ngstd
         std::thread([this,i]() { this->Loop(i); }).detach();
       }
     thread_id = 0;
+    PinThread (0);
     
     size_t alloc_size = num_threads*NgProfiler::SIZE;
     NgProfiler::thread_times = new size_t[alloc_size];
@@ -213,6 +462,10 @@ namespace ngstd
   void TaskManager :: StopWorkers()
   {
     done = true;
+#ifdef __linux__
+    if (IsPinned())
+      sched_setaffinity (0, sizeof(master_mask), &master_mask);
+#endif
     double delta_tsc = __rdtsc()-calibrate_init_tsc;
     double delta_sec = std::chrono::duration<double>(TClock::now()-calibrate_init_clock).count();
     double frequ = (delta_sec != 0) ? delta_tsc/delta_sec : 2.7e9;
@@ -237,12 +490,29 @@ namespace ngstd
 
   /////////////////////// NEW: nested tasks using concurrent queue
 
+  class AsyncState
+  {
+  public:
+    function<void()> func;
+    /// unfinished predecessors, plus one while the job is set up
+    atomic<int> cnt_pred{1};
+    atomic<bool> finished{false};
+    exception_ptr ex;
+    MyMutex mutex;
+    Array<shared_ptr<AsyncState>> continuations;
+    /// keeps the job alive while it is in the queue
+    shared_ptr<AsyncState> self;
+
+    shared_ptr<AsyncState> GetSelf() { return move(self); }
+  };
+
   struct TNestedTask
   {
     const function<void(TaskInfo&)> * func;
     atomic<int> * endcnt;
     int mynr;
     int total;
+    AsyncState * async = nullptr;
 
     TNestedTask () { ; }
     TNestedTask (const function<void(TaskInfo&)> & _func,
@@ -252,6 +522,11 @@ namespace ngstd
     {
       ;
     }
+    TNestedTask (AsyncState * _async)
+      : func(nullptr), endcnt(nullptr), mynr(0), total(1), async(_async)
+    {
+      ;
+    }
   };
 
   typedef moodycamel::ConcurrentQueue<TNestedTask> TQueue; 
@@ -259,6 +534,8 @@ namespace ngstd
   typedef moodycamel::ConsumerToken TCToken; 
   
   static TQueue taskqueue;
+  /// jobs from RunAsync, separate from the nested tasks
+  static TQueue asyncqueue;
 
   void AddTask (const function<void(TaskInfo&)> & afunc,
                 atomic<int> & endcnt)
@@ -271,6 +548,10 @@ namespace ngstd
       taskqueue.enqueue (ptoken, { afunc, i, num, endcnt });
   }
 
+  // number of asynchronous jobs currently running on this thread
+  static thread_local int async_depth = 0;
+  static void ExecuteAsync (shared_ptr<AsyncState> state);
+  
   mutex m;
   bool ProcessTask()
   {
@@ -297,6 +578,20 @@ namespace ngstd
     return false;
   }
 
+  // Asynchronous jobs are taken only by idle workers and by threads waiting
+  // for asynchronous jobs, never by a thread waiting for its nested tasks:
+  // the job might block on something this thread holds (e.g. the Python GIL)
+  static bool ProcessAsync()
+  {
+    TNestedTask task;
+    if (asyncqueue.try_dequeue(task))
+      {
+        ExecuteAsync (task.async->GetSelf());
+        return true;
+      }
+    return false;
+  }
+
 
   void TaskManager :: CreateJob (const function<void(TaskInfo&)> & afunc,
                                  int antasks)
@@ -317,7 +612,7 @@ namespace ngstd
       }
 
 
-    if (func)
+    if (func || async_depth)
       { // we are already parallel, use nested tasks
         // startup for inner function not supported ...
         // if (startup_function) (*startup_function)();
@@ -352,7 +647,8 @@ namespace ngstd
     ex = nullptr;
 
 
-    nodedata[0]->start_cnt.store (0, memory_order_relaxed);
+    for (int j = 0; j < num_nodes; j++)
+      nodedata[j]->start_cnt.store (0, memory_order_relaxed);
 
     jobnr++;
     
@@ -363,10 +659,7 @@ namespace ngstd
     
     int thd = 0;
     int thds = GetNumThreads();
-    int mynode = num_nodes * thd/thds;
-
-    IntRange mytasks = Range(int(ntasks)).Split (mynode, num_nodes);
-    NodeData & mynode_data = *(nodedata[mynode]);
+    int mynode = NodeOfThread (thd, num_nodes, thds);
 
     TaskInfo ti;
     ti.nthreads = thds;
@@ -374,22 +667,29 @@ namespace ngstd
     // ti.nnodes = num_nodes;
     // ti.node_nr = mynode;
 
+    // tasks of my node first, then the master takes over what is left on
+    // the other nodes, whose workers may be busy with asynchronous jobs
     try
       {
-        while (1)
+        for (int k = 0; k < num_nodes; k++)
           {
-            int mytask = mynode_data.start_cnt++;
-            if (mytask >= mytasks.Size()) break;
-            
-            ti.task_nr = mytasks.First()+mytask;
-            ti.ntasks = ntasks;
-
-            {
-              RegionTracer t(ti.thread_nr, jobnr, RegionTracer::ID_JOB, ti.task_nr);
-              (*func)(ti); 
-            }
+            int node = (mynode+k) % num_nodes;
+            NodeData & node_data = *(nodedata[node]);
+            IntRange tasks = TasksOfNode (node, num_nodes, ntasks);
+            while (1)
+              {
+                int mytask = node_data.start_cnt++;
+                if (mytask >= tasks.Size()) break;
+                
+                ti.task_nr = tasks.First()+mytask;
+                ti.ntasks = ntasks;
+                
+                {
+                  RegionTracer t(ti.thread_nr, jobnr, RegionTracer::ID_JOB, ti.task_nr);
+                  (*func)(ti); 
+                }
+              }
           }
-
       }
     catch (Exception e)
       {
@@ -397,18 +697,25 @@ namespace ngstd
           lock_guard<mutex> guard(copyex_mutex);
           delete ex;
           ex = new Exception (e);
-          mynode_data.start_cnt = mytasks.Size();
+          for (int j = 0; j < num_nodes; j++)
+            nodedata[j]->start_cnt = TasksOfNode (j, num_nodes, ntasks).Size();
         }
       }
 
     if (cleanup_function) (*cleanup_function)();
+
+    // all tasks are taken. Close the gates of nodes no worker has joined,
+    // the others are closed by their last worker
+    for (int j = 0; j < num_nodes; j++)
+      {
+        int oldpart = 1;
+        if (nodedata[j]->participate.compare_exchange_strong (oldpart, 0))
+          complete[j] = jobnr.load();
+      }
     
     for (int j = 0; j < num_nodes; j++)
-      if (workers_on_node[j])
-        {
-          while (complete[j] != jobnr)
-            _mm_pause();
-        }
+      while (complete[j] != jobnr)
+        _mm_pause();
 
     func = nullptr;
     if (ex)
@@ -432,7 +739,7 @@ namespace ngstd
 
     int thds = GetNumThreads();
 
-    int mynode = num_nodes * thd/thds;
+    int mynode = NodeOfThread (thd, num_nodes, thds);
 
     NodeData & mynode_data = *(nodedata[mynode]);
 
@@ -445,8 +752,10 @@ namespace ngstd
     // ti.node_nr = mynode;
 
       
+    PinThread (thd);
 #ifdef USE_NUMA
-    numa_run_on_node (mynode);
+    if (!IsPinned())
+      numa_run_on_node (mynode);
 #endif
     active_workers++;
     workers_on_node[mynode]++;
@@ -467,7 +776,7 @@ namespace ngstd
         if (jobnr == jobdone)
           {
             // RegionTracer t(ti.thread_nr, tCASyield, ti.task_nr);
-            while (ProcessTask()); // do the nested tasks
+            while (ProcessTask() || ProcessAsync()); // do the nested tasks, then async jobs
                    
             if(sleep)
               this_thread::sleep_for(chrono::microseconds(sleep_usecs));
@@ -498,7 +807,7 @@ namespace ngstd
 
         if (startup_function) (*startup_function)();
         
-        IntRange mytasks = Range(int(ntasks)).Split (mynode, num_nodes);
+        IntRange mytasks = TasksOfNode (mynode, num_nodes, ntasks);
           
         try
           {
@@ -549,11 +858,7 @@ namespace ngstd
                   mynode_data.participate |= 1;                  
                 }
               else
-                {
-                  if (mynode != 0)
-                    mynode_data.start_cnt = 0;
-                  complete[mynode] = jobnr.load(); 
-                }
+                complete[mynode] = jobnr.load(); 
 	    }	      
 	}
       }
@@ -799,4 +1104,323 @@ namespace ngstd
     return timings;
   }
   
+  
+  TaskDAG :: TaskDAG (const FlatTable<int> & dag)
+    : TaskDAG (dag, FlatArray<double> (0, nullptr)) { ; }
+  
+  TaskDAG :: TaskDAG (const FlatTable<int> & dag, FlatArray<double> costs)
+  {
+    static Timer t("TaskDAG - analyze"); RegionTimer reg(t);
+    size_t n = dag.Size();
+
+    firstsucc.SetSize (n+1);
+    firstsucc[0] = 0;
+    for (size_t i = 0; i < n; i++)
+      firstsucc[i+1] = firstsucc[i] + dag[i].Size();
+    succ.SetSize (firstsucc[n]);
+    for (size_t i = 0; i < n; i++)
+      succ.Range(firstsucc[i], firstsucc[i+1]) = dag[i];
+
+    num_pred.SetSize (n);
+    num_pred = 0;
+    for (int j : succ)
+      num_pred[j]++;
+
+    // topological order, then the longest path backwards
+    Array<int> order(n), cnt(n);
+    order.SetSize0();
+    cnt = num_pred;
+    for (size_t i = 0; i < n; i++)
+      if (cnt[i] == 0) order.Append(i);
+    for (size_t k = 0; k < order.Size(); k++)
+      for (int j : Successors(order[k]))
+        if (--cnt[j] == 0) order.Append(j);
+    if (order.Size() != n)
+      throw Exception ("TaskDAG: graph has cycles");
+
+    priority.SetSize (n);
+    for (size_t k = n; k-- > 0; )
+      {
+        int i = order[k];
+        double maxsucc = 0;
+        for (int j : Successors(i))
+          maxsucc = max2(maxsucc, priority[j]);
+        priority[i] = (costs.Size() ? costs[i] : 1.0) + maxsucc;
+      }
+
+    num_final = 0;
+    sources.SetSize0();
+    for (size_t i = 0; i < n; i++)
+      {
+        if (num_pred[i] == 0) sources.Append(i);
+        if (firstsucc[i+1] == firstsucc[i]) num_final++;
+      }
+    sort (sources.Addr(0), sources.Addr(0)+sources.Size(),
+          [&] (int a, int b) { return priority[a] > priority[b]; });
+  }
+
+  
+  void TaskDAG :: Run (const function<void(int)> & func) const
+  {
+    static Timer t("TaskDAG::Run"); RegionTimer reg(t);
+    static Timer ttask("TaskDAG task");
+    
+    size_t n = Size();
+    if (n == 0) return;
+
+    // max-heap by priority
+    auto lower = [this] (int a, int b) { return priority[a] < priority[b]; };
+    
+    Array<atomic<int>> cnt_pred(n);
+    ParallelForRange (n, [&] (IntRange r)
+                      {
+                        for (auto i : r)
+                          cnt_pred[i].store (num_pred[i], memory_order_relaxed);
+                      });
+
+    if (!task_manager || TaskManager::GetNumThreads() == 1)
+      {
+        Array<int> ready(sources.Size());
+        ready = sources;    // sorted, so it is a heap
+        while (ready.Size())
+          {
+            pop_heap (ready.Addr(0), ready.Addr(0)+ready.Size(), lower);
+            int nr = ready.Last();
+            ready.DeleteLast();
+            
+            func(nr);
+            
+            for (int j : Successors(nr))
+              if (--cnt_pred[j] == 0)
+                {
+                  ready.Append(j);
+                  push_heap (ready.Addr(0), ready.Addr(0)+ready.Size(), lower);
+                }
+          }
+        return;
+      }
+
+    class alignas(64) ReadyQueue
+    {
+    public:
+      MyMutex mutex;
+      atomic<int> size{0};
+      Array<int> heap;
+    };
+    
+    int nq = TaskManager::GetNumThreads();
+    Array<ReadyQueue> queues(nq);
+    // round robin keeps every queue sorted, i.e. a heap
+    for (size_t i = 0; i < sources.Size(); i++)
+      queues[i % nq].heap.Append (sources[i]);
+    for (auto & q : queues)
+      q.size = q.heap.Size();
+    
+    atomic<size_t> cnt_final(0);
+    
+    task_manager -> CreateJob
+      ([&] (const TaskInfo & ti)
+       {
+         int me = ti.task_nr % nq;
+         
+         while (cnt_final.load(memory_order_relaxed) < num_final)
+           {
+             while (ProcessTask()); // do the nested tasks
+             
+             int nr = -1;
+             for (int k = 0; k < nq && nr == -1; k++)   // own queue first, then steal
+               {
+                 ReadyQueue & q = queues[(me+k) % nq];
+                 if (q.size.load(memory_order_relaxed) == 0) continue;
+                 MyLock lock(q.mutex);
+                 if (q.heap.Size() == 0) continue;
+                 pop_heap (q.heap.Addr(0), q.heap.Addr(0)+q.heap.Size(), lower);
+                 nr = q.heap.Last();
+                 q.heap.DeleteLast();
+                 q.size = q.heap.Size();
+               }
+             if (nr == -1) continue;
+
+             {
+               RegionTracer rt(TaskManager::GetThreadId(), ttask, nr);
+               func(nr);
+             }
+
+             auto mysucc = Successors(nr);
+             if (mysucc.Size() == 0)
+               cnt_final++;
+             
+             for (int j : mysucc)
+               if (--cnt_pred[j] == 0)
+                 {
+                   ReadyQueue & q = queues[me];
+                   MyLock lock(q.mutex);
+                   q.heap.Append (j);
+                   push_heap (q.heap.Addr(0), q.heap.Addr(0)+q.heap.Size(), lower);
+                   q.size = q.heap.Size();
+                 }
+           }
+       });
+  }
+  
+
+
+  static atomic<int> num_async(0);
+  
+  static void SubmitAsync (shared_ptr<AsyncState> state)
+  {
+    num_async++;
+    if (!task_manager || TaskManager::GetNumThreads() == 1 ||
+        !state->func || state->ex)
+      {
+        ExecuteAsync (state);
+        return;
+      }
+    
+    state->self = state;
+    asyncqueue.enqueue (TNestedTask(state.get()));
+  }
+
+  static void AddPredecessor (const shared_ptr<AsyncState> & next, AsyncState & pred)
+  {
+    next->cnt_pred++;
+    MyLock lock(pred.mutex);
+    if (!pred.finished)
+      {
+        pred.continuations.Append (next);
+        return;
+      }
+    if (pred.ex)
+      {
+        MyLock lock2(next->mutex);
+        if (!next->ex) next->ex = pred.ex;
+      }
+    next->cnt_pred--;
+  }
+  
+  static void ReleaseAsync (const shared_ptr<AsyncState> & state)
+  {
+    if (--state->cnt_pred == 0)
+      SubmitAsync (state);
+  }
+  
+  static void ExecuteAsync (shared_ptr<AsyncState> state)
+  {
+    static Timer t("async job");
+    if (state->func && !state->ex)
+      {
+        RegionTracer rt(TaskManager::GetThreadId(), t);
+        async_depth++;
+        try
+          {
+            state->func();
+          }
+        catch (...)
+          {
+            state->ex = current_exception();
+          }
+        async_depth--;
+      }
+    state->func = nullptr;
+
+    Array<shared_ptr<AsyncState>> conts;
+    {
+      MyLock lock(state->mutex);
+      state->finished = true;
+      conts = move(state->continuations);
+    }
+    for (auto & c : conts)
+      {
+        if (state->ex)
+          {
+            MyLock lock(c->mutex);
+            if (!c->ex) c->ex = state->ex;
+          }
+        ReleaseAsync (c);
+      }
+    num_async--;
+  }
+
+  
+  bool TaskFuture :: IsReady () const
+  {
+    return !state || state->finished;
+  }
+
+  void TaskFuture :: Wait () const
+  {
+    if (!state) return;
+    while (!state->finished)
+      if (!ProcessTask())
+        ProcessAsync();
+    if (state->ex)
+      rethrow_exception (state->ex);
+  }
+
+  TaskFuture TaskFuture :: Then (function<void()> func) const
+  {
+    if (!state) return RunAsync (move(func));
+    
+    auto next = make_shared<AsyncState>();
+    next->func = move(func);
+    AddPredecessor (next, *state);
+    ReleaseAsync (next);
+    return next;
+  }
+  
+  TaskFuture RunAsync (function<void()> func)
+  {
+    auto state = make_shared<AsyncState>();
+    state->func = move(func);
+    ReleaseAsync (state);
+    return state;
+  }
+
+  TaskFuture RunAsync (function<void(LocalHeap&)> func,
+                       size_t heapsize, const char * name)
+  {
+    return RunAsync ([func, heapsize, name] ()
+                     {
+                       LocalHeap lh(heapsize, name, true);
+                       AsyncHeapRegion reg(lh);
+                       func(lh);
+                     });
+  }
+
+  // a job runs on one thread from start to end, jobs run inside a
+  // waiting job are nested
+  static thread_local LocalHeap * async_heap = nullptr;
+
+  LocalHeap * GetAsyncLocalHeap ()
+  {
+    return async_heap;
+  }
+
+  AsyncHeapRegion :: AsyncHeapRegion (LocalHeap & lh)
+    : prev(async_heap)
+  {
+    async_heap = &lh;
+  }
+
+  AsyncHeapRegion :: ~AsyncHeapRegion ()
+  {
+    async_heap = prev;
+  }
+
+  TaskFuture WhenAll (FlatArray<TaskFuture> futures)
+  {
+    auto state = make_shared<AsyncState>();
+    for (auto & f : futures)
+      if (f.Valid())
+        AddPredecessor (state, *f.GetState());
+    ReleaseAsync (state);
+    return state;
+  }
+
+  void WaitAsync ()
+  {
+    while (num_async)
+      if (!ProcessTask())
+        ProcessAsync();
+  }
 }
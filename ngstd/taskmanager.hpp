@@ -87,7 +87,8 @@ namespace ngstd
       }
     void ResumeWorkers() { sleep = false; }
 
-    static void SetNumThreads(int amax_threads);
+    /// optionally sets the affinity policy, see SetAffinity
+    static void SetNumThreads(int amax_threads, const string & affinity = "");
     static int GetMaxThreads() { return max_threads; }
     // static int GetNumThreads() { return task_manager ? task_manager->num_threads : 1; }
     static int GetNumThreads() { return num_threads; }
@@ -95,6 +96,23 @@ namespace ngstd
     int GetNumNodes() const { return num_nodes; }
 
     static void SetPajeTrace (bool use)  { use_paje_trace = use; }
+
+    /**
+       Placement of the threads, applied when the workers are started:
+       "none" (default, or env NGS_AFFINITY),
+       "compact" (fill the cores of one NUMA node, hyper-threads next to each other),
+       "scatter" (round robin over the NUMA nodes, physical cores first),
+       or an explicit list of cores like "0-7,16-23".
+       Pinned threads on several NUMA nodes distribute the tasks of a job 
+       node by node, so the same task number (e.g. the same part of a 
+       Partitioning) is always processed on the same node.
+    */
+    NGS_DLL_HEADER static void SetAffinity (const string & policy);
+    NGS_DLL_HEADER static string GetAffinity ();
+    /// threads are pinned to cores (Linux only)
+    NGS_DLL_HEADER static bool IsPinned ();
+    /// core of the thread, -1 if not pinned
+    NGS_DLL_HEADER static int GetThreadCore (int thd);
     
     NGS_DLL_HEADER static void CreateJob (const function<void(TaskInfo&)> & afunc, 
                     int antasks = task_manager->GetNumThreads());
@@ -569,6 +587,11 @@ public:
 
 
 
+  /*
+    Parts are processed by tasks of the same number. With pinned threads
+    (see TaskManager::SetAffinity) a task number always runs on the same
+    NUMA node, so memory first-touched part by part stays node-local.
+  */
   class Partitioning
   {
     Array<size_t> part;
@@ -765,6 +788,98 @@ public:
 
 
 
+  template <class T> class FlatTable;
+
+  /**
+     A directed acyclic task graph, dag[i] are the successors of task i.
+     The graph is analyzed once (dependency counts, critical path),
+     and can be executed many times with different work per task.
+     Ready tasks with the longest remaining path run first. Every thread
+     has its own ready queue, idle threads steal from the others.
+  */
+  class NGS_DLL_HEADER TaskDAG
+  {
+    Array<size_t> firstsucc;
+    Array<int> succ;
+    /// number of predecessors
+    Array<int> num_pred;
+    /// costs of the longest path starting at the task
+    Array<double> priority;
+    /// tasks without predecessors, highest priority first
+    Array<int> sources;
+    size_t num_final = 0;
+    
+  public:
+    TaskDAG () = default;
+    /// unit costs per task
+    TaskDAG (const FlatTable<int> & dag);
+    /// costs of the tasks, for the critical path priorities
+    TaskDAG (const FlatTable<int> & dag, FlatArray<double> costs);
+
+    size_t Size() const { return num_pred.Size(); }
+    FlatArray<int> Successors (int i) const
+    { return succ.Range(firstsucc[i], firstsucc[i+1]); }
+    double Priority (int i) const { return priority[i]; }
+    
+    /// calls func(i) for all tasks, each after its predecessors
+    void Run (const function<void(int)> & func) const;
+  };
+
+
+
+  class AsyncState;
+
+  /**
+     Handle to a job started by RunAsync.
+     The job runs on an idle worker, or on a thread in TaskFuture::Wait or
+     WaitAsync, concurrently to the caller and to other asynchronous jobs.
+     Threads waiting for the nested tasks of a parallel loop don't pick it up.
+     Parallel loops inside the job are executed as nested tasks.
+  */
+  class NGS_DLL_HEADER TaskFuture
+  {
+    shared_ptr<AsyncState> state;
+  public:
+    TaskFuture () = default;
+    TaskFuture (shared_ptr<AsyncState> astate) : state(astate) { ; }
+
+    bool Valid () const { return bool(state); }
+    bool IsReady () const;
+    /// processes tasks until the job has finished, re-throws its exception
+    void Wait () const;
+    /// runs func after the job has finished (skipped if the job failed)
+    TaskFuture Then (function<void()> func) const;
+
+    shared_ptr<AsyncState> GetState () const { return state; }
+  };
+
+  NGS_DLL_HEADER TaskFuture RunAsync (function<void()> func);
+
+  /// the job gets its own LocalHeap, which can be Split() inside parallel loops
+  NGS_DLL_HEADER TaskFuture RunAsync (function<void(LocalHeap&)> func,
+                                      size_t heapsize, const char * name = "async");
+
+  /// the LocalHeap of the asynchronous job running on this thread, or nullptr
+  NGS_DLL_HEADER LocalHeap * GetAsyncLocalHeap ();
+
+  /// makes lh the LocalHeap of the asynchronous job running on this thread
+  class NGS_DLL_HEADER AsyncHeapRegion
+  {
+    LocalHeap * prev;
+  public:
+    AsyncHeapRegion (LocalHeap & lh);
+    ~AsyncHeapRegion ();
+  };
+
+  /// finished after all futures have finished
+  NGS_DLL_HEADER TaskFuture WhenAll (FlatArray<TaskFuture> futures);
+
+  /// processes tasks until all asynchronous jobs have finished
+  NGS_DLL_HEADER void WaitAsync ();
+
+
+
+
 
   
 
@@ -894,12 +1009,15 @@ class NumaDistributedArray : public Array<T>
 public:
   NumaDistributedArray () { numa_size = 0; numa_ptr = nullptr; }
   NumaDistributedArray (size_t s)
-    : Array<T> (s, (T*)numa_alloc_local(s*sizeof(T)))
+    : Array<T> (s, (T*) (TaskManager::IsPinned() ? numa_alloc(s*sizeof(T)) : numa_alloc_local(s*sizeof(T))))
   {
     numa_ptr = this->data;
     numa_size = s;
 
     /* int avail = */ numa_available();   // initialize libnuma
+
+    // pinned threads: pages are placed by first touch in Partitioning order
+    if (TaskManager::IsPinned()) return;
     int num_nodes = numa_num_configured_nodes();
     size_t pagesize = numa_pagesize();
     
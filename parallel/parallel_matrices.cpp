@@ -470,10 +470,62 @@ namespace ngla
     ; // delete &mat;
   }
 
+  void ParallelMatrix :: SetOverlap (bool aoverlap)
+  {
+    overlap = aoverlap;
+    interior_rows.SetSize0();
+    interface_rows.SetSize0();
+    if (!overlap) return;
+
+    auto spmat = dynamic_pointer_cast<BaseSparseMatrix> (mat);
+    if (!spmat || !col_paralleldofs)
+      throw Exception ("ParallelMatrix::SetOverlap needs a local sparse matrix");
+
+    for (int i = 0; i < mat->Height(); i++)
+      {
+        bool interior = true;
+        // j is a column: interior if no entry of x is exchanged
+        for (int j : spmat->GetRowIndices(i))
+          if (col_paralleldofs->GetDistantProcs(j).Size())
+            {
+              interior = false;
+              break;
+            }
+        if (interior)
+          interior_rows.Append (i);
+        else
+          interface_rows.Append (i);
+      }
+  }
+
   void ParallelMatrix :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
   {
     const auto & xpar = dynamic_cast_ParallelBaseVector(x);
     auto & ypar = dynamic_cast_ParallelBaseVector(y);
+
+    if (overlap && (op & char(2)) && xpar.Status() == DISTRIBUTED)
+      {
+        static Timer t("ParallelMatrix::MultAdd - overlapped"); RegionTimer reg(t);
+        if (op & char(1))
+          y.Cumulate();
+        else
+          y.Distribute();
+
+        auto & xloc = *xpar.GetLocalVector();
+        auto & yloc = *ypar.GetLocalVector();
+
+        Array<MPI_Request> requests;
+        xpar.StartCumulate (requests);
+        bool rowwise = mat->MultAddRows (s, xloc, yloc, interior_rows);
+        xpar.FinishCumulate (requests);
+
+        if (rowwise)
+          mat->MultAddRows (s, xloc, yloc, interface_rows);
+        else
+          mat->MultAdd (s, xloc, yloc);
+        return;
+      }
+
     if (op & char(2))
       x.Cumulate();
     else
@@ -23,6 +23,11 @@ namespace ngla
     shared_ptr<ParallelDofs> row_paralleldofs, col_paralleldofs;
 
     PARALLEL_OP op;
+
+    /// overlap the exchange of x with the product of the interior rows
+    bool overlap = false;
+    /// rows not coupling to exchange dofs of x, and the remaining ones
+    Array<int> interior_rows, interface_rows;
     
   public:
     ParallelMatrix (shared_ptr<BaseMatrix> amat, shared_ptr<ParallelDofs> apardofs,
@@ -35,6 +40,7 @@ namespace ngla
 
     virtual ~ParallelMatrix () override;
     virtual bool IsComplex() const override { return mat->IsComplex(); } 
+    using BaseMatrix::MultAdd;
     virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override ;
     virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
 
@@ -58,6 +64,16 @@ namespace ngla
 
     PARALLEL_OP GetOpType () const { return op; }
 
+    /**
+       Overlapped MultAdd for cumulating operations on distributed x:
+       the sends and receives of x are posted, rows of the local matrix
+       not coupling to exchange dofs are multiplied while the messages
+       are in flight, the interface rows after the exchange.
+       Needs a local sparse matrix with full rows.
+    */
+    void SetOverlap (bool aoverlap);
+    bool GetOverlap () const { return overlap; }
+
     virtual shared_ptr<BaseMatrix> InverseMatrix (shared_ptr<BitArray> subset = 0) const override;
     template <typename TM>
     shared_ptr<BaseMatrix> InverseMatrixTM (shared_ptr<BitArray> subset = 0) const;
@@ -88,6 +104,7 @@ namespace ngla
 		   shared_ptr<ParallelDofs> apardofs);
     virtual ~MasterInverse () override;
     virtual bool IsComplex() const override { return inv->IsComplex(); } 
+    using BaseMatrix::MultAdd;
     virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
 
     virtual int VHeight() const override { return paralleldofs->GetNDofLocal(); }
@@ -104,6 +121,7 @@ namespace ngla
     FETI_Jump_Matrix (shared_ptr<ParallelDofs> pardofs, shared_ptr<ParallelDofs> au_paralleldofs = nullptr);
     
     virtual bool IsComplex() const override { return false; }
+    using BaseMatrix::MultAdd;
     virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
     virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
     
@@ -23,6 +23,8 @@ namespace ngla
     mutable PARALLEL_STATUS status;
     shared_ptr<ParallelDofs> paralleldofs;    
     shared_ptr<BaseVector> local_vec;
+    /// running exchange uses the plan of the ParallelDofs
+    mutable bool plan_exchange = false;
     
   public:
     ParallelBaseVector ()
@@ -72,6 +74,12 @@ namespace ngla
     { return local_vec; }
     
     virtual void Cumulate () const; 
+
+    /// first half of Cumulate: posts sends and receives of the exchange dofs.
+    /// The vector must not be modified before FinishCumulate
+    void StartCumulate (Array<MPI_Request> & requests) const;
+    /// waits for the messages and adds them up
+    void FinishCumulate (Array<MPI_Request> & requests) const;
     
     virtual void Distribute() const = 0;
     // { cerr << "ERROR -- Distribute called for BaseVector, is not parallel" << endl; }
@@ -155,6 +163,13 @@ namespace ngla
     virtual SCAL InnerProduct (const BaseVector & v2, bool conjugate = false) const;
     virtual BaseVector & SetScalar (double scal)
     { return ParallelBaseVector::SetScalar(scal); }
+  public:
+    /// local products of all basis vectors, summed up in one reduction
+    virtual void MultiInnerProductD (FlatArray<const BaseVector*> basis, FlatVector<double> res) const;
+    virtual void MultiInnerProductC (FlatArray<const BaseVector*> basis, FlatVector<Complex> res,
+                                     bool conjugate = false) const;
+    virtual void MultiAdd (FlatVector<double> c, FlatArray<const BaseVector*> basis);
+    virtual void MultiAdd (FlatVector<Complex> c, FlatArray<const BaseVector*> basis);
   };
 
 
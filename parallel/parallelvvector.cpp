@@ -110,24 +110,61 @@ namespace ngla
   {
 #ifdef PARALLEL
     if (status != DISTRIBUTED) return;
-    
-    int ntasks = paralleldofs->GetNTasks();
-    Array<int> exprocs;
-    for (int i = 0; i < ntasks; i++)
-      if (paralleldofs -> GetExchangeDofs (i).Size())
-	exprocs.Append(i);
-    
+
+    Array<MPI_Request> requests;
+    StartCumulate (requests);
+    FinishCumulate (requests);
+#endif
+  }
+
+
+  // requests holds the send requests followed by the receive requests
+  void ParallelBaseVector :: StartCumulate (Array<MPI_Request> & requests) const
+  {
+#ifdef PARALLEL
+    FlatVector<double> fv(Size()*EntrySize(), (double*)Memory());
+    ExchangePlan & plan = paralleldofs->GetExchangePlan (EntrySize());
+    plan_exchange = !plan.Busy() && plan.DoublesPerDof() == EntrySize();
+    if (plan_exchange)
+      {
+        requests.SetSize0();
+        plan.Start (fv);
+        return;
+      }
+
+    // another exchange is in flight, use the vector's own buffers
+    FlatArray<int> exprocs = paralleldofs->GetDistantProcs();
     int nexprocs = exprocs.Size();
     
     ParallelBaseVector * constvec = const_cast<ParallelBaseVector * > (this);
     
-    Array<MPI_Request> sendrequest(nexprocs), recvrequest(nexprocs);
-
+    requests.SetSize (2*nexprocs);
     for (int idest = 0; idest < nexprocs; idest ++ ) 
-      constvec->ISend (exprocs[idest], sendrequest[idest] );
+      constvec->ISend (exprocs[idest], requests[idest] );
     for (int isender=0; isender < nexprocs; isender++)
-      constvec -> IRecvVec (exprocs[isender], recvrequest[isender] );
-    
+      constvec -> IRecvVec (exprocs[isender], requests[nexprocs+isender] );
+#endif
+  }
+
+  void ParallelBaseVector :: FinishCumulate (Array<MPI_Request> & requests) const
+  {
+#ifdef PARALLEL
+    if (plan_exchange)
+      {
+        FlatVector<double> fv(Size()*EntrySize(), (double*)Memory());
+        paralleldofs->GetExchangePlan (EntrySize()).FinishAdd (fv);
+        plan_exchange = false;
+        SetStatus(CUMULATED);
+        return;
+      }
+
+    FlatArray<int> exprocs = paralleldofs->GetDistantProcs();
+    int nexprocs = exprocs.Size();
+
+    ParallelBaseVector * constvec = const_cast<ParallelBaseVector * > (this);
+    FlatArray<MPI_Request> sendrequest = requests.Range(0, nexprocs);
+    FlatArray<MPI_Request> recvrequest = requests.Range(nexprocs, 2*nexprocs);
+
     MyMPI_WaitAll (sendrequest);
     
     // cumulate
@@ -212,6 +249,90 @@ namespace ngla
     return paralleldofs->GetCommunicator().AllReduce (localsum, MPI_SUM);
   }
 
+
+
+  /*
+    Make every pair (basis[i], y) one cumulated and one distributed vector.
+    A distributed y is cumulated once instead of cumulating every basis vector.
+  */
+  static void PrepareMultiInnerProduct (FlatArray<const BaseVector*> basis, const ParallelBaseVector & y)
+  {
+    bool anydist = false, anycum = false;
+    for (auto b : basis)
+      {
+        if (b->GetParallelStatus() == DISTRIBUTED) anydist = true;
+        if (b->GetParallelStatus() == CUMULATED) anycum = true;
+      }
+
+    if (y.Status() == DISTRIBUTED && anydist)
+      y.Cumulate();
+
+    if (y.Status() == CUMULATED && anycum)
+      {
+        if (!anydist)
+          y.Distribute();
+        else
+          for (auto b : basis)
+            if (b->GetParallelStatus() == CUMULATED)
+              b->Distribute();
+      }
+  }
+
+  template <typename T>
+  static void SumUpMultiInnerProduct (const ParallelBaseVector & y, FlatVector<T> res)
+  {
+#ifdef PARALLEL
+    if (y.Status() != NOT_PARALLEL && res.Size())
+      MPI_Allreduce (MPI_IN_PLACE, &res(0), res.Size(), MyGetMPIType<T>(), MPI_SUM,
+                     y.GetParallelDofs()->GetCommunicator());
+#endif
+  }
+
+  // same status rules as ParallelBaseVector::Add
+  static void PrepareMultiAdd (const ParallelBaseVector & y, FlatArray<const BaseVector*> basis)
+  {
+    for (auto b : basis)
+      if (y.Status() != b->GetParallelStatus())
+        {
+          if (y.Status() == DISTRIBUTED)
+            y.Cumulate();
+          else
+            b->Cumulate();
+        }
+  }
+
+  template <class SCAL>
+  void S_ParallelBaseVector<SCAL> :: MultiInnerProductD (FlatArray<const BaseVector*> basis,
+                                                         FlatVector<double> res) const
+  {
+    PrepareMultiInnerProduct (basis, *this);
+    LocalMultiInnerProduct<double> (basis, *this, res, false);
+    SumUpMultiInnerProduct (*this, res);
+  }
+
+  template <class SCAL>
+  void S_ParallelBaseVector<SCAL> :: MultiInnerProductC (FlatArray<const BaseVector*> basis,
+                                                         FlatVector<Complex> res, bool conjugate) const
+  {
+    PrepareMultiInnerProduct (basis, *this);
+    LocalMultiInnerProduct<Complex> (basis, *this, res, conjugate);
+    SumUpMultiInnerProduct (*this, res);
+  }
+
+  template <class SCAL>
+  void S_ParallelBaseVector<SCAL> :: MultiAdd (FlatVector<double> c, FlatArray<const BaseVector*> basis)
+  {
+    PrepareMultiAdd (*this, basis);
+    S_BaseVector<SCAL>::MultiAdd (c, basis);
+  }
+
+  template <class SCAL>
+  void S_ParallelBaseVector<SCAL> :: MultiAdd (FlatVector<Complex> c, FlatArray<const BaseVector*> basis)
+  {
+    PrepareMultiAdd (*this, basis);
+    S_BaseVector<SCAL>::MultiAdd (c, basis);
+  }
+
   template class S_ParallelBaseVector<double>;
   template class S_ParallelBaseVector<Complex>;
 
@@ -280,9 +401,12 @@ namespace ngla
     if (status != CUMULATED) return;
     this->SetStatus(DISTRIBUTED);
 
+    // zero the whole entry, also for entry sizes other than the dofs'
+    FlatVector<SCAL> fv = this->FVScal();
+    int es = this->EntrySize() * sizeof(double) / sizeof(SCAL);
     for ( int dof = 0; dof < paralleldofs->GetNDofLocal(); dof ++ )
       if ( ! paralleldofs->IsMasterDof ( dof ) )
-	(*this)(dof) = 0;
+        fv.Range(dof*es, (dof+1)*es) = 0;
   }
 
 
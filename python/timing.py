@@ -23,6 +23,7 @@ name (str): Name for the timed class (for output formatting and
 obj (NGSolve object): Some NGSolve class which has the __timing__ 
     functionality implemented. Currently supported classes:
         FESpace
+        SparseMatrix (symmetric)
 filename (str): Filename to load a previously saved Timing
 parallel (bool=True): Time in parallel (using TaskManager)
 serial (bool=True): Time not in parallel (not using TaskManager)
@@ -0,0 +1,73 @@
+#include "catch.hpp"
+#include <ngstd.hpp>
+using namespace ngstd;
+
+// n x n grid, task (i,j) precedes (i+1,j) and (i,j+1)
+Table<int> GridGraph (int n)
+{
+  TableCreator<int> creator(n*n);
+  for ( ; !creator.Done(); creator++)
+    for (int i = 0; i < n; i++)
+      for (int j = 0; j < n; j++)
+        {
+          if (i+1 < n) creator.Add (i*n+j, (i+1)*n+j);
+          if (j+1 < n) creator.Add (i*n+j, i*n+j+1);
+        }
+  return creator.MoveTable();
+}
+
+// every task starts after its predecessors have finished
+void CheckOrder (const TaskDAG & dag)
+{
+  size_t n = dag.Size();
+  atomic<int> clock(0);
+  Array<int> start(n), finish(n);
+  start = -1;
+  dag.Run ([&] (int i)
+           {
+             start[i] = clock++;
+             finish[i] = clock++;
+           });
+  for (size_t i = 0; i < n; i++)
+    {
+      CHECK (start[i] != -1);
+      for (int j : dag.Successors(i))
+        CHECK (finish[i] < start[j]);
+    }
+}
+
+TEST_CASE ("TaskDAG order", "[taskmanager]")
+{
+  auto graph = GridGraph(20);
+  TaskDAG dag(graph);
+  REQUIRE (dag.Size() == 400);
+  CHECK (dag.Priority(0) == 39);
+
+  SECTION ("sequential")
+    {
+      CheckOrder (dag);
+    }
+  SECTION ("parallel, run twice")
+    {
+      TaskManager::SetNumThreads(4);
+      int num_threads = EnterTaskManager();
+      CheckOrder (dag);
+      CheckOrder (dag);
+      ExitTaskManager(num_threads);
+    }
+}
+
+TEST_CASE ("TaskDAG cycle", "[taskmanager]")
+{
+  // 0 -> 1 -> 2 -> 0, and 3 -> 0
+  TableCreator<int> creator(4);
+  for ( ; !creator.Done(); creator++)
+    {
+      creator.Add (0, 1);
+      creator.Add (1, 2);
+      creator.Add (2, 0);
+      creator.Add (3, 0);
+    }
+  Table<int> graph = creator.MoveTable();
+  CHECK_THROWS_AS (TaskDAG{graph}, Exception);
+}
@@ -0,0 +1,30 @@
+from ngsolve import *
+
+def test_overlapped_multadd():
+    comm = MPI_Init()
+    mesh = Mesh('square.vol.gz', comm)
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v) + 0.3*grad(u)[0]*v + u*v)
+    a.Assemble()
+
+    gfu = GridFunction(fes)
+    gfu.Set(x*x+y)
+    y1 = a.mat.CreateColVector()
+    y2 = a.mat.CreateColVector()
+
+    y1.data = a.mat * gfu.vec
+    a.mat.overlap = True
+    assert a.mat.overlap
+    # a distributed input vector needs the exchange
+    xd = gfu.vec.CreateVector()
+    xd.data = gfu.vec
+    xd.Distribute()
+    y2.data = a.mat * xd
+    a.mat.overlap = False
+
+    y1.Cumulate()
+    y2.Cumulate()
+    y2.data -= y1
+    assert Norm(y2) < 1e-10 * Norm(y1)
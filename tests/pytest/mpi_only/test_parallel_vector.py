@@ -0,0 +1,28 @@
+from ngsolve import *
+from ngsolve.la import CreateParallelVector
+import numpy as np
+
+def test_cumulate_entrysizes():
+    comm = MPI_Init()
+    mesh = Mesh('square.vol.gz', comm)
+    fes = H1(mesh, order=2)
+    pardofs = fes.ParallelDofs()
+
+    # a distributed one at every dof cumulates to the number of sharing procs
+    nshare = np.array([1+len(pardofs.Dof2Proc(d)) for d in range(pardofs.ndoflocal)], dtype=float)
+
+    vecs = []
+    for es in [1, 3]:
+        v = CreateParallelVector(pardofs, entrysize=es)
+        v.FV().NumPy()[:] = 1
+        v.SetParallelStatus(PARALLEL_STATUS.DISTRIBUTED)
+        vecs.append((es, v))
+
+    # alternate the entry sizes, every exchange plan is used several times
+    for it in range(3):
+        for es, v in vecs:
+            v.Cumulate()
+            vals = np.array(v.FV().NumPy()).reshape((-1,es))
+            for k in range(es):
+                assert np.linalg.norm(vals[:,k] - nshare) < 1e-12
+            v.Distribute()
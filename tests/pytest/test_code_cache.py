@@ -0,0 +1,25 @@
+from netgen.geom2d import unit_square
+from ngsolve import *
+import ngsolve.fem
+import tempfile
+
+def test_code_cache():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    olddir = ngsolve.fem.GetCodeCacheDirectory()
+    with tempfile.TemporaryDirectory() as tmpdir:
+        ngsolve.fem.SetCodeCacheDirectory(tmpdir)
+        # identical code, different runtime pointers
+        p1 = Parameter(2)
+        p2 = Parameter(3)
+        cf1 = (p1*x*y).Compile(realcompile=True, wait=True)
+        stats = ngsolve.fem.CodeCacheStatistics()
+        cf2 = (p2*x*y).Compile(realcompile=True, wait=True)
+        stats2 = ngsolve.fem.CodeCacheStatistics()
+        assert stats2["hits"] == stats["hits"]+1
+        assert stats2["misses"] == stats["misses"]
+
+        assert abs(Integrate(cf1, mesh) - 0.5) < 1e-12
+        assert abs(Integrate(cf2, mesh) - 0.75) < 1e-12
+        p1.Set(4)
+        assert abs(Integrate(cf1, mesh) - 1) < 1e-12
+        ngsolve.fem.SetCodeCacheDirectory(olddir)
@@ -65,6 +65,33 @@ def test_code_generation_derivatives(unit_mesh_3d):
         vals -= vals_ref
         assert Norm(vals) == approx(0)
 
+def test_code_generation_simplification(unit_mesh_3d):
+    fes = H1(unit_mesh_3d, order=2)
+    u,v = fes.TnT()
+    gfu = GridFunction(fes)
+    gfu.Set(x*x+y*z)
+
+    # repeated subtrees, constant subexpressions and trivial operations
+    c = CoefficientFunction(2)*CoefficientFunction(3)+sin(CoefficientFunction(0.5))
+    functions = [ sin(x*y)*sin(x*y) + 1*(x+0) + c*x,
+                  (x*y)/CoefficientFunction(1) + 0*exp(z) - CoefficientFunction(0),
+                  CoefficientFunction((x,y)).Norm() * CoefficientFunction((x,y)).Norm() ]
+    for cf in functions:
+        for f in [cf.Compile(), cf.Compile(True, wait=True)]:
+            assert Integrate( (cf-f)*(cf-f), unit_mesh_3d) == approx(0)
+
+    cf = (1*u)*(u*1) + 0*u + c*grad(u)*grad(u)
+    aref = BilinearForm(fes)
+    aref += SymbolicEnergy(cf)
+    aref.AssembleLinearization(gfu.vec)
+    for f in [cf.Compile(), cf.Compile(True, wait=True)]:
+        a = BilinearForm(fes)
+        a += SymbolicEnergy(f)
+        a.AssembleLinearization(gfu.vec)
+        vals = a.mat.AsVector().CreateVector()
+        vals.data = a.mat.AsVector() - aref.mat.AsVector()
+        assert Norm(vals) == approx(0)
+
 if __name__ == "__main__":
     test_code_generation_derivatives()
     test_code_generation_volume_terms()
@@ -99,9 +99,39 @@ def test_SurfaceGetFE(quads=False):
                         assert space.GetFE(el).ndof == len(space.GetDofNrs(el)), [spacename,vb,order]
     return
 
+def test_H1SumFactorization():
+    from math import sin
+    from ngsolve.meshes import MakeStructured2DMesh, MakeStructured3DMesh
+    for mesh in [MakeStructured2DMesh(quads=True, nx=3, ny=3), MakeStructured3DMesh(hexes=True, nx=2)]:
+        for order in [1,2,4]:
+            results = []
+            for tp in [False, True]:
+                fes = H1(mesh, order=order, tp=tp)
+                u,v = fes.TnT()
+                gfu = GridFunction(fes)
+                for i in range(len(gfu.vec)):
+                    gfu.vec[i] = sin(i)
+                integral = Integrate(gfu*gfu+grad(gfu)*grad(gfu), mesh)
+                vecs = []
+                for geom_free in [False, True]:
+                    a = BilinearForm(fes, nonassemble=True)
+                    a += SymbolicBFI(grad(u)*grad(v)+u*v, geom_free=geom_free)
+                    y = gfu.vec.CreateVector()
+                    y.data = a.mat * gfu.vec
+                    vecs.append(y)
+                results.append((integral, vecs))
+            ref = results[0][1][0]
+            diff = ref.CreateVector()
+            for integral, vecs in results:
+                assert abs(integral-results[0][0]) < 1e-10 * abs(results[0][0])
+                for y in vecs:
+                    diff.data = y - ref
+                    assert Norm(diff) < 1e-10 * Norm(ref)
+
 if __name__ == "__main__":
     test_2DGetFE(quads=False)
     test_2DGetFE(quads=True)
     test_3DGetFE()
     test_SurfaceGetFE(quads=False)
     test_SurfaceGetFE(quads=True)
+    test_H1SumFactorization()
@@ -99,7 +99,308 @@ def test_sparsematrix_access():
     a.Assemble()
     assert abs(a.mat[1,1][0,0] - (reference_values[3])) < 1e-8
 
+def test_atomic_assembly():
+    mesh = Mesh("cube.vol.gz")
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    mats = []
+    for atomic in [False, True]:
+        for sym in [False, True]:
+            a = BilinearForm(fes, symmetric=sym, atomic_assembly=atomic)
+            a += SymbolicBFI(grad(u)*grad(v)+u*v)
+            with TaskManager():
+                a.Assemble()
+            mats.append(a.mat)
+    x = mats[0].CreateColVector()
+    x.SetRandom()
+    y = x.CreateVector()
+    z = x.CreateVector()
+    y.data = mats[0] * x
+    for mat in mats[1:]:
+        z.data = mat * x
+        z -= y
+        assert Norm(z) < 1e-10 * Norm(y)
+
+def test_atomic_assembly_diagonal():
+    mesh = Mesh("cube.vol.gz")
+    fes = H1(mesh, order=2)
+    u,v = fes.TnT()
+    mats = []
+    for atomic in [False, True]:
+        a = BilinearForm(fes, diagonal=True, atomic_assembly=atomic)
+        a += SymbolicBFI(u*v)
+        # boundary elements are assembled by the uncolored loop
+        a += SymbolicBFI(u*v, BND)
+        with TaskManager():
+            a.Assemble()
+        mats.append(a.mat)
+    x = mats[0].CreateColVector()
+    x.SetRandom()
+    y = x.CreateVector()
+    z = x.CreateVector()
+    y.data = mats[0] * x
+    z.data = mats[1] * x
+    z -= y
+    assert Norm(z) < 1e-12 * Norm(y)
+
+def test_batch_assembly():
+    mesh = Mesh("cube.vol.gz")
+    for order in [1,2]:
+        for fes in [H1(mesh, order=order), HCurl(mesh, order=order)]:
+            u,v = fes.TnT()
+            if isinstance(fes, H1):
+                form = (1+x*y)*grad(u)*grad(v)+u*v
+            else:
+                form = curl(u)*curl(v)+IfPos(z-0.5, 2, 1)*u*v
+            mats = []
+            for batch in [False, True]:
+                a = BilinearForm(fes, symmetric=True, batch_assembly=batch)
+                a += SymbolicBFI(form)
+                with TaskManager():
+                    a.Assemble()
+                mats.append(a.mat)
+            vx = mats[0].CreateColVector()
+            vx.SetRandom()
+            vy = vx.CreateVector()
+            vz = vx.CreateVector()
+            vy.data = mats[0] * vx
+            vz.data = mats[1] * vx
+            vz -= vy
+            assert Norm(vz) < 1e-10 * Norm(vy)
+
+def test_batch_condensation():
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.4))
+    fes = H1(mesh, order=4)
+    u,v = fes.TnT()
+    for sym in [False, True]:
+        form = grad(u)*grad(v) + u*v
+        if not sym:
+            form += CoefficientFunction((1,2,3))*grad(u)*v
+        forms = []
+        for batch in [False, True]:
+            a = BilinearForm(fes, symmetric=sym, condense=True, batch_assembly=batch)
+            a += SymbolicBFI(form)
+            with TaskManager():
+                a.Assemble()
+            forms.append(a)
+
+        # the batched factorization gives the same Schur complement and inner operators
+        vx = forms[0].mat.CreateColVector()
+        vx.SetRandom()
+        vy = vx.CreateVector()
+        vz = vx.CreateVector()
+        for op in [lambda a: a.mat, lambda a: a.harmonic_extension,
+                   lambda a: a.harmonic_extension_trans, lambda a: a.inner_solve]:
+            vy.data = op(forms[0]) * vx
+            vz.data = op(forms[1]) * vx
+            vz -= vy
+            assert Norm(vz) < 1e-10 * Norm(vy)
+
+def test_sell_matrix():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=2, dirichlet="left")
+    u,v = fes.TnT()
+    for sym in [False, True]:
+        a = BilinearForm(fes, symmetric=sym)
+        a += SymbolicBFI(grad(u)*grad(v) + CoefficientFunction((1,0))*grad(u)*v)
+        with TaskManager():
+            a.Assemble()
+            sell = la.SparseMatrixSELL(a.mat, sigma=32)
+            assert sell.padding >= 1
+
+            vx = a.mat.CreateColVector()
+            vx.SetRandom()
+            vy = vx.CreateVector()
+            vz = vx.CreateVector()
+            vy.data = a.mat * vx
+            vz.data = sell * vx
+            vz -= vy
+            assert Norm(vz) < 1e-12 * Norm(vy)
+
+            vy.data = a.mat.T * vx
+            vz.data = sell.T * vx
+            vz -= vy
+            assert Norm(vz) < 1e-12 * Norm(vy)
+
+    # drop-in for Krylov solvers with a Jacobi preconditioner
+    a = BilinearForm(fes, symmetric=True)
+    a += SymbolicBFI(grad(u)*grad(v)+u*v)
+    f = LinearForm(fes)
+    f += SymbolicLFI(v)
+    a.Assemble()
+    f.Assemble()
+    sell = la.SparseMatrixSELL(a.mat)
+    jac = sell.CreateSmoother(fes.FreeDofs())
+    u1 = f.vec.CreateVector()
+    u2 = f.vec.CreateVector()
+    u1.data = CGSolver(a.mat, jac, printrates=False, precision=1e-12) * f.vec
+    u2.data = CGSolver(sell, jac, printrates=False, precision=1e-12) * f.vec
+    u2 -= u1
+    assert Norm(u2) < 1e-8 * Norm(u1)
+
+def test_shared_graph():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=2)
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v))
+    m = BilinearForm(fes)
+    m += SymbolicBFI(u*v)
+    a.Assemble()
+    m.Assemble()
+
+    # one graph for both forms
+    assert m.mat.SharesGraph(a.mat)
+    assert m.mat.SameGraph(a.mat)
+
+    dt = 0.1
+    mstar = m.mat.CreateLinearCombination(a.mat, 1, dt)
+    vx = a.mat.CreateColVector()
+    vx.SetRandom()
+    vy = vx.CreateVector()
+    vy.data = (m.mat + dt * a.mat) * vx
+    vy.data -= mstar * vx
+    assert Norm(vy) < 1e-12 * Norm(vx)
+
+    # matrices with a different graph are rejected
+    fes1 = H1(mesh, order=1)
+    u1,v1 = fes1.TnT()
+    b = BilinearForm(fes1)
+    b += SymbolicBFI(u1*v1)
+    b.Assemble()
+    assert not m.mat.SharesGraph(b.mat)
+    assert not m.mat.SameGraph(b.mat)
+    with pytest.raises(Exception):
+        m.mat.CreateLinearCombination(b.mat)
+
+def test_compressed_indices():
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.3))
+    fes = H1(mesh, order=2)
+    u,v = fes.TnT()
+    for sym in [False, True]:
+        a = BilinearForm(fes, symmetric=sym)
+        a += SymbolicBFI(grad(u)*grad(v) + u*v)
+        a.Assemble()
+        vx = a.mat.CreateColVector()
+        vx.SetRandom()
+        vy = vx.CreateVector()
+        vz = vx.CreateVector()
+        vy.data = a.mat * vx
+
+        a.mat.CompressIndices()
+        assert a.mat.indices_compressed
+        vz.data = a.mat * vx
+        vz -= vy
+        assert Norm(vz) < 1e-12 * Norm(vy)
+        with TaskManager():
+            vz.data = a.mat * vx
+        vz -= vy
+        assert Norm(vz) < 1e-12 * Norm(vy)
+
+        # assembling decodes the compressed rows
+        a.Assemble(reallocate=False)
+        assert a.mat.indices_compressed
+        vz.data = a.mat * vx
+        vz -= vy
+        assert Norm(vz) < 1e-12 * Norm(vy)
+
+        mem = { name : nbytes for name, nbytes, nblocks in a.mat.__memory__ }
+        nrows = a.mat.height+1
+        assert mem["MatrixGraph index traffic per SpMV"] < 4*a.mat.nze + 8*nrows
+        a.mat.CompressIndices(False)
+        assert not a.mat.indices_compressed
+
+def test_sparse_product():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=2)
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v) + CoefficientFunction((1,0))*grad(u)*v)
+    m = BilinearForm(fes)
+    m += SymbolicBFI(u*v)
+    a.Assemble()
+    m.Assemble()
+
+    vx = a.mat.CreateColVector()
+    vx.SetRandom()
+    vy = vx.CreateVector()
+    vz = vx.CreateVector()
+    with TaskManager():
+        prod = a.mat @ m.mat
+        vy.data = a.mat * (m.mat * vx)
+        vz.data = prod * vx
+        vz -= vy
+        assert Norm(vz) < 1e-12 * Norm(vy)
+
+        at = a.mat.CreateTranspose()
+        vy.data = a.mat.T * vx
+        vz.data = at * vx
+        vz -= vy
+        assert Norm(vz) < 1e-12 * Norm(vy)
+
+        # chained MatMult, the fused triple product is tested in test_restrict
+        prod3 = at @ prod
+        vy.data = at * (a.mat * (m.mat * vx))
+        vz.data = prod3 * vx
+        vz -= vy
+        assert Norm(vz) < 1e-12 * Norm(vy)
+
+def test_restrict():
+    mesh = Mesh("square.vol.gz")
+
+    def prolongate(P, x, h):
+        y = np.zeros((h,)+x.shape[1:], dtype=x.dtype)
+        np.add.at(y, P[0], np.multiply.outer(P[2], np.ones(x.shape[1:])) * x[P[1]])
+        return y
+    def restrict(P, x, w):
+        y = np.zeros((w,)+x.shape[1:], dtype=x.dtype)
+        np.add.at(y, P[1], np.multiply.outer(P[2], np.ones(x.shape[1:])) * x[P[0]])
+        return y
+
+    # real, complex, and Mat<2,2> entries
+    for dim, cplx in [(1,False), (1,True), (2,False)]:
+        fes = H1(mesh, order=2, dim=dim, complex=cplx)
+        u,v = fes.TnT()
+        a = BilinearForm(fes)
+        a += SymbolicBFI(InnerProduct(grad(u),grad(v)) + InnerProduct(u,v))
+        a.Assemble()
+
+        # every fine dof interpolates two coarse dofs
+        n = fes.ndof
+        nc = n // 2
+        ri = [i for i in range(n) for k in range(2)]
+        ci = [(i//2+k) % nc for i in range(n) for k in range(2)]
+        vals = [0.5+0.25*k for i in range(n) for k in range(2)]
+        prol = la.SparseMatrixd.CreateFromCOO(ri, ci, vals, n, nc)
+        P = (np.array(ri), np.array(ci), np.array(vals))
+
+        with TaskManager():
+            cmat = a.mat.Restrict(prol)
+
+        vc = cmat.CreateColVector()
+        vf = a.mat.CreateColVector()
+        shape = (nc, dim) if dim > 1 else (nc,)
+        xc = np.random.rand(*shape) + (1j*np.random.rand(*shape) if cplx else 0)
+        vc.FV().NumPy()[:] = xc.flatten()
+        vf.FV().NumPy()[:] = prolongate(P, xc, n).flatten()
+        yf = vf.CreateVector()
+        yf.data = a.mat * vf
+        yf_np = np.array(yf.FV().NumPy()).reshape((n,)+shape[1:])
+        yref = restrict(P, yf_np, nc).flatten()
+        yc = vc.CreateVector()
+        yc.data = cmat * vc
+        assert np.linalg.norm(yc.FV().NumPy() - yref) < 1e-12 * np.linalg.norm(yref)
+
 if __name__ == "__main__":
     test_matrix()
     test_matrix_numpy()
     test_sparsematrix_access()
+    test_atomic_assembly()
+    test_atomic_assembly_diagonal()
+    test_batch_assembly()
+    test_batch_condensation()
+    test_sell_matrix()
+    test_shared_graph()
+    test_compressed_indices()
+    test_sparse_product()
+    test_restrict()
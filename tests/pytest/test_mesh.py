@@ -18,3 +18,35 @@ def test_call_operator_with_vectorization():
     mesh = Mesh(unit_cube.GenerateMesh(maxh=1))
     p = mesh(0.5,0.5,0.5)
     p2 = mesh([0.5, 0.1],0.5,0.5)
+
+def test_geometry_cache():
+    geo = CSGeometry()
+    geo.Add(Sphere(Pnt(0,0,0), 1))
+    mesh = Mesh(geo.GenerateMesh(maxh=0.5))
+    mesh.Curve(3)
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    def energy():
+        a = BilinearForm(fes)
+        a += SymbolicBFI(grad(u)*grad(v)+u*v)
+        a += SymbolicBFI(u*v, BND)
+        a.Assemble()
+        gfu = GridFunction(fes)
+        gfu.Set(x*y+z)
+        return InnerProduct(gfu.vec, a.mat*gfu.vec)
+
+    ref = energy()
+    mesh.EnableGeometryCache()
+    assert mesh.geometrycachememory == 0
+    first = energy()
+    mem = mesh.geometrycachememory
+    assert mem > 0
+    second = energy()
+    # rules rebuilt for every element are found again
+    assert mesh.geometrycachememory == mem
+    assert abs(first-ref) < 1e-10*abs(ref)
+    assert abs(second-ref) < 1e-10*abs(ref)
+
+    mesh.Curve(2)
+    assert mesh.geometrycachememory == 0
+    mesh.EnableGeometryCache(False)
@@ -44,5 +44,269 @@ def test_arnoldi():
 
 
 
+@pytest.mark.parametrize("symmetric", [True, False])
+def test_gs_ordering(symmetric):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=2, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(fes, symmetric=symmetric)
+    a += SymbolicBFI(grad(u)*grad(v)+u*v)
+    f = LinearForm(fes)
+    f += SymbolicLFI(v)
+    with TaskManager():
+        a.Assemble()
+        f.Assemble()
+
+        results = {}
+        for ordering in ["natural", "levels", "coloring"]:
+            smoother = a.mat.CreateSmoother(fes.FreeDofs(), ordering=ordering)
+            x = f.vec.CreateVector()
+            x[:] = 0
+            for i in range(3):
+                smoother.Smooth(x, f.vec)
+                smoother.SmoothBack(x, f.vec)
+            results[ordering] = x
+
+    # level scheduling reproduces the sequential sweep
+    diff = results["levels"].CreateVector()
+    diff.data = results["levels"] - results["natural"]
+    assert Norm(diff) < 1e-12 * Norm(results["natural"])
+
+    # coloring is a different ordering, but still reduces the residual
+    res = f.vec.CreateVector()
+    res.data = f.vec - a.mat * results["coloring"]
+    for i in range(len(res)):
+        if not fes.FreeDofs()[i]:
+            res[i] = 0
+    assert Norm(res) < Norm(f.vec)
+
+
+def test_sparsecholesky_nd():
+    from netgen.csg import unit_cube
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3, dirichlet=".*")
+    u,v = fes.TnT()
+    a = BilinearForm(fes, symmetric=True)
+    a += SymbolicBFI(grad(u)*grad(v))
+    f = LinearForm(fes)
+    f += SymbolicLFI(v)
+    with TaskManager():
+        a.Assemble()
+        f.Assemble()
+
+        sols = {}
+        for inverse in ["sparsecholesky", "sparsecholesky_nd"]:
+            inv = a.mat.Inverse(fes.FreeDofs(), inverse=inverse)
+            assert inv.ordering == ("nested dissection" if inverse == "sparsecholesky_nd"
+                                    else "minimum degree")
+            assert inv.nze > 0
+            assert inv.flops > 0
+            assert inv.factortime >= 0
+            sols[inverse] = f.vec.CreateVector()
+            sols[inverse].data = inv * f.vec
+
+    diff = sols["sparsecholesky"].CreateVector()
+    diff.data = sols["sparsecholesky"] - sols["sparsecholesky_nd"]
+    assert Norm(diff) < 1e-10 * Norm(sols["sparsecholesky"])
+
+
+def test_multivector_solve():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(fes, symmetric=True)
+    a += SymbolicBFI(grad(u)*grad(v)+u*v)
+    c = Preconditioner(a, "local")
+    with TaskManager():
+        a.Assemble()
+        nrhs = 5
+        rhs = la.MultiVector(a.mat.CreateColVector(), nrhs)
+        for k in range(nrhs):
+            f = LinearForm(fes)
+            f += SymbolicLFI(x**k*v)
+            f.Assemble()
+            rhs[k].data = f.vec
+
+        inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky")
+        sol = la.MultiVector(a.mat.CreateColVector(), nrhs)
+        inv.Mult(rhs, sol)
+
+        solver = la.BlockCGSolver(a.mat, c.mat, printrates=False, precision=1e-10, maxsteps=500)
+        cgsol = la.MultiVector(a.mat.CreateColVector(), nrhs)
+        solver.Mult(rhs, cgsol)
+
+        res = a.mat.CreateColVector()
+        for k in range(nrhs):
+            res.data = inv * rhs[k]
+            res.data -= sol[k]
+            assert Norm(res) < 1e-10 * Norm(sol[k])
+            res.data = cgsol[k] - sol[k]
+            assert Norm(res) < 1e-6 * Norm(sol[k])
+
+        ip = sol.InnerProduct(rhs)
+        for k in range(nrhs):
+            assert abs(ip[k,k] - InnerProduct(sol[k], rhs[k])) < 1e-10 * abs(ip[k,k])
+
+        # symmetric product of all vectors at once
+        prod = la.MultiVector(a.mat.CreateColVector(), nrhs)
+        a.mat.Mult(sol, prod)
+        for k in range(nrhs):
+            res.data = a.mat * sol[k]
+            res.data -= prod[k]
+            assert Norm(res) < 1e-12 * Norm(prod[k])
+
+        # dependent right hand sides: block CG must not break down silently
+        rhs[nrhs-1].data = rhs[0]
+        solver.Mult(rhs, cgsol)
+        res.data = cgsol[nrhs-1] - sol[0]
+        assert Norm(res) < 1e-6 * Norm(sol[0])
+
+
+def test_sparsecholesky_mixed():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.05))
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(fes, symmetric=True)
+    a += SymbolicBFI(grad(u)*grad(v)+u*v)
+    f = LinearForm(fes)
+    f += SymbolicLFI(x*v)
+    with TaskManager():
+        a.Assemble()
+        f.Assemble()
+
+        inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky")
+        invmixed = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky_mixed")
+        sol = f.vec.CreateVector()
+        sol.data = inv * f.vec
+        solmixed = f.vec.CreateVector()
+        solmixed.data = invmixed * f.vec
+        assert invmixed.steps > 0
+        assert invmixed.nze == inv.nze
+
+    diff = sol.CreateVector()
+    diff.data = sol - solmixed
+    assert Norm(diff) < 1e-12 * Norm(sol)
+
+
+def test_pipelined_cg():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(fes, symmetric=True)
+    a += SymbolicBFI(grad(u)*grad(v)+u*v)
+    c = Preconditioner(a, "local")
+    f = LinearForm(fes)
+    f += SymbolicLFI(x*v)
+    with TaskManager():
+        a.Assemble()
+        f.Assemble()
+        cg = CGSolver(a.mat, c.mat, printrates=False, precision=1e-10, maxsteps=500)
+        pcg = la.PipelinedCGSolver(a.mat, c.mat, printrates=False, precision=1e-10, maxsteps=500)
+        u1 = f.vec.CreateVector()
+        u2 = f.vec.CreateVector()
+        u1.data = cg * f.vec
+        u2.data = pcg * f.vec
+
+    assert abs(pcg.GetSteps() - cg.GetSteps()) <= 2
+    assert len(pcg.residuals) == pcg.GetSteps()+1
+    assert len(cg.residuals) == cg.GetSteps()+1
+    assert pcg.residuals[-1] <= 1e-10 * pcg.residuals[0]
+    u2.data -= u1
+    assert Norm(u2) < 1e-6 * Norm(u1)
+
+
+def test_gmres():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=2, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v) + CoefficientFunction((5,2))*grad(u)*v)
+    f = LinearForm(fes)
+    f += SymbolicLFI(x*v)
+    a.Assemble()
+    f.Assemble()
+
+    pre = Projector(fes.FreeDofs(), True)
+    gmres = GMRESSolver(a.mat, pre, printrates=False, precision=1e-10, maxsteps=fes.ndof)
+    u1 = f.vec.CreateVector()
+    u1.data = gmres * f.vec
+
+    assert gmres.residuals[-1] <= 1e-10 * gmres.residuals[0]
+    res = f.vec.CreateVector()
+    res.data = f.vec - a.mat * u1
+    for i in range(len(res)):
+        if not fes.FreeDofs()[i]:
+            res[i] = 0
+    assert Norm(res) < 1e-8 * Norm(f.vec)
+
+
+def test_block_jacobi_batched():
+    import numpy as np
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v) + u*v + CoefficientFunction((3,1))*grad(u)*v)
+    a.Assemble()
+
+    # many blocks of equal size are inverted together across SIMD lanes
+    bs = 3
+    blocks = [list(range(i, min(i+bs, fes.ndof))) for i in range(0, fes.ndof, bs)]
+    with TaskManager():
+        jac = a.mat.CreateBlockSmoother(blocks)
+
+    x = a.mat.CreateColVector()
+    x.SetRandom()
+    y = x.CreateVector()
+    y.data = jac * x
+
+    for block in blocks:
+        ab = np.array([[a.mat[i,j] for j in block] for i in block])
+        yb = np.linalg.solve(ab, np.array([x[i] for i in block]))
+        assert np.linalg.norm(yb - np.array([y[i] for i in block])) < 1e-10 * (1+np.linalg.norm(yb))
+
+
+@pytest.mark.parametrize("precond", ["multigrid", "h1amg"])
+def test_chebyshev_smoother(precond):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=1, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v))
+    f = LinearForm(fes)
+    f += SymbolicLFI(v)
+    c = Preconditioner(a, precond, smoother="chebyshev")
+
+    with TaskManager():
+        a.Assemble()
+        for l in range(3):
+            mesh.Refine()
+            fes.Update()
+            a.Assemble()
+        f.Assemble()
+
+        gfu = GridFunction(fes)
+        cg = CGSolver(a.mat, c.mat, printrates=False, precision=1e-8, maxsteps=200)
+        gfu.vec.data = cg * f.vec
+
+    assert cg.GetSteps() < 50
+    res = f.vec.CreateVector()
+    res.data = f.vec - a.mat * gfu.vec
+    for i in range(len(res)):
+        if not fes.FreeDofs()[i]:
+            res[i] = 0
+    assert Norm(res) < 1e-6 * Norm(f.vec)
+
+
 if __name__ == "__main__":
     test_arnoldi()
+    test_pipelined_cg()
+    for symmetric in [True, False]:
+        test_gs_ordering(symmetric)
+    test_sparsecholesky_nd()
+    test_multivector_solve()
+    test_sparsecholesky_mixed()
+    test_gmres()
+    test_block_jacobi_batched()
+    for precond in ["multigrid", "h1amg"]:
+        test_chebyshev_smoother(precond)
@@ -0,0 +1,90 @@
+from netgen.geom2d import unit_square
+from ngsolve import *
+import pytest
+
+
+def test_async_jobs():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    gfu = GridFunction(fes)
+    gfu.Set(x*y)
+    
+    with TaskManager():
+        a = BilinearForm(fes)
+        a += u*v*dx
+        m = BilinearForm(fes)
+        m += grad(u)*grad(v)*dx
+
+        order = []
+        fa = RunAsync(lambda: a.Assemble())
+        fm = RunAsync(lambda: m.Assemble())
+        fa2 = fa.Then(lambda: order.append("a"))
+        both = WhenAll([fa2, fm]).Then(lambda: order.append("both"))
+        both.Wait()
+        assert both.ready and fa.ready and fm.ready
+        assert order == ["a", "both"]
+
+    # same matrices as the synchronous assembly
+    a2 = BilinearForm(fes)
+    a2 += u*v*dx
+    a2.Assemble()
+    diff = a.mat.CreateColVector()
+    diff.data = (a.mat - a2.mat) * gfu.vec
+    assert Norm(diff) < 1e-12
+
+
+def test_async_exception():
+    def fail():
+        raise RuntimeError("async failure")
+    called = []
+    with TaskManager():
+        f = RunAsync(fail)
+        g = f.Then(lambda: called.append(1))
+        with pytest.raises(Exception):
+            g.Wait()
+    assert called == []
+
+
+@pytest.mark.parametrize("policy", ["compact", "scatter", "0"])
+def test_affinity(policy):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += grad(u)*grad(v)*dx
+    a.Assemble()
+    gfu = GridFunction(fes)
+    gfu.Set(x*y)
+    y1 = a.mat.CreateColVector()
+    y1.data = a.mat * gfu.vec
+
+    SetAffinity(policy)
+    try:
+        with TaskManager():
+            cores = GetThreadCores()
+            a2 = BilinearForm(fes)
+            a2 += grad(u)*grad(v)*dx
+            a2.Assemble()
+            y2 = a2.mat.CreateColVector()
+            y2.data = a2.mat * gfu.vec
+    finally:
+        SetAffinity("none")
+    if policy == "0":
+        assert all(c in (0, -1) for c in cores)
+    y2 -= y1
+    assert Norm(y2) < 1e-10 * Norm(y1)
+
+
+def test_affinity_invalid():
+    policy = GetAffinity()
+    with pytest.raises(Exception):
+        SetAffinity("7-3")
+    assert GetAffinity() == policy
+
+
+if __name__ == "__main__":
+    test_async_jobs()
+    test_async_exception()
+    test_affinity("compact")
+    test_affinity_invalid()
@@ -0,0 +1,27 @@
+from meshes import *
+from ngsolve import *
+import os, tempfile
+import xml.etree.ElementTree as ET
+
+def test_vtu_output(unit_mesh_2d):
+    with tempfile.TemporaryDirectory() as tmpdir:
+        name = os.path.join(tmpdir, "out")
+        t = Parameter(0)
+        vtk = VTKOutput(unit_mesh_2d, coefs=[t*x, CoefficientFunction((x,y))], names=["u","v"],
+                        filename=name, subdivision=1, format="vtu", background=True)
+        for step in range(3):
+            t.Set(step)
+            vtk.Do(time=0.5*step)
+        del vtk   # waits for the background writer
+
+        for i, f in enumerate(["out.vtu", "out_1.vtu", "out_2.vtu"]):
+            with open(os.path.join(tmpdir, f), "rb") as fin:
+                head = fin.read(2000).split(b"<AppendedData")[0].decode()
+            assert 'type="UnstructuredGrid"' in head
+            assert 'Name="u"' in head and 'NumberOfComponents="2"' in head
+            assert 'NumberOfCells="' + str(4*unit_mesh_2d.ne) + '"' in head
+
+        pvd = ET.parse(name + ".pvd").getroot()
+        sets = pvd.findall("Collection/DataSet")
+        assert [float(s.get("timestep")) for s in sets] == [0, 0.5, 1]
+        assert [s.get("file") for s in sets] == ["out.vtu", "out_1.vtu", "out_2.vtu"]
@@ -4,6 +4,7 @@ import socket
 import multiprocessing
 from ngsolve import *
 import json
+import time
 import os
 ngsglobals.msg_level=0
 
@@ -45,6 +46,8 @@ else:
     timings = results["timings"]
     timings["FESpace"] = []
     timings["Element"] = []
+    timings["SparseMatrix"] = []
+    timings["Assemble"] = []
 
 
 # test fespaces
@@ -80,6 +83,51 @@ for mesh in meshes:
                     tim['nthreads'] = ngsglobals.numthreads
                     timings["FESpace"].append(tim)
 
+# test symmetric sparse matrix-vector product
+for mesh in meshes:
+    for order in orders:
+        fes = H1(mesh, order=order)
+        u,v = fes.TnT()
+        a = BilinearForm(fes, symmetric=True)
+        a += SymbolicBFI(grad(u)*grad(v))
+        with TaskManager():
+            a.Assemble()
+        timing = Timing(name="SparseMatrixSymmetric",obj=a.mat,parallel=args.parallel,serial=args.sequential)
+        for par, tims in [(0, timing.timings), (1, timing.timings_par)]:
+            if tims is None:
+                continue
+            for t in tims:
+                tim = {}
+                tim['dimension'] = mesh.dim
+                tim['order'] = order
+                tim['name'] = t[0]
+                tim['time'] = t[1]
+                tim['taskmanager'] = par
+                tim['nthreads'] = ngsglobals.numthreads if par else 1
+                timings["SparseMatrix"].append(tim)
+
+# test assembling with element coloring vs. atomic adds vs. element batches
+if args.parallel:
+    for order in orders:
+        fes = H1(mesh3, order=order)
+        u,v = fes.TnT()
+        for name, flags in [("colored", {}), ("atomic", {"atomic_assembly" : True}),
+                            ("batch", {"batch_assembly" : True})]:
+            a = BilinearForm(fes, symmetric=True, **flags)
+            a += SymbolicBFI(grad(u)*grad(v))
+            with TaskManager():
+                a.Assemble()
+                start = time.time()
+                a.Assemble()
+                end = time.time()
+            tim = {}
+            tim['dimension'] = mesh3.dim
+            tim['order'] = order
+            tim['name'] = name
+            tim['time'] = end-start
+            tim['taskmanager'] = 1
+            tim['nthreads'] = ngsglobals.numthreads
+            timings["Assemble"].append(tim)
 
 orders = [1,2,4,8]
 mesh2 = Mesh(unit_square.GenerateMesh(maxh=3))